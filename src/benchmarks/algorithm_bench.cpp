@@ -0,0 +1,80 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <functional>
+#include <random>
+
+#include "../lib_containers.h"
+#include "../lib_containersplus.h"
+
+namespace {
+// Each algorithm runs sequentially (Arg 0 of the second pair) and on the
+// global pool (Arg 1) over range(0) elements, to find the size from which
+// the parallel version pays off.
+lib::vector<int64_t> randomValues(int64_t n) {
+  std::mt19937_64 gen(42);
+  lib::vector<int64_t> values;
+  values.reserve(n);
+  for (int64_t i = 0; i < n; ++i) values.push_back(gen() % 1000000);
+  return values;
+}
+
+void BM_Sort(benchmark::State& state) {
+  lib::vector<int64_t> source = randomValues(state.range(0));
+  for (auto _ : state) {
+    state.PauseTiming();
+    lib::vector<int64_t> values = source;
+    state.ResumeTiming();
+    if (state.range(1))
+      lib::parallel_sort(values);
+    else
+      lib::sort(values);
+    benchmark::DoNotOptimize(values.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_Transform(benchmark::State& state) {
+  lib::vector<int64_t> values = randomValues(state.range(0));
+  auto op = [](int64_t x) { return x * 3 + 1; };
+  for (auto _ : state) {
+    if (state.range(1))
+      lib::parallel_transform(values, op);
+    else
+      lib::transform(values, op);
+    benchmark::DoNotOptimize(values.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_Reduce(benchmark::State& state) {
+  lib::vector<int64_t> values = randomValues(state.range(0));
+  for (auto _ : state) {
+    int64_t sum = state.range(1) ? lib::parallel_reduce(values, int64_t(0))
+                                 : lib::reduce(values, int64_t(0));
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_InclusiveScan(benchmark::State& state) {
+  lib::vector<int64_t> values = randomValues(state.range(0));
+  for (auto _ : state) {
+    if (state.range(1))
+      lib::parallel_inclusive_scan(values);
+    else
+      lib::inclusive_scan(values);
+    benchmark::DoNotOptimize(values.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+}  // namespace
+
+BENCHMARK(BM_Sort)->ArgsProduct({{1 << 12, 1 << 16, 1 << 20, 1 << 24},
+                                 {0, 1}});
+BENCHMARK(BM_Transform)
+    ->ArgsProduct({{1 << 12, 1 << 16, 1 << 20, 1 << 24}, {0, 1}});
+BENCHMARK(BM_Reduce)->ArgsProduct({{1 << 12, 1 << 16, 1 << 20, 1 << 24},
+                                   {0, 1}});
+BENCHMARK(BM_InclusiveScan)
+    ->ArgsProduct({{1 << 12, 1 << 16, 1 << 20, 1 << 24}, {0, 1}});
@@ -0,0 +1,65 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+
+#include "../lib_containers.h"
+#include "../lib_containersplus.h"
+
+namespace {
+template <typename Container>
+void BM_PushBack(benchmark::State& state) {
+  for (auto _ : state) {
+    Container values;
+    for (int64_t i = 0; i < state.range(0); ++i) values.push_back(i);
+    benchmark::DoNotOptimize(values.back());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Times every append of range(0) int64_t values and reports the slowest
+// one: a vector stalls while it copies everything on a doubling, the deque
+// only ever adds a block or copies the block map.
+template <typename Container>
+void BM_WorstAppend(benchmark::State& state) {
+  using Clock = std::chrono::steady_clock;
+  Clock::duration worst{};
+  for (auto _ : state) {
+    Container values;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+      Clock::time_point start = Clock::now();
+      values.push_back(i);
+      worst = std::max(worst, Clock::now() - start);
+    }
+    benchmark::DoNotOptimize(values.back());
+  }
+  state.counters["worst_us"] =
+      std::chrono::duration<double, std::micro>(worst).count();
+}
+
+void BM_IterateDeque(benchmark::State& state) {
+  lib::deque<int64_t> values;
+  for (int64_t i = 0; i < state.range(0); ++i) values.push_back(i);
+  for (auto _ : state) {
+    int64_t sum = 0;
+    for (int64_t value : values) sum += value;
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+}  // namespace
+
+BENCHMARK_TEMPLATE(BM_PushBack, lib::vector<int64_t>)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_PushBack, lib::deque<int64_t>)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_WorstAppend, lib::vector<int64_t>)
+    ->Arg(1 << 20)
+    ->Arg(1 << 25)
+    ->Iterations(1)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_WorstAppend, lib::deque<int64_t>)
+    ->Arg(1 << 20)
+    ->Arg(1 << 25)
+    ->Iterations(1)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_IterateDeque)->Arg(1 << 20);
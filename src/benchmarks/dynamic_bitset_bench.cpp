@@ -0,0 +1,83 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <random>
+
+#include "../lib_containers.h"
+#include "../lib_containersplus.h"
+
+namespace {
+lib::dynamic_bitset makeBits(int64_t n, unsigned seed) {
+  std::mt19937_64 gen(seed);
+  lib::dynamic_bitset bits(n);
+  for (std::size_t i = 0; i < bits.word_count(); ++i) bits.data()[i] = gen();
+  bits.resize(n);
+  return bits;
+}
+
+lib::vector<bool> makeBools(int64_t n, unsigned seed) {
+  std::mt19937_64 gen(seed);
+  lib::vector<bool> bools;
+  for (int64_t i = 0; i < n; ++i) bools.push_back(gen() & 1);
+  return bools;
+}
+
+// range(0) flags: bytes_per_second counts the bytes each form stores.
+void BM_AndBitset(benchmark::State& state) {
+  lib::dynamic_bitset a = makeBits(state.range(0), 1);
+  lib::dynamic_bitset b = makeBits(state.range(0), 2);
+  for (auto _ : state) {
+    a &= b;
+    benchmark::DoNotOptimize(a.data());
+  }
+  state.SetBytesProcessed(state.iterations() * a.word_count() * 8);
+  state.counters["bytes"] = a.word_count() * 8;
+}
+
+void BM_AndVectorBool(benchmark::State& state) {
+  lib::vector<bool> a = makeBools(state.range(0), 1);
+  lib::vector<bool> b = makeBools(state.range(0), 2);
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < a.size(); ++i) a[i] = a[i] && b[i];
+    benchmark::DoNotOptimize(a.data());
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+  state.counters["bytes"] = state.range(0);
+}
+
+void BM_CountBitset(benchmark::State& state) {
+  lib::dynamic_bitset bits = makeBits(state.range(0), 1);
+  for (auto _ : state) benchmark::DoNotOptimize(bits.count());
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_CountVectorBool(benchmark::State& state) {
+  lib::vector<bool> bools = makeBools(state.range(0), 1);
+  for (auto _ : state) {
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < bools.size(); ++i) count += bools[i];
+    benchmark::DoNotOptimize(count);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_FindNextBitset(benchmark::State& state) {
+  lib::dynamic_bitset bits(state.range(0));
+  for (int64_t i = 0; i < state.range(0); i += 1000) bits.set(i);
+  for (auto _ : state) {
+    std::size_t found = 0;
+    for (std::size_t pos = bits.find_first(); pos != bits.npos;
+         pos = bits.find_next(pos)) {
+      ++found;
+    }
+    benchmark::DoNotOptimize(found);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+}  // namespace
+
+BENCHMARK(BM_AndBitset)->Arg(1 << 16)->Arg(1 << 28);
+BENCHMARK(BM_AndVectorBool)->Arg(1 << 16)->Arg(1 << 28);
+BENCHMARK(BM_CountBitset)->Arg(1 << 28);
+BENCHMARK(BM_CountVectorBool)->Arg(1 << 28);
+BENCHMARK(BM_FindNextBitset)->Arg(1 << 28);
@@ -0,0 +1,54 @@
+#include <benchmark/benchmark.h>
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <cstddef>
+
+#include "../lib_containers.h"
+
+namespace {
+// Peak resident set size of the process so far, in kilobytes. It only ever
+// grows, so compare policies by running them one at a time with
+// --benchmark_filter.
+long peakRssKb() {
+  rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+}
+
+// Appends range(0) ints under the given growth policy and reports how many
+// reallocations that took, the largest footprint seen during a reallocation
+// (old and new buffers live at once) and the slack left at the end.
+template <typename Growth>
+void BM_Growth(benchmark::State& state) {
+  std::size_t reallocations = 0;
+  std::size_t peak_bytes = 0;
+  std::size_t final_capacity = 0;
+  for (auto _ : state) {
+    lib::vector<int, Growth> v;
+    reallocations = 0;
+    peak_bytes = 0;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+      std::size_t capacity = v.capacity();
+      v.push_back(i);
+      if (v.capacity() != capacity) {
+        ++reallocations;
+        peak_bytes =
+            std::max(peak_bytes, (capacity + v.capacity()) * sizeof(int));
+      }
+    }
+    final_capacity = v.capacity();
+    benchmark::DoNotOptimize(v.data());
+  }
+  state.counters["reallocs"] = reallocations;
+  state.counters["peak_MiB"] = peak_bytes / double(1 << 20);
+  state.counters["slack_pct"] =
+      100.0 * (final_capacity - state.range(0)) / final_capacity;
+  state.counters["max_rss_MiB"] = peakRssKb() / 1024.0;
+}
+}  // namespace
+
+BENCHMARK_TEMPLATE(BM_Growth, lib::doubling_growth)->Arg(100000000);
+BENCHMARK_TEMPLATE(BM_Growth, lib::one_and_half_growth)->Arg(100000000);
+BENCHMARK_TEMPLATE(BM_Growth, lib::golden_growth)->Arg(100000000);
+BENCHMARK_TEMPLATE(BM_Growth, lib::linear_growth<1 << 24>)->Arg(100000000);
@@ -0,0 +1,56 @@
+#include <benchmark/benchmark.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#include "../lib_containers.h"
+#include "../lib_mmap_vector.h"
+
+namespace {
+struct Record {
+  int64_t id;
+  double value;
+};
+
+// Writes a range(0)-record file once per benchmark run.
+std::string makeDataset(int64_t records) {
+  std::string path =
+      "/tmp/lib_mmap_bench." + std::to_string(::getpid()) + ".dat";
+  lib::mmap_vector<Record> out(path,
+                               lib::mmap_vector<Record>::open_mode::truncate);
+  out.resize(records);
+  for (int64_t i = 0; i < records; ++i) out[i] = {i, i * 0.25};
+  return path;
+}
+
+// Opening is an mmap call, and reading one record faults in only its page.
+void BM_OpenMapped(benchmark::State& state) {
+  std::string path = makeDataset(state.range(0));
+  for (auto _ : state) {
+    lib::mmap_vector<Record> records(
+        path, lib::mmap_vector<Record>::open_mode::read_only);
+    records.advise(lib::mmap_vector<Record>::advice::sequential);
+    benchmark::DoNotOptimize(records[records.size() / 2].value);
+  }
+  std::remove(path.c_str());
+}
+
+// The load the mapping replaces: read the whole file into a vector.
+void BM_ReadIntoVector(benchmark::State& state) {
+  std::string path = makeDataset(state.range(0));
+  for (auto _ : state) {
+    std::FILE* in = std::fopen(path.c_str(), "rb");
+    lib::vector<Record> records(state.range(0));
+    std::size_t read =
+        std::fread(records.data(), sizeof(Record), records.size(), in);
+    std::fclose(in);
+    benchmark::DoNotOptimize(records[read / 2].value);
+  }
+  std::remove(path.c_str());
+}
+}  // namespace
+
+BENCHMARK(BM_OpenMapped)->Arg(1 << 22)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_ReadIntoVector)->Arg(1 << 22)->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,79 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <random>
+
+#include "../lib_containers.h"
+#include "../lib_packed_int_vector.h"
+
+namespace {
+// Sorted 64-bit IDs with gaps below 64, the kind of column the packed
+// vector is for.
+lib::vector<uint64_t> makeIds(int64_t n) {
+  lib::vector<uint64_t> ids;
+  std::mt19937_64 gen(42);
+  uint64_t id = uint64_t(1) << 40;
+  for (int64_t i = 0; i < n; ++i) {
+    id += gen() % 64;
+    ids.push_back(id);
+  }
+  return ids;
+}
+
+lib::packed_int_vector pack(lib::vector<uint64_t>& ids,
+                            lib::packed_int_vector::encoding mode) {
+  lib::packed_int_vector packed(mode);
+  packed.append(ids.data(), ids.size());
+  packed.shrink_to_fit();
+  return packed;
+}
+
+void BM_ScanRaw(benchmark::State& state) {
+  lib::vector<uint64_t> ids = makeIds(state.range(0));
+  for (auto _ : state) {
+    uint64_t sum = 0;
+    for (std::size_t i = 0; i < ids.size(); ++i) sum += ids[i];
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.counters["bytes_per_value"] = sizeof(uint64_t);
+}
+
+template <lib::packed_int_vector::encoding Mode>
+void BM_ScanPacked(benchmark::State& state) {
+  lib::vector<uint64_t> ids = makeIds(state.range(0));
+  lib::packed_int_vector packed = pack(ids, Mode);
+  for (auto _ : state) {
+    uint64_t sum = 0;
+    packed.for_each([&](uint64_t id) { sum += id; });
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+  state.counters["bytes_per_value"] =
+      double(packed.memory_usage()) / state.range(0);
+}
+
+template <lib::packed_int_vector::encoding Mode>
+void BM_RandomAccessPacked(benchmark::State& state) {
+  lib::vector<uint64_t> ids = makeIds(state.range(0));
+  lib::packed_int_vector packed = pack(ids, Mode);
+  std::mt19937_64 gen(7);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(packed[gen() % packed.size()]);
+  }
+}
+
+constexpr auto kFrameOfReference =
+    lib::packed_int_vector::encoding::frame_of_reference;
+constexpr auto kDelta = lib::packed_int_vector::encoding::delta;
+}  // namespace
+
+BENCHMARK(BM_ScanRaw)->Arg(1 << 24)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_ScanPacked, kFrameOfReference)
+    ->Arg(1 << 24)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_ScanPacked, kDelta)
+    ->Arg(1 << 24)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_RandomAccessPacked, kFrameOfReference)->Arg(1 << 24);
+BENCHMARK_TEMPLATE(BM_RandomAccessPacked, kDelta)->Arg(1 << 24);
@@ -0,0 +1,276 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+
+#include "../lib_containers.h"
+#include "../lib_containersplus.h"
+
+namespace {
+// range(0) values that never equal 1000, so find() scans everything.
+template <typename T>
+lib::vector<T> makeValues(benchmark::State& state) {
+  lib::vector<T> values;
+  for (int64_t i = 0; i < state.range(0); ++i) {
+    values.push_back(static_cast<T>(i % 997));
+  }
+  return values;
+}
+
+template <typename T>
+void BM_ScalarFind(benchmark::State& state) {
+  lib::vector<T> values = makeValues<T>(state);
+  for (auto _ : state) {
+    std::size_t i = 0;
+    while (i < values.size() && values[i] != T(1000)) ++i;
+    benchmark::DoNotOptimize(i);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T>
+void BM_SimdFind(benchmark::State& state) {
+  lib::vector<T> values = makeValues<T>(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(lib::simd::find(values, T(1000)));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T>
+void BM_ScalarCount(benchmark::State& state) {
+  lib::vector<T> values = makeValues<T>(state);
+  for (auto _ : state) {
+    std::size_t matches = 0;
+    for (std::size_t i = 0; i < values.size(); ++i) {
+      matches += values[i] == T(7);
+    }
+    benchmark::DoNotOptimize(matches);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T>
+void BM_SimdCount(benchmark::State& state) {
+  lib::vector<T> values = makeValues<T>(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(lib::simd::count(values, T(7)));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T>
+void BM_ScalarSum(benchmark::State& state) {
+  lib::vector<T> values = makeValues<T>(state);
+  for (auto _ : state) {
+    T sum = T();
+    for (std::size_t i = 0; i < values.size(); ++i) sum += values[i];
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T>
+void BM_SimdSum(benchmark::State& state) {
+  lib::vector<T> values = makeValues<T>(state);
+  for (auto _ : state) benchmark::DoNotOptimize(lib::simd::sum(values));
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T>
+void BM_ScalarDot(benchmark::State& state) {
+  lib::vector<T> a = makeValues<T>(state);
+  lib::vector<T> b = makeValues<T>(state);
+  for (auto _ : state) {
+    T dot = T();
+    for (std::size_t i = 0; i < a.size(); ++i) dot += a[i] * b[i];
+    benchmark::DoNotOptimize(dot);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T>
+void BM_SimdDot(benchmark::State& state) {
+  lib::vector<T> a = makeValues<T>(state);
+  lib::vector<T> b = makeValues<T>(state);
+  for (auto _ : state) benchmark::DoNotOptimize(lib::simd::dot(a, b));
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T>
+void BM_ScalarMinWithIndex(benchmark::State& state) {
+  lib::vector<T> values = makeValues<T>(state);
+  for (auto _ : state) {
+    std::size_t best = 0;
+    for (std::size_t i = 1; i < values.size(); ++i) {
+      if (values[i] < values[best]) best = i;
+    }
+    benchmark::DoNotOptimize(best);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T>
+void BM_SimdMinWithIndex(benchmark::State& state) {
+  lib::vector<T> values = makeValues<T>(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(lib::simd::min_with_index(values).index);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T>
+void BM_ScalarMaxWithIndex(benchmark::State& state) {
+  lib::vector<T> values = makeValues<T>(state);
+  for (auto _ : state) {
+    std::size_t best = 0;
+    for (std::size_t i = 1; i < values.size(); ++i) {
+      if (values[best] < values[i]) best = i;
+    }
+    benchmark::DoNotOptimize(best);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T>
+void BM_SimdMaxWithIndex(benchmark::State& state) {
+  lib::vector<T> values = makeValues<T>(state);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(lib::simd::max_with_index(values).index);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// One bit per element, 64 to a word, as the simd mask functions lay it out.
+template <typename T, typename Predicate>
+void scalarMask(lib::vector<T>& values, Predicate pred,
+                lib::vector<std::uint64_t>& mask) {
+  for (std::size_t base = 0; base < values.size(); base += 64) {
+    std::size_t end = std::min(values.size(), base + 64);
+    std::uint64_t bits = 0;
+    for (std::size_t i = base; i < end; ++i) {
+      bits |= std::uint64_t(pred(values[i])) << (i - base);
+    }
+    mask[base / 64] = bits;
+  }
+}
+
+template <typename T>
+void BM_ScalarEqualMask(benchmark::State& state) {
+  lib::vector<T> values = makeValues<T>(state);
+  lib::vector<std::uint64_t> mask((values.size() + 63) / 64);
+  for (auto _ : state) {
+    scalarMask(values, [](T x) { return x == T(7); }, mask);
+    benchmark::DoNotOptimize(mask.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T>
+void BM_SimdEqualMask(benchmark::State& state) {
+  lib::vector<T> values = makeValues<T>(state);
+  lib::vector<std::uint64_t> mask((values.size() + 63) / 64);
+  for (auto _ : state) {
+    lib::simd::equal_mask(values.data(), values.size(), T(7), mask.data());
+    benchmark::DoNotOptimize(mask.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T>
+void BM_ScalarLessMask(benchmark::State& state) {
+  lib::vector<T> values = makeValues<T>(state);
+  lib::vector<std::uint64_t> mask((values.size() + 63) / 64);
+  for (auto _ : state) {
+    scalarMask(values, [](T x) { return x < T(500); }, mask);
+    benchmark::DoNotOptimize(mask.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T>
+void BM_SimdLessMask(benchmark::State& state) {
+  lib::vector<T> values = makeValues<T>(state);
+  lib::vector<std::uint64_t> mask((values.size() + 63) / 64);
+  for (auto _ : state) {
+    lib::simd::less_mask(values.data(), values.size(), T(500), mask.data());
+    benchmark::DoNotOptimize(mask.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T>
+void BM_ScalarGreaterMask(benchmark::State& state) {
+  lib::vector<T> values = makeValues<T>(state);
+  lib::vector<std::uint64_t> mask((values.size() + 63) / 64);
+  for (auto _ : state) {
+    scalarMask(values, [](T x) { return T(500) < x; }, mask);
+    benchmark::DoNotOptimize(mask.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T>
+void BM_SimdGreaterMask(benchmark::State& state) {
+  lib::vector<T> values = makeValues<T>(state);
+  lib::vector<std::uint64_t> mask((values.size() + 63) / 64);
+  for (auto _ : state) {
+    lib::simd::greater_mask(values.data(), values.size(), T(500),
+                            mask.data());
+    benchmark::DoNotOptimize(mask.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T>
+void BM_ScalarClamp(benchmark::State& state) {
+  lib::vector<T> values = makeValues<T>(state);
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < values.size(); ++i) {
+      if (values[i] < T(100)) values[i] = T(100);
+      if (T(900) < values[i]) values[i] = T(900);
+    }
+    benchmark::DoNotOptimize(values.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <typename T>
+void BM_SimdClamp(benchmark::State& state) {
+  lib::vector<T> values = makeValues<T>(state);
+  for (auto _ : state) {
+    lib::simd::clamp(values, T(100), T(900));
+    benchmark::DoNotOptimize(values.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+}  // namespace
+
+BENCHMARK_TEMPLATE(BM_ScalarFind, float)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_SimdFind, float)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_ScalarFind, std::int32_t)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_SimdFind, std::int32_t)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_ScalarCount, std::int32_t)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_SimdCount, std::int32_t)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_ScalarSum, float)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_SimdSum, float)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_ScalarSum, double)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_SimdSum, double)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_ScalarDot, float)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_SimdDot, float)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_ScalarMinWithIndex, float)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_SimdMinWithIndex, float)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_ScalarMinWithIndex, std::int64_t)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_SimdMinWithIndex, std::int64_t)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_ScalarMaxWithIndex, float)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_SimdMaxWithIndex, float)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_ScalarMaxWithIndex, std::int64_t)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_SimdMaxWithIndex, std::int64_t)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_ScalarEqualMask, std::int32_t)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_SimdEqualMask, std::int32_t)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_ScalarLessMask, float)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_SimdLessMask, float)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_ScalarGreaterMask, float)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_SimdGreaterMask, float)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_ScalarClamp, std::int32_t)->Arg(1 << 16);
+BENCHMARK_TEMPLATE(BM_SimdClamp, std::int32_t)->Arg(1 << 16);
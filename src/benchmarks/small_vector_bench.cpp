@@ -0,0 +1,46 @@
+#include <benchmark/benchmark.h>
+
+#include "../lib_containers.h"
+#include "../lib_containersplus.h"
+
+namespace {
+// Constructs a vector, appends range(0) ints and destroys it, which is the
+// whole life of a typical short option list.
+template <typename Vector>
+void BM_ConstructFillDestroy(benchmark::State& state) {
+  for (auto _ : state) {
+    Vector v;
+    for (int64_t i = 0; i < state.range(0); ++i) v.push_back(i);
+    benchmark::DoNotOptimize(v.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Copies a filled range(0)-element vector, as when a packet's header list
+// is handed to another stage.
+template <typename Vector>
+void BM_CopyFilled(benchmark::State& state) {
+  Vector source;
+  for (int64_t i = 0; i < state.range(0); ++i) source.push_back(i);
+  for (auto _ : state) {
+    Vector copy(source);
+    benchmark::DoNotOptimize(copy.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+}  // namespace
+
+BENCHMARK_TEMPLATE(BM_ConstructFillDestroy, lib::vector<int>)
+    ->DenseRange(4, 16, 4);
+BENCHMARK_TEMPLATE(BM_ConstructFillDestroy, lib::small_vector<int, 4>)
+    ->DenseRange(4, 16, 4);
+BENCHMARK_TEMPLATE(BM_ConstructFillDestroy, lib::small_vector<int, 8>)
+    ->DenseRange(4, 16, 4);
+BENCHMARK_TEMPLATE(BM_ConstructFillDestroy, lib::small_vector<int, 16>)
+    ->DenseRange(4, 16, 4);
+BENCHMARK_TEMPLATE(BM_ConstructFillDestroy, lib::static_vector<int, 16>)
+    ->DenseRange(4, 16, 4);
+
+BENCHMARK_TEMPLATE(BM_CopyFilled, lib::vector<int>)->Arg(16);
+BENCHMARK_TEMPLATE(BM_CopyFilled, lib::small_vector<int, 16>)->Arg(16);
+BENCHMARK_TEMPLATE(BM_CopyFilled, lib::static_vector<int, 16>)->Arg(16);
@@ -0,0 +1,62 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+
+#include "../lib_containers.h"
+#include "../lib_containersplus.h"
+
+namespace {
+struct Trade {
+  int64_t id;
+  int64_t ts;
+  double price;
+  double qty;
+};
+
+using Trades = lib::soa_vector<int64_t, int64_t, double, double>;
+
+// Summing price out of whole records reads all 32 bytes of each one.
+void BM_SumFieldAos(benchmark::State& state) {
+  lib::vector<Trade> trades;
+  for (int64_t i = 0; i < state.range(0); ++i) {
+    trades.push_back({i, i, double(i % 100), 1.0});
+  }
+  for (auto _ : state) {
+    double sum = 0;
+    for (std::size_t i = 0; i < trades.size(); ++i) sum += trades[i].price;
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// The price column alone: 8 bytes per record, loaded contiguously.
+void BM_SumFieldSoa(benchmark::State& state) {
+  Trades trades;
+  for (int64_t i = 0; i < state.range(0); ++i) {
+    trades.emplace_back(i, i, double(i % 100), 1.0);
+  }
+  for (auto _ : state) {
+    double sum = 0;
+    for (double price : trades.column<2>()) sum += price;
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// The same column through the SIMD reduction.
+void BM_SumFieldSoaSimd(benchmark::State& state) {
+  Trades trades;
+  for (int64_t i = 0; i < state.range(0); ++i) {
+    trades.emplace_back(i, i, double(i % 100), 1.0);
+  }
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(
+        lib::simd::sum(trades.data<2>(), trades.size()));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+}  // namespace
+
+BENCHMARK(BM_SumFieldAos)->Arg(1 << 12)->Arg(1 << 22);
+BENCHMARK(BM_SumFieldSoa)->Arg(1 << 12)->Arg(1 << 22);
+BENCHMARK(BM_SumFieldSoaSimd)->Arg(1 << 12)->Arg(1 << 22);
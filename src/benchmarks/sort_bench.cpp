@@ -0,0 +1,100 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <random>
+
+#include "../lib_containers.h"
+
+namespace {
+enum Input { kRandom, kSorted, kReversed, kFewUnique };
+
+template <typename T>
+lib::vector<T> makeInput(int64_t n, int64_t kind) {
+  std::mt19937_64 gen(42);
+  lib::vector<T> values;
+  values.reserve(n);
+  for (int64_t i = 0; i < n; ++i) {
+    values.push_back(kind == kFewUnique ? T(gen() % 16) : T(gen() % (1 << 30)));
+  }
+  if (kind == kSorted) std::sort(values.begin(), values.end());
+  if (kind == kReversed) {
+    std::sort(values.begin(), values.end(), std::greater<>());
+  }
+  return values;
+}
+
+// Sorts a fresh copy of a range(0)-element input of kind range(1) with
+// lib::vector::sort (range(2) == 0) or std::sort.
+template <typename T>
+void BM_Sort(benchmark::State& state) {
+  lib::vector<T> input = makeInput<T>(state.range(0), state.range(1));
+  for (auto _ : state) {
+    state.PauseTiming();
+    lib::vector<T> values = input;
+    state.ResumeTiming();
+    if (state.range(2) == 0)
+      values.sort();
+    else
+      std::sort(values.begin(), values.end());
+    benchmark::DoNotOptimize(values.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Comparison sorts only: a comparator that is not std::less keeps the radix
+// sort out.
+void BM_IntrosortVsStdSort(benchmark::State& state) {
+  lib::vector<int64_t> input = makeInput<int64_t>(state.range(0),
+                                                  state.range(1));
+  auto less = [](int64_t a, int64_t b) { return a < b; };
+  for (auto _ : state) {
+    state.PauseTiming();
+    lib::vector<int64_t> values = input;
+    state.ResumeTiming();
+    if (state.range(2) == 0)
+      values.sort(less);
+    else
+      std::sort(values.begin(), values.end(), less);
+    benchmark::DoNotOptimize(values.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+void BM_StableSortVsStd(benchmark::State& state) {
+  lib::vector<int64_t> input = makeInput<int64_t>(state.range(0),
+                                                  state.range(1));
+  auto less = [](int64_t a, int64_t b) { return a < b; };
+  for (auto _ : state) {
+    state.PauseTiming();
+    lib::vector<int64_t> values = input;
+    state.ResumeTiming();
+    if (state.range(2) == 0)
+      values.stable_sort(less);
+    else
+      std::stable_sort(values.begin(), values.end(), less);
+    benchmark::DoNotOptimize(values.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+}  // namespace
+
+// 1M and 16M elements by default; 100M works the same way but needs about
+// 2 GiB for the int64_t input, its copy and the radix buffer.
+BENCHMARK_TEMPLATE(BM_Sort, int64_t)
+    ->ArgsProduct({{1 << 20, 1 << 24},
+                   {kRandom, kSorted, kReversed, kFewUnique},
+                   {0, 1}})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_Sort, float)
+    ->ArgsProduct({{1 << 20}, {kRandom, kSorted, kFewUnique}, {0, 1}})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_IntrosortVsStdSort)
+    ->ArgsProduct({{1 << 20}, {kRandom, kSorted, kReversed, kFewUnique},
+                   {0, 1}})
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_StableSortVsStd)
+    ->ArgsProduct({{1 << 20}, {kRandom, kSorted, kReversed, kFewUnique},
+                   {0, 1}})
+    ->Unit(benchmark::kMillisecond);
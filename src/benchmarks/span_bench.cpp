@@ -0,0 +1,55 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+
+#include "../lib_containers.h"
+#include "../lib_containersplus.h"
+
+namespace {
+// A parsing step that hands range(0)-element fields of one buffer to a
+// consumer, first as a copied vector and then as a span.
+int64_t consume(lib::span<const int32_t> field) {
+  int64_t total = 0;
+  for (int32_t v : field) total += v;
+  return total;
+}
+
+lib::vector<int32_t> makeBuffer() {
+  lib::vector<int32_t> buffer;
+  for (int32_t i = 0; i < (1 << 16); ++i) buffer.push_back(i & 1023);
+  return buffer;
+}
+
+void BM_FieldsAsVectors(benchmark::State& state) {
+  lib::vector<int32_t> buffer = makeBuffer();
+  std::size_t field = state.range(0);
+  for (auto _ : state) {
+    int64_t total = 0;
+    for (std::size_t at = 0; at + field <= buffer.size(); at += field) {
+      lib::vector<int32_t> copy;
+      copy.insert(copy.begin(), buffer.begin() + at,
+                  buffer.begin() + at + field);
+      total += consume(copy);
+    }
+    benchmark::DoNotOptimize(total);
+  }
+  state.SetItemsProcessed(state.iterations() * buffer.size());
+}
+
+void BM_FieldsAsSpans(benchmark::State& state) {
+  lib::vector<int32_t> buffer = makeBuffer();
+  lib::span<const int32_t> all(buffer);
+  std::size_t field = state.range(0);
+  for (auto _ : state) {
+    int64_t total = 0;
+    for (std::size_t at = 0; at + field <= all.size(); at += field) {
+      total += consume(all.subspan(at, field));
+    }
+    benchmark::DoNotOptimize(total);
+  }
+  state.SetItemsProcessed(state.iterations() * buffer.size());
+}
+}  // namespace
+
+BENCHMARK(BM_FieldsAsVectors)->Arg(16)->Arg(1024);
+BENCHMARK(BM_FieldsAsSpans)->Arg(16)->Arg(1024);
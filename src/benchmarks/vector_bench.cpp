@@ -0,0 +1,129 @@
+#include <benchmark/benchmark.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "../lib_containers.h"
+
+namespace {
+template <typename T>
+T makeValue();
+
+template <>
+int makeValue<int>() {
+  return 42;
+}
+
+template <>
+std::string makeValue<std::string>() {
+  return std::string(64, 'x');
+}
+
+template <>
+lib::vector<int> makeValue<lib::vector<int>>() {
+  return lib::vector<int>({1, 2, 3, 4, 5, 6, 7, 8});
+}
+
+// Appends range(0) copies of one value to a fresh vector, so every doubling
+// relocates everything pushed so far.
+template <typename Vector>
+void BM_PushBack(benchmark::State& state) {
+  const typename Vector::value_type value =
+      makeValue<typename Vector::value_type>();
+  for (auto _ : state) {
+    Vector v;
+    for (int64_t i = 0; i < state.range(0); ++i) v.push_back(value);
+    benchmark::DoNotOptimize(v.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Appends range(0) strings built from (count, char) arguments, either in
+// place or by constructing a temporary and copying it.
+template <bool kEmplace>
+void BM_AppendString(benchmark::State& state) {
+  for (auto _ : state) {
+    lib::vector<std::string> v;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+      if constexpr (kEmplace) {
+        v.emplace_back(64, 'x');
+      } else {
+        const std::string value(64, 'x');
+        v.push_back(value);
+      }
+    }
+    benchmark::DoNotOptimize(v.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Inserts 1000 values near the front of a range(0)-element vector in one
+// call.
+template <typename Vector>
+void BM_InsertRangeNearFront(benchmark::State& state) {
+  const std::vector<int> extra(1000, 7);
+  for (auto _ : state) {
+    state.PauseTiming();
+    Vector v;
+    v.reserve(state.range(0) + extra.size());
+    for (int64_t i = 0; i < state.range(0); ++i) v.push_back(i);
+    state.ResumeTiming();
+    v.insert(v.begin() + 1, extra.begin(), extra.end());
+    benchmark::DoNotOptimize(v.data());
+  }
+}
+
+// Drops every odd value from a range(0)-element vector.
+void BM_EraseIf(benchmark::State& state) {
+  for (auto _ : state) {
+    state.PauseTiming();
+    lib::vector<int> v;
+    v.reserve(state.range(0));
+    for (int64_t i = 0; i < state.range(0); ++i) v.push_back(i);
+    state.ResumeTiming();
+    v.erase_if([](int value) { return value % 2 != 0; });
+    benchmark::DoNotOptimize(v.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// Refills a reused range(0)-byte receive buffer from a source the way read()
+// would: resize() zeroes the bytes first, resize_default_init does not.
+template <bool DefaultInit>
+void BM_RefillBuffer(benchmark::State& state) {
+  std::size_t bytes = state.range(0);
+  lib::vector<char> source;
+  source.resize(bytes, 'x');
+  lib::vector<char> buffer;
+  buffer.reserve(bytes);
+  for (auto _ : state) {
+    buffer.clear();
+    if (DefaultInit)
+      buffer.resize_default_init(bytes);
+    else
+      buffer.resize(bytes);
+    std::memcpy(buffer.data(), source.data(), bytes);
+    benchmark::DoNotOptimize(buffer.data());
+  }
+  state.SetBytesProcessed(state.iterations() * bytes);
+}
+}  // namespace
+
+BENCHMARK_TEMPLATE(BM_PushBack, lib::vector<int>)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_PushBack, std::vector<int>)->Range(1 << 10, 1 << 20);
+BENCHMARK_TEMPLATE(BM_PushBack, lib::vector<std::string>)
+    ->Range(1 << 10, 1 << 18);
+BENCHMARK_TEMPLATE(BM_PushBack, std::vector<std::string>)
+    ->Range(1 << 10, 1 << 18);
+BENCHMARK_TEMPLATE(BM_PushBack, lib::vector<lib::vector<int>>)
+    ->Range(1 << 10, 1 << 18);
+BENCHMARK_TEMPLATE(BM_AppendString, false)->Range(1 << 10, 1 << 18);
+BENCHMARK_TEMPLATE(BM_AppendString, true)->Range(1 << 10, 1 << 18);
+BENCHMARK_TEMPLATE(BM_InsertRangeNearFront, lib::vector<int>)
+    ->Range(1 << 10, 1 << 22);
+BENCHMARK_TEMPLATE(BM_InsertRangeNearFront, std::vector<int>)
+    ->Range(1 << 10, 1 << 22);
+BENCHMARK(BM_EraseIf)->Range(1 << 10, 1 << 22);
+BENCHMARK_TEMPLATE(BM_RefillBuffer, false)->Arg(1 << 16)->Arg(1 << 22);
+BENCHMARK_TEMPLATE(BM_RefillBuffer, true)->Arg(1 << 16)->Arg(1 << 22);
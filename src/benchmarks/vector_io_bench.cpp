@@ -0,0 +1,91 @@
+#include <benchmark/benchmark.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#include "../lib_containers.h"
+#include "../lib_vector_io.h"
+
+namespace {
+struct Record {
+  int64_t id;
+  double value;
+};
+
+// Writes a range(0)-record file once per benchmark run.
+std::string makeDataset(int64_t records) {
+  std::string path =
+      "/tmp/lib_vector_io_bench." + std::to_string(::getpid()) + ".dat";
+  lib::vector<Record> out;
+  out.reserve(records);
+  for (int64_t i = 0; i < records; ++i) out.push_back({i, i * 0.25});
+  lib::write_to(out, path);
+  return path;
+}
+
+// The load append_from replaces: fread a staging buffer, then push_back
+// each record.
+void BM_LoadPushBack(benchmark::State& state) {
+  std::string path = makeDataset(state.range(0));
+  Record staging[4096];
+  for (auto _ : state) {
+    std::FILE* in = std::fopen(path.c_str(), "rb");
+    lib::vector<Record> records;
+    std::size_t n;
+    while ((n = std::fread(staging, sizeof(Record), 4096, in)) > 0) {
+      for (std::size_t i = 0; i < n; ++i) records.push_back(staging[i]);
+    }
+    std::fclose(in);
+    benchmark::DoNotOptimize(records.data());
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) *
+                          sizeof(Record));
+  std::remove(path.c_str());
+}
+
+void BM_LoadAppendFrom(benchmark::State& state) {
+  std::string path = makeDataset(state.range(0));
+  for (auto _ : state) {
+    lib::vector<Record> records;
+    lib::append_from(records, path);
+    benchmark::DoNotOptimize(records.data());
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) *
+                          sizeof(Record));
+  std::remove(path.c_str());
+}
+
+// One reused 1 MiB chunk instead of the whole file in memory.
+void BM_StreamRecordReader(benchmark::State& state) {
+  std::string path = makeDataset(state.range(0));
+  lib::vector<Record> chunk;
+  for (auto _ : state) {
+    lib::record_reader<Record> reader(path);
+    int64_t sum = 0;
+    while (reader.next(chunk)) {
+      for (std::size_t i = 0; i < chunk.size(); ++i) sum += chunk[i].id;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0) *
+                          sizeof(Record));
+  std::remove(path.c_str());
+}
+
+void BM_WriteTo(benchmark::State& state) {
+  std::string path = makeDataset(state.range(0));
+  lib::vector<Record> records;
+  lib::append_from(records, path);
+  for (auto _ : state) lib::write_to(records, path);
+  state.SetBytesProcessed(state.iterations() * state.range(0) *
+                          sizeof(Record));
+  std::remove(path.c_str());
+}
+}  // namespace
+
+BENCHMARK(BM_LoadPushBack)->Arg(1 << 22)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_LoadAppendFrom)->Arg(1 << 22)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_StreamRecordReader)->Arg(1 << 22)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_WriteTo)->Arg(1 << 22)->Unit(benchmark::kMillisecond);
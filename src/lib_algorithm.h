@@ -0,0 +1,538 @@
+#ifndef LIB_ALGORITHM_H_
+#define LIB_ALGORITHM_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <optional>
+#include <utility>
+
+#include "lib_sort.h"
+#include "lib_span.h"
+#include "lib_thread_pool.h"
+#include "lib_vector.h"
+
+// Sequential and parallel versions of sort, transform, reduce, inclusive
+// scan and for_each over random-access ranges, plus overloads taking a
+// whole vector, span or strided_view. The parallel versions cut the range
+// into chunks of about kChunkBytes, whose boundaries depend only on the
+// length of the range, and run them on a thread_pool. A range of one chunk
+// runs on the calling thread, so the two versions can be compared at any
+// size.
+namespace lib {
+namespace algorithm_detail {
+constexpr std::size_t kChunkBytes = 64 * 1024;
+
+template <typename T>
+constexpr std::size_t chunkSize() noexcept {
+  return sizeof(T) >= kChunkBytes ? 1 : kChunkBytes / sizeof(T);
+}
+
+// Calls f(begin, end) for consecutive pieces of [0, n) of the given size.
+template <typename Function>
+void forEachChunk(std::size_t n, std::size_t chunk, thread_pool &pool,
+                  Function f) {
+  std::size_t chunks = (n + chunk - 1) / chunk;
+  pool.parallel_for(chunks, [&](std::size_t i) {
+    std::size_t begin = i * chunk;
+    f(begin, std::min(n, begin + chunk));
+  });
+}
+
+// Number of elements of a that precede output position d when the sorted
+// ranges a[0, m) and b[0, k) are merged stably.
+template <typename RandomIt, typename Compare>
+std::size_t mergeSplit(RandomIt a, std::size_t m, RandomIt b, std::size_t k,
+                       std::size_t d, Compare &comp) {
+  std::size_t low = d > k ? d - k : 0;
+  std::size_t high = std::min(d, m);
+  while (low < high) {
+    std::size_t i = low + (high - low) / 2;
+    if (!comp(b[d - i - 1], a[i]))
+      low = i + 1;
+    else
+      high = i;
+  }
+  return low;
+}
+
+// Output iterator that move-constructs into raw storage and counts the
+// elements it built.
+template <typename T>
+class ConstructingOutput {
+ public:
+  using iterator_category = std::output_iterator_tag;
+  using value_type = void;
+  using difference_type = std::ptrdiff_t;
+  using pointer = void;
+  using reference = void;
+
+  ConstructingOutput(T *p, std::size_t &built) : p_(p), built_(&built) {}
+
+  ConstructingOutput &operator*() { return *this; }
+  ConstructingOutput &operator=(T &&value) {
+    ::new (static_cast<void *>(p_)) T(std::move(value));
+    ++p_;
+    ++*built_;
+    return *this;
+  }
+  ConstructingOutput &operator++() { return *this; }
+  ConstructingOutput &operator++(int) { return *this; }
+
+ private:
+  T *p_;
+  std::size_t *built_;
+};
+
+// Destination of a merge into raw storage. The merge fills every chunk of
+// the output front to back, so built[i] elements from the start of chunk i
+// exist even if it stops early.
+template <typename T>
+struct RawDestination {
+  T *p;
+  std::size_t chunk;
+  std::size_t *built;
+
+  ConstructingOutput<T> operator+(std::size_t pos) const {
+    return ConstructingOutput<T>(p + pos, built[pos / chunk]);
+  }
+};
+
+// Merges the neighbouring sorted runs of length run in [from, from + n)
+// into runs of twice the length at to, each merge split into chunks of the
+// output so that even the last merge keeps every thread busy. All split
+// points are found before anything is moved from the source.
+template <typename Source, typename Dest, typename Compare>
+void mergeRuns(Source from, Dest to, std::size_t n, std::size_t run,
+               std::size_t chunk, Compare &comp, thread_pool &pool) {
+  auto pairAt = [&](std::size_t pos, std::size_t &m, std::size_t &k) {
+    std::size_t pair = pos / (2 * run) * (2 * run);
+    m = std::min(run, n - pair);
+    k = std::min(run, n - pair - m);
+    return pair;
+  };
+  std::size_t chunks = (n + chunk - 1) / chunk;
+  vector<std::size_t> splits(chunks + 1);
+  pool.parallel_for(chunks + 1, [&](std::size_t i) {
+    std::size_t pos = std::min(n, i * chunk);
+    std::size_t m, k;
+    std::size_t pair = pairAt(pos, m, k);
+    splits[i] = mergeSplit(from + pair, m, from + pair + m, k, pos - pair,
+                           comp);
+  });
+  forEachChunk(n, chunk, pool, [&](std::size_t begin, std::size_t end) {
+    std::size_t i0 = splits[begin / chunk];
+    while (begin < end) {
+      std::size_t m, k;
+      std::size_t pair = pairAt(begin, m, k);
+      std::size_t stop = std::min(end, pair + m + k);
+      std::size_t i1 = stop == pair + m + k ? m : splits[begin / chunk + 1];
+      Source a = from + pair;
+      Source b = a + m;
+      std::merge(std::make_move_iterator(a + i0),
+                 std::make_move_iterator(a + i1),
+                 std::make_move_iterator(b + (begin - pair - i0)),
+                 std::make_move_iterator(b + (stop - pair - i1)), to + begin,
+                 comp);
+      begin = stop;
+      i0 = 0;
+    }
+  });
+}
+}  // namespace algorithm_detail
+
+// Unstable sort of [first, last) with the kernels of vector::sort.
+template <typename RandomIt, typename Compare = std::less<>>
+void sort(RandomIt first, RandomIt last, Compare comp = Compare()) {
+  sort_detail::sort(first, last, comp);
+}
+
+// Sorts up to pool.size(), rounded up to a power of two, runs concurrently
+// and merges them pairwise through a buffer, every merge spread over the
+// pool. The first merge moves the elements into the uninitialized buffer.
+// Not stable.
+template <typename RandomIt, typename Compare = std::less<>>
+void parallel_sort(RandomIt first, RandomIt last, Compare comp = Compare(),
+                   thread_pool &pool = thread_pool::global()) {
+  using T = typename std::iterator_traits<RandomIt>::value_type;
+  std::size_t n = last - first;
+  std::size_t chunk = algorithm_detail::chunkSize<T>();
+  std::size_t runs = 1;
+  while (runs < pool.size() && n / (2 * runs) >= chunk) runs *= 2;
+  std::size_t run = (n + runs - 1) / runs;
+  if (runs == 1) {
+    lib::sort(first, last, comp);
+    return;
+  }
+  pool.parallel_for(runs, [&](std::size_t i) {
+    std::size_t begin = std::min(n, i * run);
+    lib::sort(first + begin, first + std::min(n, begin + run), comp);
+  });
+
+  sort_detail::RawBuffer<T> raw(n);
+  T *buffer = raw.get();
+  sort_detail::BufferElements<T> elements{buffer, 0};
+  vector<std::size_t> built((n + chunk - 1) / chunk);
+  try {
+    algorithm_detail::mergeRuns(
+        first, algorithm_detail::RawDestination<T>{buffer, chunk, built.data()},
+        n, run, chunk, comp, pool);
+  } catch (...) {
+    for (std::size_t i = 0; i < built.size(); ++i) {
+      std::destroy_n(buffer + i * chunk, built[i]);
+    }
+    throw;
+  }
+  elements.n = n;
+  bool in_buffer = true;
+  for (run *= 2; run < n; run *= 2) {
+    if (in_buffer) {
+      algorithm_detail::mergeRuns(buffer, first, n, run, chunk, comp, pool);
+    } else {
+      algorithm_detail::mergeRuns(first, buffer, n, run, chunk, comp, pool);
+    }
+    in_buffer = !in_buffer;
+  }
+  if (in_buffer) {
+    algorithm_detail::forEachChunk(
+        n, chunk, pool, [&](std::size_t begin, std::size_t end) {
+          std::move(buffer + begin, buffer + end, first + begin);
+        });
+  }
+}
+
+// Writes op(x) to d_first for every x in [first, last).
+template <typename InputIt, typename OutputIt, typename UnaryOp>
+OutputIt transform(InputIt first, InputIt last, OutputIt d_first,
+                   UnaryOp op) {
+  for (; first != last; ++first, ++d_first) *d_first = op(*first);
+  return d_first;
+}
+
+// As transform; op runs concurrently, so it must be safe to call in
+// parallel.
+template <typename RandomIt, typename OutputIt, typename UnaryOp>
+OutputIt parallel_transform(RandomIt first, RandomIt last, OutputIt d_first,
+                            UnaryOp op,
+                            thread_pool &pool = thread_pool::global()) {
+  using T = typename std::iterator_traits<RandomIt>::value_type;
+  std::size_t n = last - first;
+  algorithm_detail::forEachChunk(
+      n, algorithm_detail::chunkSize<T>(), pool,
+      [&](std::size_t begin, std::size_t end) {
+        lib::transform(first + begin, first + end, d_first + begin, op);
+      });
+  return d_first + n;
+}
+
+template <typename InputIt, typename Function>
+void for_each(InputIt first, InputIt last, Function f) {
+  for (; first != last; ++first) f(*first);
+}
+
+// Calls f on every element concurrently, so f must be safe to call in
+// parallel.
+template <typename RandomIt, typename Function>
+void parallel_for_each(RandomIt first, RandomIt last, Function f,
+                       thread_pool &pool = thread_pool::global()) {
+  using T = typename std::iterator_traits<RandomIt>::value_type;
+  algorithm_detail::forEachChunk(
+      last - first, algorithm_detail::chunkSize<T>(), pool,
+      [&](std::size_t begin, std::size_t end) {
+        lib::for_each(first + begin, first + end, f);
+      });
+}
+
+// Left fold of [first, last) with op, starting from init.
+template <typename InputIt, typename T, typename BinaryOp = std::plus<>>
+T reduce(InputIt first, InputIt last, T init, BinaryOp op = BinaryOp()) {
+  for (; first != last; ++first) init = op(std::move(init), *first);
+  return init;
+}
+
+// Folds each chunk separately and combines the partial results left to
+// right, starting from init. The grouping depends only on the length of
+// the range, so the result is the same on every run and for every pool
+// size, and for an associative op it equals reduce().
+template <typename RandomIt, typename T, typename BinaryOp = std::plus<>>
+T parallel_reduce(RandomIt first, RandomIt last, T init,
+                  BinaryOp op = BinaryOp(),
+                  thread_pool &pool = thread_pool::global()) {
+  using Value = typename std::iterator_traits<RandomIt>::value_type;
+  std::size_t n = last - first;
+  std::size_t chunk = algorithm_detail::chunkSize<Value>();
+  vector<std::optional<T>> partials((n + chunk - 1) / chunk);
+  algorithm_detail::forEachChunk(
+      n, chunk, pool, [&](std::size_t begin, std::size_t end) {
+        T acc(first[begin]);
+        acc = lib::reduce(first + begin + 1, first + end, std::move(acc), op);
+        partials[begin / chunk].emplace(std::move(acc));
+      });
+  for (std::size_t i = 0; i < partials.size(); ++i) {
+    init = op(std::move(init), std::move(*partials[i]));
+  }
+  return init;
+}
+
+// Writes x0, op(x0, x1), op(op(x0, x1), x2), ... to d_first, which may be
+// first.
+template <typename InputIt, typename OutputIt, typename BinaryOp = std::plus<>>
+OutputIt inclusive_scan(InputIt first, InputIt last, OutputIt d_first,
+                        BinaryOp op = BinaryOp()) {
+  if (first == last) return d_first;
+  typename std::iterator_traits<InputIt>::value_type acc = *first;
+  *d_first = acc;
+  for (++first, ++d_first; first != last; ++first, ++d_first) {
+    acc = op(std::move(acc), *first);
+    *d_first = acc;
+  }
+  return d_first;
+}
+
+// Two passes over the chunks: the first folds each chunk, then the running
+// totals of the chunks before each one are folded in order, and the second
+// scans every chunk from its running total. The result is deterministic in
+// the same way as parallel_reduce, and d_first may be first.
+template <typename RandomIt, typename OutputIt,
+          typename BinaryOp = std::plus<>>
+OutputIt parallel_inclusive_scan(RandomIt first, RandomIt last,
+                                 OutputIt d_first, BinaryOp op = BinaryOp(),
+                                 thread_pool &pool = thread_pool::global()) {
+  using T = typename std::iterator_traits<RandomIt>::value_type;
+  std::size_t n = last - first;
+  std::size_t chunk = algorithm_detail::chunkSize<T>();
+  std::size_t chunks = (n + chunk - 1) / chunk;
+  if (chunks <= 1) return lib::inclusive_scan(first, last, d_first, op);
+  vector<std::optional<T>> carries(chunks);
+  algorithm_detail::forEachChunk(
+      (chunks - 1) * chunk, chunk, pool,
+      [&](std::size_t begin, std::size_t end) {
+        T acc(first[begin]);
+        acc = lib::reduce(first + begin + 1, first + end, std::move(acc), op);
+        carries[begin / chunk + 1].emplace(std::move(acc));
+      });
+  for (std::size_t i = 2; i < chunks; ++i) {
+    carries[i] = op(std::move(*carries[i - 1]), std::move(*carries[i]));
+  }
+  algorithm_detail::forEachChunk(
+      n, chunk, pool, [&](std::size_t begin, std::size_t end) {
+        std::optional<T> &carry = carries[begin / chunk];
+        if (!carry) {
+          lib::inclusive_scan(first + begin, first + end, d_first + begin, op);
+          return;
+        }
+        T acc = std::move(*carry);
+        for (; begin < end; ++begin) {
+          acc = op(std::move(acc), first[begin]);
+          d_first[begin] = acc;
+        }
+      });
+  return d_first + n;
+}
+
+// Whole-vector forms of the algorithms above. transform and inclusive_scan
+// work in place.
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment,
+          typename Compare = std::less<>>
+void sort(BasicVector<T, N, Growth, Alignment> &v, Compare comp = Compare()) {
+  lib::sort(v.begin(), v.end(), comp);
+}
+
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment,
+          typename Compare = std::less<>>
+void parallel_sort(BasicVector<T, N, Growth, Alignment> &v,
+                   Compare comp = Compare(),
+                   thread_pool &pool = thread_pool::global()) {
+  lib::parallel_sort(v.begin(), v.end(), comp, pool);
+}
+
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment,
+          typename UnaryOp>
+void transform(BasicVector<T, N, Growth, Alignment> &v, UnaryOp op) {
+  lib::transform(v.begin(), v.end(), v.begin(), op);
+}
+
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment,
+          typename UnaryOp>
+void parallel_transform(BasicVector<T, N, Growth, Alignment> &v, UnaryOp op,
+                        thread_pool &pool = thread_pool::global()) {
+  lib::parallel_transform(v.begin(), v.end(), v.begin(), op, pool);
+}
+
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment,
+          typename Function>
+void for_each(BasicVector<T, N, Growth, Alignment> &v, Function f) {
+  lib::for_each(v.begin(), v.end(), f);
+}
+
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment,
+          typename Function>
+void for_each(const BasicVector<T, N, Growth, Alignment> &v, Function f) {
+  lib::for_each(v.begin(), v.end(), f);
+}
+
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment,
+          typename Function>
+void parallel_for_each(BasicVector<T, N, Growth, Alignment> &v, Function f,
+                       thread_pool &pool = thread_pool::global()) {
+  lib::parallel_for_each(v.begin(), v.end(), f, pool);
+}
+
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment,
+          typename Function>
+void parallel_for_each(const BasicVector<T, N, Growth, Alignment> &v,
+                       Function f, thread_pool &pool = thread_pool::global()) {
+  lib::parallel_for_each(v.begin(), v.end(), f, pool);
+}
+
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment,
+          typename Result,
+          typename BinaryOp = std::plus<>>
+Result reduce(const BasicVector<T, N, Growth, Alignment> &v, Result init,
+              BinaryOp op = BinaryOp()) {
+  return lib::reduce(v.begin(), v.end(), std::move(init), op);
+}
+
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment,
+          typename Result,
+          typename BinaryOp = std::plus<>>
+Result parallel_reduce(const BasicVector<T, N, Growth, Alignment> &v,
+                       Result init, BinaryOp op = BinaryOp(),
+                       thread_pool &pool = thread_pool::global()) {
+  return lib::parallel_reduce(v.begin(), v.end(), std::move(init), op, pool);
+}
+
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment,
+          typename BinaryOp = std::plus<>>
+void inclusive_scan(BasicVector<T, N, Growth, Alignment> &v,
+                    BinaryOp op = BinaryOp()) {
+  lib::inclusive_scan(v.begin(), v.end(), v.begin(), op);
+}
+
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment,
+          typename BinaryOp = std::plus<>>
+void parallel_inclusive_scan(BasicVector<T, N, Growth, Alignment> &v,
+                             BinaryOp op = BinaryOp(),
+                             thread_pool &pool = thread_pool::global()) {
+  lib::parallel_inclusive_scan(v.begin(), v.end(), v.begin(), op, pool);
+}
+
+// The same forms over the elements a span or strided_view refers to. Views
+// are taken by value, so a subspan can be passed straight in.
+template <typename T, std::size_t Extent, typename Compare = std::less<>>
+void sort(span<T, Extent> v, Compare comp = Compare()) {
+  lib::sort(v.begin(), v.end(), comp);
+}
+
+template <typename T, std::size_t Extent, typename Compare = std::less<>>
+void parallel_sort(span<T, Extent> v, Compare comp = Compare(),
+                   thread_pool &pool = thread_pool::global()) {
+  lib::parallel_sort(v.begin(), v.end(), comp, pool);
+}
+
+template <typename T, std::size_t Extent, typename UnaryOp>
+void transform(span<T, Extent> v, UnaryOp op) {
+  lib::transform(v.begin(), v.end(), v.begin(), op);
+}
+
+template <typename T, std::size_t Extent, typename UnaryOp>
+void parallel_transform(span<T, Extent> v, UnaryOp op,
+                        thread_pool &pool = thread_pool::global()) {
+  lib::parallel_transform(v.begin(), v.end(), v.begin(), op, pool);
+}
+
+template <typename T, std::size_t Extent, typename Function>
+void for_each(span<T, Extent> v, Function f) {
+  lib::for_each(v.begin(), v.end(), f);
+}
+
+template <typename T, std::size_t Extent, typename Function>
+void parallel_for_each(span<T, Extent> v, Function f,
+                       thread_pool &pool = thread_pool::global()) {
+  lib::parallel_for_each(v.begin(), v.end(), f, pool);
+}
+
+template <typename T, std::size_t Extent, typename Result,
+          typename BinaryOp = std::plus<>>
+Result reduce(span<T, Extent> v, Result init, BinaryOp op = BinaryOp()) {
+  return lib::reduce(v.begin(), v.end(), std::move(init), op);
+}
+
+template <typename T, std::size_t Extent, typename Result,
+          typename BinaryOp = std::plus<>>
+Result parallel_reduce(span<T, Extent> v, Result init, BinaryOp op = BinaryOp(),
+                       thread_pool &pool = thread_pool::global()) {
+  return lib::parallel_reduce(v.begin(), v.end(), std::move(init), op, pool);
+}
+
+template <typename T, std::size_t Extent, typename BinaryOp = std::plus<>>
+void inclusive_scan(span<T, Extent> v, BinaryOp op = BinaryOp()) {
+  lib::inclusive_scan(v.begin(), v.end(), v.begin(), op);
+}
+
+template <typename T, std::size_t Extent, typename BinaryOp = std::plus<>>
+void parallel_inclusive_scan(span<T, Extent> v, BinaryOp op = BinaryOp(),
+                             thread_pool &pool = thread_pool::global()) {
+  lib::parallel_inclusive_scan(v.begin(), v.end(), v.begin(), op, pool);
+}
+
+template <typename T, typename Compare = std::less<>>
+void sort(strided_view<T> v, Compare comp = Compare()) {
+  lib::sort(v.begin(), v.end(), comp);
+}
+
+template <typename T, typename Compare = std::less<>>
+void parallel_sort(strided_view<T> v, Compare comp = Compare(),
+                   thread_pool &pool = thread_pool::global()) {
+  lib::parallel_sort(v.begin(), v.end(), comp, pool);
+}
+
+template <typename T, typename UnaryOp>
+void transform(strided_view<T> v, UnaryOp op) {
+  lib::transform(v.begin(), v.end(), v.begin(), op);
+}
+
+template <typename T, typename UnaryOp>
+void parallel_transform(strided_view<T> v, UnaryOp op,
+                        thread_pool &pool = thread_pool::global()) {
+  lib::parallel_transform(v.begin(), v.end(), v.begin(), op, pool);
+}
+
+template <typename T, typename Function>
+void for_each(strided_view<T> v, Function f) {
+  lib::for_each(v.begin(), v.end(), f);
+}
+
+template <typename T, typename Function>
+void parallel_for_each(strided_view<T> v, Function f,
+                       thread_pool &pool = thread_pool::global()) {
+  lib::parallel_for_each(v.begin(), v.end(), f, pool);
+}
+
+template <typename T, typename Result, typename BinaryOp = std::plus<>>
+Result reduce(strided_view<T> v, Result init, BinaryOp op = BinaryOp()) {
+  return lib::reduce(v.begin(), v.end(), std::move(init), op);
+}
+
+template <typename T, typename Result, typename BinaryOp = std::plus<>>
+Result parallel_reduce(strided_view<T> v, Result init, BinaryOp op = BinaryOp(),
+                       thread_pool &pool = thread_pool::global()) {
+  return lib::parallel_reduce(v.begin(), v.end(), std::move(init), op, pool);
+}
+
+template <typename T, typename BinaryOp = std::plus<>>
+void inclusive_scan(strided_view<T> v, BinaryOp op = BinaryOp()) {
+  lib::inclusive_scan(v.begin(), v.end(), v.begin(), op);
+}
+
+template <typename T, typename BinaryOp = std::plus<>>
+void parallel_inclusive_scan(strided_view<T> v, BinaryOp op = BinaryOp(),
+                             thread_pool &pool = thread_pool::global()) {
+  lib::parallel_inclusive_scan(v.begin(), v.end(), v.begin(), op, pool);
+}
+}  // namespace lib
+
+#endif  // LIB_ALGORITHM_H_
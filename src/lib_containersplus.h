@@ -1,7 +1,18 @@
 #ifndef LIB_CONTAINERSPLUS_H
 #define LIB_CONTAINERSPLUS_H
 
+#include "lib_algorithm.h"
 #include "lib_array.h"
+#include "lib_deque.h"
+#include "lib_dynamic_bitset.h"
+#include "lib_interval.h"
 #include "lib_multiset.h"
+#include "lib_packed_int_vector.h"
+#include "lib_simd.h"
+#include "lib_small_map.h"
+#include "lib_small_vector.h"
+#include "lib_soa_vector.h"
+#include "lib_span.h"
+#include "lib_static_vector.h"
 
 #endif  // LIB_CONTAINERSPLUS_H
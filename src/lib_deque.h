@@ -0,0 +1,498 @@
+#ifndef LIB_DEQUE_H_
+#define LIB_DEQUE_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace lib {
+// Double-ended queue made of fixed-size blocks of raw storage and a map of
+// pointers to them. Growing at either end fills or adds a block, and when
+// the map runs out of slots only the block pointers are copied, so elements
+// never move: references and pointers to elements stay valid until the
+// element is removed. Iterators are invalidated by any insertion, as the
+// map may be replaced. Each end keeps at most one empty block around, so
+// alternating push and pop across a block boundary does not allocate.
+template <typename T>
+class deque {
+  // Blocks of about 4 KiB, at least 16 elements, as a power of two so that
+  // locating an element is a shift and a mask.
+  static constexpr std::size_t blockSize() {
+    std::size_t target = std::max<std::size_t>(16, 4096 / sizeof(T));
+    std::size_t size = 1;
+    while (size * 2 <= target) size *= 2;
+    return size;
+  }
+  static constexpr std::size_t kBlockSize = blockSize();
+  static constexpr std::size_t kMinMapSize = 8;
+
+  template <bool Const>
+  class Iterator;
+
+ public:
+  using value_type = T;
+  using reference = T &;
+  using const_reference = const T &;
+  using iterator = Iterator<false>;
+  using const_iterator = Iterator<true>;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+
+  deque() noexcept;
+  explicit deque(size_type n);
+  deque(std::initializer_list<value_type> const &items);
+  deque(const deque &d);
+  deque(deque &&d) noexcept;
+  ~deque();
+  deque &operator=(deque &&d) noexcept;
+
+  reference at(size_type pos);
+  const_reference at(size_type pos) const;
+  reference operator[](size_type pos) { return *slot(start_ + pos); }
+  const_reference operator[](size_type pos) const {
+    return *slot(start_ + pos);
+  }
+  reference front() { return *slot(start_); }
+  const_reference front() const { return *slot(start_); }
+  reference back() { return *slot(start_ + size_ - 1); }
+  const_reference back() const { return *slot(start_ + size_ - 1); }
+
+  iterator begin() noexcept { return iterator(map_, start_); }
+  iterator end() noexcept { return iterator(map_, start_ + size_); }
+  const_iterator begin() const noexcept {
+    return const_iterator(map_, start_);
+  }
+  const_iterator end() const noexcept {
+    return const_iterator(map_, start_ + size_);
+  }
+
+  bool empty() const noexcept { return size_ == 0; }
+  size_type size() const noexcept { return size_; }
+  size_type max_size() const noexcept;
+  // Releases the spare blocks kept at either end.
+  void shrink_to_fit() noexcept;
+
+  // Destroys the elements and releases their blocks, keeping the map.
+  void clear() noexcept;
+  void push_back(const_reference value) { emplace_back(value); }
+  void push_back(value_type &&value) { emplace_back(std::move(value)); }
+  void push_front(const_reference value) { emplace_front(value); }
+  void push_front(value_type &&value) { emplace_front(std::move(value)); }
+  void pop_back();
+  void pop_front();
+  void swap(deque &other) noexcept;
+
+  template <typename... Args>
+  reference emplace_back(Args &&...args);
+  template <typename... Args>
+  reference emplace_front(Args &&...args);
+
+  // Appends args in order.
+  template <typename... Args>
+  void insert_many_back(Args &&...args);
+  // Prepends args so that they end up at the front in the order given.
+  template <typename... Args>
+  void insert_many_front(Args &&...args);
+
+ private:
+  // Element positions are indices into the sequence of blocks the map
+  // points to: position i lives in block i / kBlockSize.
+  T *slot(size_type position) const noexcept {
+    return map_[position / kBlockSize] + position % kBlockSize;
+  }
+
+  void reserveFront(size_type n);
+  void reserveBack(size_type n);
+  void remap(size_type front, size_type back);
+  void allocateBlocks(size_type first_position, size_type last_position);
+  void releaseBlock(size_type block) noexcept;
+  void destroyAll() noexcept;
+
+  static T *allocateBlock();
+  static void releaseStorage(T *block) noexcept;
+
+  T **map_;
+  size_type map_size_;
+  size_type start_;
+  size_type size_;
+};
+
+// Random access iterator holding the map and a position, so that stepping
+// across a block boundary costs nothing extra.
+template <typename T>
+template <bool Const>
+class deque<T>::Iterator {
+ public:
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = T;
+  using difference_type = std::ptrdiff_t;
+  using pointer = std::conditional_t<Const, const T *, T *>;
+  using reference = std::conditional_t<Const, const T &, T &>;
+
+  Iterator() noexcept : map_(nullptr), position_(0) {}
+  template <bool OtherConst, typename = std::enable_if_t<Const && !OtherConst>>
+  Iterator(const Iterator<OtherConst> &other) noexcept
+      : map_(other.map_), position_(other.position_) {}
+
+  reference operator*() const {
+    return map_[position_ / kBlockSize][position_ % kBlockSize];
+  }
+  pointer operator->() const { return &**this; }
+  reference operator[](difference_type n) const { return *(*this + n); }
+
+  Iterator &operator++() noexcept {
+    ++position_;
+    return *this;
+  }
+  Iterator operator++(int) noexcept { return Iterator(map_, position_++); }
+  Iterator &operator--() noexcept {
+    --position_;
+    return *this;
+  }
+  Iterator operator--(int) noexcept { return Iterator(map_, position_--); }
+  Iterator &operator+=(difference_type n) noexcept {
+    position_ += n;
+    return *this;
+  }
+  Iterator &operator-=(difference_type n) noexcept {
+    position_ -= n;
+    return *this;
+  }
+  friend Iterator operator+(Iterator it, difference_type n) noexcept {
+    return it += n;
+  }
+  friend Iterator operator+(difference_type n, Iterator it) noexcept {
+    return it += n;
+  }
+  friend Iterator operator-(Iterator it, difference_type n) noexcept {
+    return it -= n;
+  }
+  friend difference_type operator-(const Iterator &a,
+                                   const Iterator &b) noexcept {
+    return difference_type(a.position_) - difference_type(b.position_);
+  }
+
+  friend bool operator==(const Iterator &a, const Iterator &b) noexcept {
+    return a.position_ == b.position_;
+  }
+  friend bool operator!=(const Iterator &a, const Iterator &b) noexcept {
+    return a.position_ != b.position_;
+  }
+  friend bool operator<(const Iterator &a, const Iterator &b) noexcept {
+    return a.position_ < b.position_;
+  }
+  friend bool operator>(const Iterator &a, const Iterator &b) noexcept {
+    return a.position_ > b.position_;
+  }
+  friend bool operator<=(const Iterator &a, const Iterator &b) noexcept {
+    return a.position_ <= b.position_;
+  }
+  friend bool operator>=(const Iterator &a, const Iterator &b) noexcept {
+    return a.position_ >= b.position_;
+  }
+
+ private:
+  friend class deque;
+  template <bool>
+  friend class Iterator;
+
+  Iterator(T *const *map, size_type position) noexcept
+      : map_(map), position_(position) {}
+
+  T *const *map_;
+  size_type position_;
+};
+
+template <typename T>
+deque<T>::deque() noexcept
+    : map_(nullptr), map_size_(0), start_(0), size_(0) {}
+
+template <typename T>
+deque<T>::deque(size_type n) : deque() {
+  try {
+    reserveBack(n);
+    for (; size_ < n; ++size_) new (slot(start_ + size_)) value_type();
+  } catch (...) {
+    destroyAll();
+    throw;
+  }
+}
+
+template <typename T>
+deque<T>::deque(std::initializer_list<value_type> const &items) : deque() {
+  try {
+    reserveBack(items.size());
+    for (const auto &item : items) {
+      new (slot(start_ + size_)) value_type(item);
+      ++size_;
+    }
+  } catch (...) {
+    destroyAll();
+    throw;
+  }
+}
+
+template <typename T>
+deque<T>::deque(const deque &d) : deque() {
+  try {
+    reserveBack(d.size_);
+    for (const auto &item : d) {
+      new (slot(start_ + size_)) value_type(item);
+      ++size_;
+    }
+  } catch (...) {
+    destroyAll();
+    throw;
+  }
+}
+
+template <typename T>
+deque<T>::deque(deque &&d) noexcept
+    : map_(std::exchange(d.map_, nullptr)),
+      map_size_(std::exchange(d.map_size_, 0)),
+      start_(std::exchange(d.start_, 0)),
+      size_(std::exchange(d.size_, 0)) {}
+
+template <typename T>
+deque<T>::~deque() {
+  destroyAll();
+}
+
+template <typename T>
+deque<T> &deque<T>::operator=(deque &&d) noexcept {
+  if (this != &d) {
+    destroyAll();
+    map_ = std::exchange(d.map_, nullptr);
+    map_size_ = std::exchange(d.map_size_, 0);
+    start_ = std::exchange(d.start_, 0);
+    size_ = std::exchange(d.size_, 0);
+  }
+  return *this;
+}
+
+template <typename T>
+typename deque<T>::reference deque<T>::at(size_type pos) {
+  if (pos >= size_) throw std::out_of_range("Index out of range");
+  return (*this)[pos];
+}
+
+template <typename T>
+typename deque<T>::const_reference deque<T>::at(size_type pos) const {
+  if (pos >= size_) throw std::out_of_range("Index out of range");
+  return (*this)[pos];
+}
+
+template <typename T>
+typename deque<T>::size_type deque<T>::max_size() const noexcept {
+  return std::numeric_limits<difference_type>::max() / sizeof(value_type);
+}
+
+template <typename T>
+void deque<T>::shrink_to_fit() noexcept {
+  size_type first = start_ / kBlockSize;
+  size_type last = size_ == 0 ? first : (start_ + size_ - 1) / kBlockSize;
+  for (size_type block = 0; block < map_size_; ++block) {
+    if (block < first || block > last || size_ == 0) releaseBlock(block);
+  }
+}
+
+template <typename T>
+void deque<T>::clear() noexcept {
+  for (size_type i = 0; i < size_; ++i) slot(start_ + i)->~value_type();
+  size_ = 0;
+  for (size_type block = 0; block < map_size_; ++block) releaseBlock(block);
+}
+
+template <typename T>
+void deque<T>::pop_back() {
+  --size_;
+  size_type end = start_ + size_;
+  slot(end)->~value_type();
+  // Leaving a block empty frees the spare one behind it.
+  if (end % kBlockSize == 0 && end / kBlockSize + 1 < map_size_) {
+    releaseBlock(end / kBlockSize + 1);
+  }
+}
+
+template <typename T>
+void deque<T>::pop_front() {
+  slot(start_)->~value_type();
+  ++start_;
+  --size_;
+  if (start_ % kBlockSize == 0 && start_ / kBlockSize >= 2) {
+    releaseBlock(start_ / kBlockSize - 2);
+  }
+}
+
+template <typename T>
+void deque<T>::swap(deque &other) noexcept {
+  std::swap(map_, other.map_);
+  std::swap(map_size_, other.map_size_);
+  std::swap(start_, other.start_);
+  std::swap(size_, other.size_);
+}
+
+template <typename T>
+template <typename... Args>
+typename deque<T>::reference deque<T>::emplace_back(Args &&...args) {
+  reserveBack(1);
+  T *p = new (slot(start_ + size_)) value_type(std::forward<Args>(args)...);
+  ++size_;
+  return *p;
+}
+
+template <typename T>
+template <typename... Args>
+typename deque<T>::reference deque<T>::emplace_front(Args &&...args) {
+  reserveFront(1);
+  T *p = new (slot(start_ - 1)) value_type(std::forward<Args>(args)...);
+  --start_;
+  ++size_;
+  return *p;
+}
+
+// The new elements are built in place past the end and only become part of
+// the deque once all of them exist.
+template <typename T>
+template <typename... Args>
+void deque<T>::insert_many_back(Args &&...args) {
+  constexpr size_type count = sizeof...(args);
+  reserveBack(count);
+  size_type end = start_ + size_;
+  size_type built = 0;
+  try {
+    ((new (slot(end + built)) value_type(std::forward<Args>(args)), ++built),
+     ...);
+  } catch (...) {
+    for (size_type i = 0; i < built; ++i) slot(end + i)->~value_type();
+    throw;
+  }
+  size_ += count;
+}
+
+template <typename T>
+template <typename... Args>
+void deque<T>::insert_many_front(Args &&...args) {
+  constexpr size_type count = sizeof...(args);
+  reserveFront(count);
+  size_type built = 0;
+  try {
+    ((new (slot(start_ - count + built)) value_type(std::forward<Args>(args)),
+      ++built),
+     ...);
+  } catch (...) {
+    for (size_type i = 0; i < built; ++i) {
+      slot(start_ - count + i)->~value_type();
+    }
+    throw;
+  }
+  start_ -= count;
+  size_ += count;
+}
+
+// Makes sure the n positions before start_ exist and have blocks.
+template <typename T>
+void deque<T>::reserveFront(size_type n) {
+  if (n == 0) return;
+  if (n > max_size() - size_) throw std::length_error("deque too long");
+  if (map_ == nullptr || start_ < n) remap(n, 0);
+  allocateBlocks(start_ - n, start_ - 1);
+}
+
+// Makes sure the n positions after the last element exist and have blocks.
+template <typename T>
+void deque<T>::reserveBack(size_type n) {
+  if (n == 0) return;
+  if (n > max_size() - size_) throw std::length_error("deque too long");
+  if (map_ == nullptr || map_size_ * kBlockSize - (start_ + size_) < n) {
+    remap(0, n);
+  }
+  allocateBlocks(start_ + size_, start_ + size_ + n - 1);
+}
+
+// Replaces the map by one with room for front more positions before the
+// elements and back more after them, with the remaining slots split evenly
+// between both ends. The map at least doubles when it grows, so pushing at
+// one end costs amortized O(1) pointer copies. Spare blocks are released.
+template <typename T>
+void deque<T>::remap(size_type front, size_type back) {
+  size_type first = start_ / kBlockSize;
+  size_type used =
+      size_ == 0 ? 0 : (start_ + size_ - 1) / kBlockSize - first + 1;
+  size_type front_blocks = (front + kBlockSize - 1) / kBlockSize;
+  size_type back_blocks = (back + kBlockSize - 1) / kBlockSize;
+  size_type needed = used + front_blocks + back_blocks + 1;
+  size_type map_size = map_size_;
+  if (needed * 2 > map_size) {
+    map_size = std::max({kMinMapSize, map_size_ * 2, needed * 2});
+  }
+
+  T **map = new T *[map_size]();
+  size_type new_first = front_blocks + (map_size - needed) / 2;
+  for (size_type block = 0; block < map_size_; ++block) {
+    if (block >= first && block < first + used) {
+      map[new_first + block - first] = map_[block];
+    } else {
+      releaseStorage(map_[block]);
+    }
+  }
+  delete[] map_;
+  map_ = map;
+  map_size_ = map_size;
+  start_ = new_first * kBlockSize + (size_ == 0 ? 0 : start_ % kBlockSize);
+}
+
+// Allocates the missing blocks holding positions [first, last].
+template <typename T>
+void deque<T>::allocateBlocks(size_type first_position,
+                              size_type last_position) {
+  for (size_type block = first_position / kBlockSize;
+       block <= last_position / kBlockSize; ++block) {
+    if (map_[block] == nullptr) map_[block] = allocateBlock();
+  }
+}
+
+template <typename T>
+void deque<T>::releaseBlock(size_type block) noexcept {
+  releaseStorage(map_[block]);
+  map_[block] = nullptr;
+}
+
+template <typename T>
+void deque<T>::destroyAll() noexcept {
+  clear();
+  delete[] map_;
+  map_ = nullptr;
+  map_size_ = 0;
+  start_ = 0;
+}
+
+template <typename T>
+T *deque<T>::allocateBlock() {
+  std::size_t bytes = kBlockSize * sizeof(T);
+  if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+    return static_cast<T *>(
+        ::operator new(bytes, std::align_val_t(alignof(T))));
+  } else {
+    return static_cast<T *>(::operator new(bytes));
+  }
+}
+
+template <typename T>
+void deque<T>::releaseStorage(T *block) noexcept {
+  if (block == nullptr) return;
+  if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__) {
+    ::operator delete(block, std::align_val_t(alignof(T)));
+  } else {
+    ::operator delete(block);
+  }
+}
+}  // namespace lib
+
+#endif  // LIB_DEQUE_H_
@@ -0,0 +1,364 @@
+#ifndef LIB_DYNAMIC_BITSET_H_
+#define LIB_DYNAMIC_BITSET_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+namespace lib {
+// Resizable sequence of bits packed 64 to a 64-bit word, one eighth of the
+// memory of a bool per flag. Bits past size() in the last word are always
+// zero, so count() and comparisons work on whole words. The bitwise
+// operators combine two bitsets of the same size word by word in loops the
+// compiler vectorizes, and throw std::invalid_argument on a size mismatch.
+//
+// test(), set(), reset() and flip() do not check pos; at() does.
+class dynamic_bitset {
+ public:
+  using word_type = std::uint64_t;
+  using size_type = std::size_t;
+
+  static constexpr size_type kWordBits = 64;
+  // Returned by find_first() and find_next() when no set bit is left.
+  static constexpr size_type npos = static_cast<size_type>(-1);
+
+  dynamic_bitset() noexcept;
+  explicit dynamic_bitset(size_type n, bool value = false);
+  dynamic_bitset(const dynamic_bitset &other);
+  dynamic_bitset(dynamic_bitset &&other) noexcept;
+  ~dynamic_bitset();
+  dynamic_bitset &operator=(dynamic_bitset &&other) noexcept;
+
+  bool test(size_type pos) const noexcept {
+    return (words_[pos / kWordBits] >> (pos % kWordBits)) & 1;
+  }
+  bool operator[](size_type pos) const noexcept { return test(pos); }
+  bool at(size_type pos) const;
+  void set(size_type pos) noexcept {
+    words_[pos / kWordBits] |= word_type(1) << (pos % kWordBits);
+  }
+  void set(size_type pos, bool value) noexcept {
+    value ? set(pos) : reset(pos);
+  }
+  void reset(size_type pos) noexcept {
+    words_[pos / kWordBits] &= ~(word_type(1) << (pos % kWordBits));
+  }
+  void flip(size_type pos) noexcept {
+    words_[pos / kWordBits] ^= word_type(1) << (pos % kWordBits);
+  }
+  // Whole-bitset forms.
+  void set() noexcept;
+  void reset() noexcept;
+  void flip() noexcept;
+
+  bool empty() const noexcept { return size_ == 0; }
+  size_type size() const noexcept { return size_; }
+  size_type word_count() const noexcept { return wordsFor(size_); }
+  size_type capacity() const noexcept { return capacity_ * kWordBits; }
+  const word_type *data() const noexcept { return words_; }
+  word_type *data() noexcept { return words_; }
+
+  void reserve(size_type n);
+  void resize(size_type n, bool value = false);
+  void push_back(bool value);
+  void clear() noexcept { size_ = 0; }
+
+  // Number of set bits, one hardware popcount per word.
+  size_type count() const noexcept;
+  bool any() const noexcept;
+  bool none() const noexcept { return !any(); }
+  bool all() const noexcept;
+  size_type find_first() const noexcept;
+  // First set bit after pos.
+  size_type find_next(size_type pos) const noexcept;
+
+  dynamic_bitset &operator&=(const dynamic_bitset &other);
+  dynamic_bitset &operator|=(const dynamic_bitset &other);
+  dynamic_bitset &operator^=(const dynamic_bitset &other);
+  // Clears the bits set in other: *this &= ~other without the temporary.
+  dynamic_bitset &and_not(const dynamic_bitset &other);
+
+  friend bool operator==(const dynamic_bitset &a, const dynamic_bitset &b);
+  friend bool operator!=(const dynamic_bitset &a, const dynamic_bitset &b) {
+    return !(a == b);
+  }
+
+ private:
+  static size_type wordsFor(size_type bits) noexcept {
+    return (bits + kWordBits - 1) / kWordBits;
+  }
+  static size_type popcount(word_type word) noexcept;
+  static size_type lowestBit(word_type word) noexcept;
+
+  template <typename Combine>
+  dynamic_bitset &combine(const dynamic_bitset &other, Combine op);
+  void clearUnusedBits() noexcept;
+  void reallocate(size_type words);
+
+  static word_type *allocate(size_type words);
+  static void release(word_type *words) noexcept;
+
+  word_type *words_;
+  size_type size_;
+  size_type capacity_;
+};
+
+inline dynamic_bitset::dynamic_bitset() noexcept
+    : words_(nullptr), size_(0), capacity_(0) {}
+
+inline dynamic_bitset::dynamic_bitset(size_type n, bool value)
+    : dynamic_bitset() {
+  resize(n, value);
+}
+
+inline dynamic_bitset::dynamic_bitset(const dynamic_bitset &other)
+    : dynamic_bitset() {
+  reallocate(other.word_count());
+  if (other.size_ > 0) {
+    std::memcpy(words_, other.words_, other.word_count() * sizeof(word_type));
+  }
+  size_ = other.size_;
+}
+
+inline dynamic_bitset::dynamic_bitset(dynamic_bitset &&other) noexcept
+    : words_(std::exchange(other.words_, nullptr)),
+      size_(std::exchange(other.size_, 0)),
+      capacity_(std::exchange(other.capacity_, 0)) {}
+
+inline dynamic_bitset::~dynamic_bitset() { release(words_); }
+
+inline dynamic_bitset &dynamic_bitset::operator=(
+    dynamic_bitset &&other) noexcept {
+  if (this != &other) {
+    release(words_);
+    words_ = std::exchange(other.words_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+    capacity_ = std::exchange(other.capacity_, 0);
+  }
+  return *this;
+}
+
+inline bool dynamic_bitset::at(size_type pos) const {
+  if (pos >= size_) throw std::out_of_range("Index out of range");
+  return test(pos);
+}
+
+inline void dynamic_bitset::set() noexcept {
+  std::fill(words_, words_ + word_count(), ~word_type(0));
+  clearUnusedBits();
+}
+
+inline void dynamic_bitset::reset() noexcept {
+  std::fill(words_, words_ + word_count(), word_type(0));
+}
+
+inline void dynamic_bitset::flip() noexcept {
+  for (size_type i = 0, n = word_count(); i < n; ++i) words_[i] = ~words_[i];
+  clearUnusedBits();
+}
+
+inline void dynamic_bitset::reserve(size_type n) {
+  if (wordsFor(n) > capacity_) reallocate(wordsFor(n));
+}
+
+// Bits past size() are already zero, so growing only has to fill them when
+// value is true and to zero the words it adds.
+inline void dynamic_bitset::resize(size_type n, bool value) {
+  size_type words = word_count();
+  if (wordsFor(n) > capacity_) {
+    reallocate(std::max(wordsFor(n), capacity_ * 2));
+  }
+  if (wordsFor(n) > words) {
+    std::fill(words_ + words, words_ + wordsFor(n), word_type(0));
+  }
+  if (value) {
+    for (size_type pos = size_; pos < n && pos % kWordBits != 0; ++pos) {
+      set(pos);
+    }
+    size_type first_full = wordsFor(size_);
+    if (first_full < wordsFor(n)) {
+      std::fill(words_ + first_full, words_ + wordsFor(n), ~word_type(0));
+    }
+  }
+  size_ = n;
+  clearUnusedBits();
+}
+
+inline void dynamic_bitset::push_back(bool value) {
+  if (size_ == capacity_ * kWordBits) {
+    reallocate(std::max<size_type>(1, capacity_ * 2));
+  }
+  if (size_ % kWordBits == 0) words_[size_ / kWordBits] = 0;
+  ++size_;
+  if (value) set(size_ - 1);
+}
+
+inline dynamic_bitset::size_type dynamic_bitset::count() const noexcept {
+  size_type total = 0;
+  for (size_type i = 0, n = word_count(); i < n; ++i) {
+    total += popcount(words_[i]);
+  }
+  return total;
+}
+
+inline bool dynamic_bitset::any() const noexcept {
+  for (size_type i = 0, n = word_count(); i < n; ++i) {
+    if (words_[i] != 0) return true;
+  }
+  return false;
+}
+
+inline bool dynamic_bitset::all() const noexcept {
+  size_type full = size_ / kWordBits;
+  for (size_type i = 0; i < full; ++i) {
+    if (words_[i] != ~word_type(0)) return false;
+  }
+  size_type tail = size_ % kWordBits;
+  return tail == 0 || words_[full] == (word_type(1) << tail) - 1;
+}
+
+inline dynamic_bitset::size_type dynamic_bitset::find_first() const noexcept {
+  for (size_type i = 0, n = word_count(); i < n; ++i) {
+    if (words_[i] != 0) return i * kWordBits + lowestBit(words_[i]);
+  }
+  return npos;
+}
+
+inline dynamic_bitset::size_type dynamic_bitset::find_next(
+    size_type pos) const noexcept {
+  if (pos >= size_ || ++pos == size_) return npos;
+  size_type i = pos / kWordBits;
+  word_type word = words_[i] & (~word_type(0) << (pos % kWordBits));
+  for (size_type n = word_count();;) {
+    if (word != 0) return i * kWordBits + lowestBit(word);
+    if (++i == n) return npos;
+    word = words_[i];
+  }
+}
+
+inline dynamic_bitset &dynamic_bitset::operator&=(
+    const dynamic_bitset &other) {
+  return combine(other, [](word_type a, word_type b) { return a & b; });
+}
+
+inline dynamic_bitset &dynamic_bitset::operator|=(
+    const dynamic_bitset &other) {
+  return combine(other, [](word_type a, word_type b) { return a | b; });
+}
+
+inline dynamic_bitset &dynamic_bitset::operator^=(
+    const dynamic_bitset &other) {
+  return combine(other, [](word_type a, word_type b) { return a ^ b; });
+}
+
+inline dynamic_bitset &dynamic_bitset::and_not(const dynamic_bitset &other) {
+  return combine(other, [](word_type a, word_type b) { return a & ~b; });
+}
+
+inline bool operator==(const dynamic_bitset &a, const dynamic_bitset &b) {
+  return a.size_ == b.size_ &&
+         std::equal(a.words_, a.words_ + a.word_count(), b.words_);
+}
+
+inline dynamic_bitset operator&(dynamic_bitset a, const dynamic_bitset &b) {
+  return std::move(a &= b);
+}
+
+inline dynamic_bitset operator|(dynamic_bitset a, const dynamic_bitset &b) {
+  return std::move(a |= b);
+}
+
+inline dynamic_bitset operator^(dynamic_bitset a, const dynamic_bitset &b) {
+  return std::move(a ^= b);
+}
+
+inline dynamic_bitset::size_type dynamic_bitset::popcount(
+    word_type word) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+  return static_cast<size_type>(__builtin_popcountll(word));
+#else
+  word = word - ((word >> 1) & 0x5555555555555555ULL);
+  word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+  word = (word + (word >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+  return static_cast<size_type>((word * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+// Index of the lowest set bit of a non-zero word.
+inline dynamic_bitset::size_type dynamic_bitset::lowestBit(
+    word_type word) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+  return static_cast<size_type>(__builtin_ctzll(word));
+#else
+  return popcount((word & (~word + 1)) - 1);
+#endif
+}
+
+// Words are combined eight at a time: at -O2 GCC only vectorizes loops
+// whose trip count needs no scalar epilogue, but it does turn the straight
+// run of eight independent words into two 256-bit (or one 512-bit)
+// operations. The restrict-qualified pointers promise the arrays do not
+// overlap; x ^= x goes through the plain loop.
+template <typename Combine>
+dynamic_bitset &dynamic_bitset::combine(const dynamic_bitset &other,
+                                        Combine op) {
+  if (size_ != other.size_) {
+    throw std::invalid_argument("dynamic_bitset sizes differ");
+  }
+  size_type n = word_count();
+  size_type i = 0;
+  if (this != &other) {
+    word_type *__restrict to = words_;
+    const word_type *__restrict from = other.words_;
+    for (; i + 8 <= n; i += 8) {
+      to[i] = op(to[i], from[i]);
+      to[i + 1] = op(to[i + 1], from[i + 1]);
+      to[i + 2] = op(to[i + 2], from[i + 2]);
+      to[i + 3] = op(to[i + 3], from[i + 3]);
+      to[i + 4] = op(to[i + 4], from[i + 4]);
+      to[i + 5] = op(to[i + 5], from[i + 5]);
+      to[i + 6] = op(to[i + 6], from[i + 6]);
+      to[i + 7] = op(to[i + 7], from[i + 7]);
+    }
+  }
+  for (; i < n; ++i) words_[i] = op(words_[i], other.words_[i]);
+  return *this;
+}
+
+inline void dynamic_bitset::clearUnusedBits() noexcept {
+  if (size_ % kWordBits != 0) {
+    words_[size_ / kWordBits] &= (word_type(1) << (size_ % kWordBits)) - 1;
+  }
+}
+
+inline void dynamic_bitset::reallocate(size_type words) {
+  word_type *fresh = allocate(words);
+  if (size_ > 0) {
+    std::memcpy(fresh, words_, word_count() * sizeof(word_type));
+  }
+  release(words_);
+  words_ = fresh;
+  capacity_ = words;
+}
+
+// Words are cache-line aligned so vector loads never split a line.
+inline dynamic_bitset::word_type *dynamic_bitset::allocate(size_type words) {
+  if (words == 0) return nullptr;
+  if (words > std::numeric_limits<std::ptrdiff_t>::max() / sizeof(word_type)) {
+    throw std::length_error("dynamic_bitset too long");
+  }
+  return static_cast<word_type *>(
+      ::operator new(words * sizeof(word_type), std::align_val_t(64)));
+}
+
+inline void dynamic_bitset::release(word_type *words) noexcept {
+  if (words != nullptr) ::operator delete(words, std::align_val_t(64));
+}
+}  // namespace lib
+
+#endif  // LIB_DYNAMIC_BITSET_H_
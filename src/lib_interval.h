@@ -0,0 +1,236 @@
+#ifndef LIB_INTERVAL_H_
+#define LIB_INTERVAL_H_
+
+#include "lib_tree.h"
+
+namespace lib {
+// Half-open interval [start, end).
+template <typename T>
+struct interval {
+  T start;
+  T end;
+
+  bool contains(const T& point) const {
+    return !(point < start) && point < end;
+  }
+
+  bool overlaps(const T& lo, const T& hi) const {
+    return start < hi && lo < end;
+  }
+};
+
+template <typename T>
+bool operator<(const interval<T>& a, const interval<T>& b) {
+  if (a.start < b.start) return true;
+  if (b.start < a.start) return false;
+  return a.end < b.end;
+}
+
+template <typename T>
+bool operator==(const interval<T>& a, const interval<T>& b) {
+  return !(a < b) && !(b < a);
+}
+
+template <typename T>
+bool operator!=(const interval<T>& a, const interval<T>& b) {
+  return !(a == b);
+}
+
+// Red-black tree of values keyed by intervals (ordered by start, then end)
+// in which every node caches the largest end of its subtree. Overlap and
+// stabbing queries never enter a subtree whose largest end is at or before
+// the query, nor walk past the first interval starting after it.
+// KeyOf::key(value) returns the interval of a stored value. Equal intervals
+// are all kept, next to each other in insertion order, as in a multiset:
+// queries report each of them, find() returns one of them, and erase()
+// removes the one its iterator points to.
+template <typename Value, typename T, typename KeyOf>
+class IntervalTree {
+  // Compares stored values and bare intervals in any combination.
+  struct Compare {
+    template <typename A, typename B>
+    bool operator()(const A& a, const B& b) const {
+      return keyOf(a) < keyOf(b);
+    }
+
+    static const interval<T>& keyOf(const interval<T>& key) { return key; }
+
+    template <typename V>
+    static const interval<T>& keyOf(const V& value) {
+      return KeyOf::key(value);
+    }
+  };
+
+  struct MaxEnd : max_aggregate<T> {
+    static T project(const Value& value) { return KeyOf::key(value).end; }
+  };
+
+  using BinaryTree = RBTree<Value, Compare, MaxEnd>;
+
+ public:
+  using interval_type = interval<T>;
+  using value_type = Value;
+  using const_reference = const value_type&;
+  using iterator = typename BinaryTree::iterator;
+  using const_iterator = typename BinaryTree::const_iterator;
+  using size_type = std::size_t;
+
+  iterator begin() noexcept { return rbtree_.begin(); }
+  iterator end() noexcept { return rbtree_.end(); }
+  const_iterator begin() const noexcept { return rbtree_.begin(); }
+  const_iterator end() const noexcept { return rbtree_.end(); }
+
+  bool empty() const noexcept { return rbtree_.empty(); }
+  size_type size() const noexcept { return rbtree_.size(); }
+  size_type max_size() const noexcept { return rbtree_.max_size(); }
+
+  void clear() { rbtree_.clear(); }
+  void erase(iterator pos) { rbtree_.erase(pos); }
+
+  iterator find(const interval_type& key) noexcept {
+    return rbtree_.findEquivalent(key);
+  }
+
+  const_iterator find(const interval_type& key) const noexcept {
+    return rbtree_.findEquivalent(key);
+  }
+
+  bool contains(const interval_type& key) const noexcept {
+    return find(key) != end();
+  }
+
+  // Stored intervals overlapping [lo, hi), in order.
+  vector<iterator> overlapping(const T& lo, const T& hi) {
+    return collect_<iterator>(rbtree_, lo, hi);
+  }
+
+  vector<const_iterator> overlapping(const T& lo, const T& hi) const {
+    return collect_<const_iterator>(rbtree_, lo, hi);
+  }
+
+  // Stored intervals containing point, in order.
+  vector<iterator> stabbing(const T& point) {
+    return collectStabbing_<iterator>(rbtree_, point);
+  }
+
+  vector<const_iterator> stabbing(const T& point) const {
+    return collectStabbing_<const_iterator>(rbtree_, point);
+  }
+
+  // Largest end among the stored intervals.
+  T max_end() const { return rbtree_.aggregate(); }
+
+ protected:
+  template <typename It, typename Tree>
+  static vector<It> collect_(Tree& tree, const T& lo, const T& hi) {
+    vector<It> result;
+    tree.searchAugmented([&lo](const T& max_end) { return lo < max_end; },
+                         [&hi](const_reference value) {
+                           return KeyOf::key(value).start < hi;
+                         },
+                         [&](It it) {
+                           if (lo < KeyOf::key(*it).end) result.push_back(it);
+                         });
+    return result;
+  }
+
+  template <typename It, typename Tree>
+  static vector<It> collectStabbing_(Tree& tree, const T& point) {
+    vector<It> result;
+    tree.searchAugmented(
+        [&point](const T& max_end) { return point < max_end; },
+        [&point](const_reference value) {
+          return !(point < KeyOf::key(value).start);
+        },
+        [&](It it) {
+          if (point < KeyOf::key(*it).end) result.push_back(it);
+        });
+    return result;
+  }
+
+  BinaryTree rbtree_;
+};
+
+template <typename T>
+struct IntervalSetKey {
+  static const interval<T>& key(const interval<T>& value) { return value; }
+};
+
+template <typename T>
+class interval_set
+    : public IntervalTree<interval<T>, T, IntervalSetKey<T>> {
+  using Base = IntervalTree<interval<T>, T, IntervalSetKey<T>>;
+
+ public:
+  using typename Base::interval_type;
+  using typename Base::iterator;
+  using typename Base::value_type;
+
+  interval_set() = default;
+
+  interval_set(std::initializer_list<value_type> const& items) {
+    for (const auto& item : items) insert(item);
+  }
+
+  iterator insert(const interval_type& value) {
+    return this->rbtree_.insertDuplicate(value);
+  }
+
+  iterator insert(const T& start, const T& end) {
+    return insert(interval_type{start, end});
+  }
+
+  void swap(interval_set& other) { this->rbtree_.swap(other.rbtree_); }
+};
+
+template <typename T, typename V>
+struct IntervalMapKey {
+  static const interval<T>& key(const std::pair<const interval<T>, V>& value) {
+    return value.first;
+  }
+};
+
+template <typename T, typename V>
+class interval_map : public IntervalTree<std::pair<const interval<T>, V>, T,
+                                         IntervalMapKey<T, V>> {
+  using Base =
+      IntervalTree<std::pair<const interval<T>, V>, T, IntervalMapKey<T, V>>;
+
+ public:
+  using typename Base::const_iterator;
+  using typename Base::interval_type;
+  using typename Base::iterator;
+  using typename Base::value_type;
+  using mapped_type = V;
+
+  interval_map() = default;
+
+  interval_map(std::initializer_list<value_type> const& items) {
+    for (const auto& item : items) insert(item);
+  }
+
+  V& at(const interval_type& key) {
+    iterator it = this->find(key);
+    if (it == this->end()) throw std::out_of_range("Interval not found");
+    return (*it).second;
+  }
+
+  const V& at(const interval_type& key) const {
+    const_iterator it = this->find(key);
+    if (it == this->end()) throw std::out_of_range("Interval not found");
+    return (*it).second;
+  }
+
+  iterator insert(const value_type& value) {
+    return this->rbtree_.insertDuplicate(value);
+  }
+
+  iterator insert(const interval_type& key, const V& obj) {
+    return insert(value_type{key, obj});
+  }
+
+  void swap(interval_map& other) { this->rbtree_.swap(other.rbtree_); }
+};
+}  // namespace lib
+
+#endif  // LIB_INTERVAL_H_
@@ -41,10 +41,13 @@ class list {
 
   void clear();
   iterator insert(iterator pos, const_reference value);
+  iterator insert(iterator pos, value_type&& value);
   void erase(iterator pos);
   void push_back(const_reference value);
+  void push_back(value_type&& value);
   void pop_back();
   void push_front(const_reference value);
+  void push_front(value_type&& value);
   void pop_front();
   void swap(list& other);
   void merge(list& other);
@@ -53,6 +56,15 @@ class list {
   void unique();
   void sort();
 
+  template <typename... Args>
+  iterator emplace(const_iterator pos, Args&&... args);
+
+  template <typename... Args>
+  reference emplace_back(Args&&... args);
+
+  template <typename... Args>
+  reference emplace_front(Args&&... args);
+
   template <typename... Args>
   iterator insert_many(const_iterator pos, Args&&... args);
 
@@ -199,19 +211,16 @@ struct list<T>::Node {
   Node* prev;
   Node* next;
 
-  Node(const value_type& data);
-  Node(Node* prev, Node* next, const value_type& data);
+  template <typename... Args>
+  Node(Node* prev, Node* next, Args&&... args);
 
   void insertBetweenNodes(Node* prev, Node* next);
 };
 
 template <typename T>
-list<T>::Node::Node(const value_type& data)
-    : data(data), prev(nullptr), next(nullptr) {}
-
-template <typename T>
-list<T>::Node::Node(Node* prev, Node* next, const value_type& data)
-    : data(data), prev(prev), next(next) {
+template <typename... Args>
+list<T>::Node::Node(Node* prev, Node* next, Args&&... args)
+    : data(std::forward<Args>(args)...), prev(prev), next(next) {
   insertBetweenNodes(prev, next);
 }
 
@@ -241,7 +250,7 @@ list<T>::list(size_type n) : head_(nullptr), tail_(nullptr), size_(0) {
 template <typename T>
 list<T>::list(std::initializer_list<value_type> const& items)
     : head_(nullptr), tail_(nullptr), size_(0) {
-  for (auto item : items) {
+  for (const auto& item : items) {
     push_back(item);
   }
 }
@@ -337,23 +346,12 @@ void list<T>::clear() {
 template <typename T>
 typename list<T>::iterator list<T>::insert(iterator pos,
                                            const_reference value) {
-  auto return_pos = begin();
-  if (size_) {
-    Node* inserted = new Node(value);
-    pos.insertNodeBeforeIterator(inserted);
-
-    if (pos == begin()) {
-      head_ = inserted;
-    } else if (pos == end()) {
-      tail_ = inserted;
-    }
+  return emplace(pos, value);
+}
 
-    ++size_;
-    return_pos = ListIterator(this, inserted);
-  } else {
-    push_back(value);
-  }
-  return return_pos;
+template <typename T>
+typename list<T>::iterator list<T>::insert(iterator pos, value_type&& value) {
+  return emplace(pos, std::move(value));
 }
 
 template <typename T>
@@ -363,12 +361,12 @@ void list<T>::erase(iterator pos) {
 
 template <typename T>
 void list<T>::push_back(const_reference value) {
-  Node* node = new Node(tail_, nullptr, value);
-  if (empty()) {
-    head_ = node;
-  }
-  tail_ = node;
-  ++size_;
+  emplace_back(value);
+}
+
+template <typename T>
+void list<T>::push_back(value_type&& value) {
+  emplace_back(std::move(value));
 }
 
 template <typename T>
@@ -378,12 +376,12 @@ void list<T>::pop_back() {
 
 template <typename T>
 void list<T>::push_front(const_reference value) {
-  Node* node = new Node(nullptr, head_, value);
-  if (empty()) {
-    tail_ = node;
-  }
-  head_ = node;
-  ++size_;
+  emplace_front(value);
+}
+
+template <typename T>
+void list<T>::push_front(value_type&& value) {
+  emplace_front(std::move(value));
 }
 
 template <typename T>
@@ -455,13 +453,45 @@ void list<T>::sort() {
   }
 }
 
+template <typename T>
+template <typename... Args>
+typename list<T>::iterator list<T>::emplace(const_iterator pos,
+                                            Args&&... args) {
+  Node* node = new Node(nullptr, nullptr, std::forward<Args>(args)...);
+  return insertNode(ListIterator(this, pos.current_), node);
+}
+
+template <typename T>
+template <typename... Args>
+typename list<T>::reference list<T>::emplace_back(Args&&... args) {
+  Node* node = new Node(tail_, nullptr, std::forward<Args>(args)...);
+  if (empty()) {
+    head_ = node;
+  }
+  tail_ = node;
+  ++size_;
+  return node->data;
+}
+
+template <typename T>
+template <typename... Args>
+typename list<T>::reference list<T>::emplace_front(Args&&... args) {
+  Node* node = new Node(nullptr, head_, std::forward<Args>(args)...);
+  if (empty()) {
+    tail_ = node;
+  }
+  head_ = node;
+  ++size_;
+  return node->data;
+}
+
 template <typename T>
 template <typename... Args>
 typename list<T>::iterator list<T>::insert_many(const_iterator pos,
                                                 Args&&... args) {
   auto iter = ListIterator(this, pos.current_);
   if constexpr (sizeof...(args) > 0) {
-    (insert(iter, value_type(std::forward<Args>(args))), ...);
+    (emplace(iter, std::forward<Args>(args)), ...);
     for (size_type i = 0; i < sizeof...(args); ++i) {
       --iter;
     }
@@ -472,13 +502,13 @@ typename list<T>::iterator list<T>::insert_many(const_iterator pos,
 template <typename T>
 template <typename... Args>
 void list<T>::insert_many_back(Args&&... args) {
-  (push_back(value_type(std::forward<Args>(args))), ...);
+  (emplace_back(std::forward<Args>(args)), ...);
 }
 
 template <typename T>
 template <typename... Args>
 void list<T>::insert_many_front(Args&&... args) {
-  insert_many(begin(), args...);
+  insert_many(begin(), std::forward<Args>(args)...);
 }
 
 template <typename T>
@@ -4,19 +4,58 @@
 #include "lib_tree.h"
 
 namespace lib {
-template <typename Key, typename T>
+// With a non-void Aggregate (sum_aggregate<T>, max_aggregate<T>, or any
+// monoid of the same shape) every tree node caches the aggregate of the
+// mapped values in its subtree, and aggregate(lo, hi) answers in O(log n).
+// Such a map hands out mapped values read-only: its iterator is a
+// const_iterator, and at(), operator[] and parallel_for_each() give const
+// access. insert_or_assign() changes them and refreshes the cached
+// aggregates.
+// Stats = tree_stats makes the underlying tree count its work; see RBTree.
+template <typename Key, typename T, typename Aggregate = void,
+          typename Stats = void>
 class map {
   using key_type = Key;
   using mapped_type = T;
   using value_type = std::pair<const key_type, mapped_type>;
   using reference = value_type&;
   using const_reference = const value_type&;
-  using BinaryTree = RBTree<value_type>;
   using size_type = std::size_t;
 
+  // Orders entries by key only and lets the tree search by a bare key.
+  struct KeyCompare {
+    bool operator()(const value_type& a, const value_type& b) const {
+      return a.first < b.first;
+    }
+    bool operator()(const value_type& a, const key_type& b) const {
+      return a.first < b;
+    }
+    bool operator()(const key_type& a, const value_type& b) const {
+      return a < b.first;
+    }
+  };
+
+  struct ValueAggregate : Aggregate {
+    static typename Aggregate::value_type project(const value_type& v) {
+      return v.second;
+    }
+  };
+
+  using BinaryTree =
+      RBTree<value_type, KeyCompare,
+             std::conditional_t<std::is_void_v<Aggregate>, void,
+                                ValueAggregate>,
+             Stats>;
+  using tree_iterator = typename BinaryTree::iterator;
+
  public:
-  using iterator = typename BinaryTree::iterator;
   using const_iterator = typename BinaryTree::const_iterator;
+  // Both read-only with an Aggregate, so no write can bypass the cached
+  // values.
+  using iterator = std::conditional_t<std::is_void_v<Aggregate>,
+                                      tree_iterator, const_iterator>;
+  using mapped_reference =
+      std::conditional_t<std::is_void_v<Aggregate>, T&, const T&>;
 
   map() : rbtree_() {}
 
@@ -40,8 +79,8 @@ class map {
     return *this;
   }
 
-  T& at(const Key& key) {
-    iterator it = findKey_(key);
+  mapped_reference at(const Key& key) {
+    tree_iterator it = findKey_(key);
     if (it == rbtree_.end()) throw std::out_of_range("Key not found");
     return (*it).second;
   }
@@ -52,9 +91,9 @@ class map {
     return (*it).second;
   }
 
-  T& operator[](const Key& key) {
+  mapped_reference operator[](const Key& key) {
     value_type value = {key, mapped_type{}};
-    iterator it = findKey_(key);
+    tree_iterator it = findKey_(key);
     if (it == rbtree_.end()) {
       auto res = rbtree_.insertUnique(value);
       return (*res.first).second;
@@ -74,8 +113,8 @@ class map {
   void clear() { rbtree_.clear(); }
 
   std::pair<iterator, bool> insert(const value_type& value) {
-    iterator it = findKey_(value.first);
-    if (it == end()) {
+    tree_iterator it = findKey_(value.first);
+    if (it == rbtree_.end()) {
       auto res = rbtree_.insertUnique(value);
       return res;
     }
@@ -84,8 +123,8 @@ class map {
 
   std::pair<iterator, bool> insert(const Key& key, const T& obj) {
     value_type value = {key, obj};
-    iterator it = findKey_(value.first);
-    if (it == end()) {
+    tree_iterator it = findKey_(value.first);
+    if (it == rbtree_.end()) {
       auto res = rbtree_.insertUnique(value);
       return res;
     }
@@ -94,18 +133,19 @@ class map {
 
   std::pair<iterator, bool> insert_or_assign(const Key& key, const T& obj) {
     value_type value = {key, obj};
-    iterator it = findKey_(key);
+    tree_iterator it = findKey_(key);
     if (it == rbtree_.end())
       return rbtree_.insertUnique(value);
     else {
       (*it).second = obj;
+      rbtree_.refreshAggregates(it);
       return {it, false};
     }
   }
 
   void erase(iterator pos) {
-    auto it = findKey_((*pos).first);
-    if (it != end()) rbtree_.erase(pos);
+    tree_iterator it = findKey_((*pos).first);
+    if (it != rbtree_.end()) rbtree_.erase(it);
   }
 
   void swap(map& other) { rbtree_.swap(other.rbtree_); }
@@ -118,18 +158,84 @@ class map {
 
   template <typename... Args>
   vector<std::pair<iterator, bool>> insert_many(Args&&... args) {
-    return rbtree_.insertMany(std::forward<Args>(args)...);
+    if constexpr (std::is_void_v<Aggregate>) {
+      return rbtree_.insertMany(std::forward<Args>(args)...);
+    } else {
+      vector<std::pair<tree_iterator, bool>> inserted =
+          rbtree_.insertMany(std::forward<Args>(args)...);
+      vector<std::pair<iterator, bool>> result;
+      result.reserve(inserted.size());
+      for (auto& entry : inserted) result.push_back(entry);
+      return result;
+    }
+  }
+
+  // Aggregate of the mapped values whose keys lie in [lo, hi).
+  template <typename A = Aggregate>
+  typename A::value_type aggregate(const Key& lo, const Key& hi) const {
+    return rbtree_.aggregate(lo, hi);
+  }
+
+  // Aggregate of all mapped values, read from the root in O(1).
+  template <typename A = Aggregate>
+  typename A::value_type aggregate() const {
+    return rbtree_.aggregate();
+  }
+
+  template <typename Function>
+  void parallel_for_each(Function f,
+                         thread_pool& pool = thread_pool::global()) {
+    if constexpr (std::is_void_v<Aggregate>)
+      rbtree_.parallelForEach(f, pool);
+    else
+      std::as_const(rbtree_).parallelForEach(f, pool);
+  }
+
+  template <typename Function>
+  void parallel_for_each(Function f,
+                         thread_pool& pool = thread_pool::global()) const {
+    rbtree_.parallelForEach(f, pool);
+  }
+
+  template <typename Result, typename BinaryOp>
+  Result parallel_reduce(Result init, BinaryOp op,
+                         thread_pool& pool = thread_pool::global()) const {
+    return rbtree_.parallelReduce(
+        std::move(init), op,
+        [](const_reference v) -> const_reference { return v; }, pool);
+  }
+
+  template <typename Result, typename BinaryOp, typename UnaryOp>
+  Result parallel_reduce(Result init, BinaryOp op, UnaryOp transform,
+                         thread_pool& pool = thread_pool::global()) const {
+    return rbtree_.parallelReduce(std::move(init), op, transform, pool);
+  }
+
+  template <typename S = Stats>
+  const S& stats() const noexcept {
+    return rbtree_.stats();
+  }
+
+  template <typename S = Stats>
+  void reset_stats() noexcept {
+    rbtree_.resetStats();
+  }
+
+  size_type height() const noexcept { return rbtree_.height(); }
+
+  vector<size_type> depth_histogram() const {
+    return rbtree_.depthHistogram();
   }
 
  private:
-  iterator findKey_(const Key& key) noexcept {
-    iterator it = rbtree_.begin();
-    if (it == rbtree_.end() || it == nullptr) return end();
+  tree_iterator findKey_(const Key& key) noexcept {
+    tree_iterator it = rbtree_.begin();
+    if (it == rbtree_.end() || it == nullptr) return rbtree_.end();
     while (it != rbtree_.end()) {
       if ((*it).first == key) return it;
       it++;
     }
-    return end();
+    return rbtree_.end();
   }
 
   const_iterator findKey_(const Key& key) const noexcept {
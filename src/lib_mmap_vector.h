@@ -0,0 +1,366 @@
+#ifndef LIB_MMAP_VECTOR_H_
+#define LIB_MMAP_VECTOR_H_
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include "lib_vector.h"
+
+namespace lib {
+// vector of trivially copyable records kept in a file mapped with mmap
+// (POSIX only). The file holds the raw elements and nothing else, so
+// opening it costs one mmap call whatever its size, and pages are read on
+// first access. Growing extends the file and maps it again, which moves the
+// elements' addresses like a vector reallocation. The file carries spare
+// capacity while open and is truncated to size() * sizeof(T) by close() and
+// the destructor. Writes reach the file through the page cache; flush()
+// forces them to disk.
+//
+// In read_only mode, and on a default-constructed mmap_vector that has no
+// file, every member that changes the size or capacity throws
+// std::logic_error; writing to a read_only mapping faults. Failing system
+// calls throw std::system_error.
+template <typename T>
+class mmap_vector {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "mmap_vector stores raw bytes of trivially copyable T");
+
+ public:
+  using value_type = T;
+  using reference = T &;
+  using const_reference = const T &;
+  using iterator = T *;
+  using const_iterator = const T *;
+  using size_type = std::size_t;
+
+  enum class open_mode {
+    read_only,   // the file must exist
+    read_write,  // created empty if missing
+    truncate,    // created if missing, emptied if not
+  };
+
+  enum class advice { normal, sequential, random, willneed, dontneed };
+
+  mmap_vector() noexcept;
+  explicit mmap_vector(const std::string &path,
+                       open_mode mode = open_mode::read_write);
+  mmap_vector(const mmap_vector &) = delete;
+  mmap_vector(mmap_vector &&other) noexcept;
+  ~mmap_vector();
+  mmap_vector &operator=(const mmap_vector &) = delete;
+  mmap_vector &operator=(mmap_vector &&other) noexcept;
+
+  reference at(size_type pos);
+  const_reference at(size_type pos) const;
+  reference operator[](size_type pos) { return p_[pos]; }
+  const_reference operator[](size_type pos) const { return p_[pos]; }
+  reference front() { return p_[0]; }
+  reference back() { return p_[size_ - 1]; }
+  T *data() noexcept { return p_; }
+  const T *data() const noexcept { return p_; }
+
+  iterator begin() noexcept { return p_; }
+  iterator end() noexcept { return p_ + size_; }
+  const_iterator begin() const noexcept { return p_; }
+  const_iterator end() const noexcept { return p_ + size_; }
+
+  bool empty() const noexcept { return size_ == 0; }
+  size_type size() const noexcept { return size_; }
+  size_type capacity() const noexcept { return capacity_; }
+  bool is_open() const noexcept { return fd_ >= 0; }
+  bool read_only() const noexcept { return read_only_; }
+
+  // Makes room for n elements, extending the file.
+  void reserve(size_type n);
+  // New elements are zero bytes, as the file extension reads back.
+  void resize(size_type n);
+  void shrink_to_fit();
+  void clear();
+  void push_back(const_reference value);
+  void append(const T *values, size_type n);
+  void pop_back();
+
+  // Writes dirty pages back and waits for the disk (msync MS_SYNC).
+  void flush();
+  // Passes an access-pattern hint for the mapping to posix_madvise.
+  void advise(advice hint);
+  // Truncates the file to the elements in use and releases it. The object
+  // is then empty and may be reopened by assigning a new mmap_vector.
+  void close();
+
+ private:
+  void map(size_type capacity);
+  void unmap() noexcept;
+  void resizeFile(size_type elements);
+  void requireWritable() const;
+  size_type roundToPages(size_type elements) const;
+
+  [[noreturn]] static void fail(const char *what);
+
+  int fd_;
+  bool read_only_;
+  T *p_;
+  size_type size_;
+  size_type capacity_;
+};
+
+template <typename T>
+mmap_vector<T>::mmap_vector() noexcept
+    : fd_(-1), read_only_(false), p_(nullptr), size_(0), capacity_(0) {}
+
+template <typename T>
+mmap_vector<T>::mmap_vector(const std::string &path, open_mode mode)
+    : mmap_vector() {
+  read_only_ = mode == open_mode::read_only;
+  int flags = read_only_ ? O_RDONLY : O_RDWR | O_CREAT;
+  if (mode == open_mode::truncate) flags |= O_TRUNC;
+  fd_ = ::open(path.c_str(), flags | O_CLOEXEC, 0644);
+  if (fd_ < 0) fail("open");
+
+  struct stat info;
+  if (::fstat(fd_, &info) != 0) {
+    int error = errno;
+    ::close(fd_);
+    fd_ = -1;
+    errno = error;
+    fail("fstat");
+  }
+  size_type bytes = static_cast<size_type>(info.st_size);
+  if (bytes % sizeof(T) != 0) {
+    ::close(fd_);
+    fd_ = -1;
+    throw std::runtime_error(path + ": size is not a multiple of the record");
+  }
+  size_ = bytes / sizeof(T);
+  try {
+    map(size_);
+  } catch (...) {
+    ::close(fd_);
+    fd_ = -1;
+    throw;
+  }
+}
+
+template <typename T>
+mmap_vector<T>::mmap_vector(mmap_vector &&other) noexcept
+    : fd_(std::exchange(other.fd_, -1)),
+      read_only_(std::exchange(other.read_only_, false)),
+      p_(std::exchange(other.p_, nullptr)),
+      size_(std::exchange(other.size_, 0)),
+      capacity_(std::exchange(other.capacity_, 0)) {}
+
+template <typename T>
+mmap_vector<T>::~mmap_vector() {
+  try {
+    close();
+  } catch (...) {
+  }
+}
+
+template <typename T>
+mmap_vector<T> &mmap_vector<T>::operator=(mmap_vector &&other) noexcept {
+  if (this != &other) {
+    try {
+      close();
+    } catch (...) {
+    }
+    fd_ = std::exchange(other.fd_, -1);
+    read_only_ = std::exchange(other.read_only_, false);
+    p_ = std::exchange(other.p_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+    capacity_ = std::exchange(other.capacity_, 0);
+  }
+  return *this;
+}
+
+template <typename T>
+typename mmap_vector<T>::reference mmap_vector<T>::at(size_type pos) {
+  if (pos >= size_) throw std::out_of_range("Index out of range");
+  return p_[pos];
+}
+
+template <typename T>
+typename mmap_vector<T>::const_reference mmap_vector<T>::at(
+    size_type pos) const {
+  if (pos >= size_) throw std::out_of_range("Index out of range");
+  return p_[pos];
+}
+
+template <typename T>
+void mmap_vector<T>::reserve(size_type n) {
+  requireWritable();
+  if (n <= capacity_) return;
+  size_type capacity = roundToPages(n);
+  resizeFile(capacity);
+  map(capacity);
+}
+
+template <typename T>
+void mmap_vector<T>::resize(size_type n) {
+  requireWritable();
+  if (n > capacity_) reserve(doubling_growth::next(capacity_, n));
+  // Capacity beyond the old size may hold bytes of removed elements.
+  if (n > size_) std::memset(p_ + size_, 0, (n - size_) * sizeof(T));
+  size_ = n;
+}
+
+template <typename T>
+void mmap_vector<T>::shrink_to_fit() {
+  requireWritable();
+  if (capacity_ == size_) return;
+  resizeFile(size_);
+  map(size_);
+}
+
+template <typename T>
+void mmap_vector<T>::clear() {
+  requireWritable();
+  size_ = 0;
+}
+
+template <typename T>
+void mmap_vector<T>::pop_back() {
+  requireWritable();
+  --size_;
+}
+
+template <typename T>
+void mmap_vector<T>::push_back(const_reference value) {
+  append(&value, 1);
+}
+
+template <typename T>
+void mmap_vector<T>::append(const T *values, size_type n) {
+  requireWritable();
+  if (size_ + n > capacity_) {
+    // values may point into the current mapping.
+    T *old = p_;
+    bool inside = values >= p_ && values < p_ + size_;
+    reserve(doubling_growth::next(capacity_, size_ + n));
+    if (inside) values = p_ + (values - old);
+  }
+  std::memmove(p_ + size_, values, n * sizeof(T));
+  size_ += n;
+}
+
+template <typename T>
+void mmap_vector<T>::flush() {
+  if (p_ != nullptr && !read_only_ &&
+      ::msync(p_, capacity_ * sizeof(T), MS_SYNC) != 0) {
+    fail("msync");
+  }
+}
+
+template <typename T>
+void mmap_vector<T>::advise(advice hint) {
+  if (p_ == nullptr) return;
+  int flag = POSIX_MADV_NORMAL;
+  switch (hint) {
+    case advice::normal:
+      break;
+    case advice::sequential:
+      flag = POSIX_MADV_SEQUENTIAL;
+      break;
+    case advice::random:
+      flag = POSIX_MADV_RANDOM;
+      break;
+    case advice::willneed:
+      flag = POSIX_MADV_WILLNEED;
+      break;
+    case advice::dontneed:
+      flag = POSIX_MADV_DONTNEED;
+      break;
+  }
+  int error = ::posix_madvise(p_, capacity_ * sizeof(T), flag);
+  if (error != 0) {
+    errno = error;
+    fail("posix_madvise");
+  }
+}
+
+template <typename T>
+void mmap_vector<T>::close() {
+  if (fd_ < 0) return;
+  unmap();
+  int fd = std::exchange(fd_, -1);
+  int error = 0;
+  if (!read_only_ &&
+      ::ftruncate(fd, static_cast<off_t>(size_ * sizeof(T))) != 0) {
+    error = errno;
+  }
+  ::close(fd);
+  size_ = 0;
+  capacity_ = 0;
+  read_only_ = false;
+  if (error != 0) {
+    errno = error;
+    fail("ftruncate");
+  }
+}
+
+// Replaces the mapping by one of the first capacity elements of the file,
+// keeping the old one if mmap fails. Zero elements need no mapping.
+template <typename T>
+void mmap_vector<T>::map(size_type capacity) {
+  void *p = nullptr;
+  if (capacity > 0) {
+    int protection = read_only_ ? PROT_READ : PROT_READ | PROT_WRITE;
+    p = ::mmap(nullptr, capacity * sizeof(T), protection, MAP_SHARED, fd_, 0);
+    if (p == MAP_FAILED) fail("mmap");
+  }
+  unmap();
+  p_ = static_cast<T *>(p);
+  capacity_ = capacity;
+}
+
+template <typename T>
+void mmap_vector<T>::unmap() noexcept {
+  if (p_ != nullptr) ::munmap(p_, capacity_ * sizeof(T));
+  p_ = nullptr;
+  capacity_ = 0;
+}
+
+template <typename T>
+void mmap_vector<T>::resizeFile(size_type elements) {
+  if (elements > std::numeric_limits<off_t>::max() / sizeof(T)) {
+    throw std::length_error("mmap_vector larger than a file can be");
+  }
+  if (::ftruncate(fd_, static_cast<off_t>(elements * sizeof(T))) != 0) {
+    fail("ftruncate");
+  }
+}
+
+template <typename T>
+void mmap_vector<T>::requireWritable() const {
+  if (fd_ < 0) throw std::logic_error("mmap_vector is not open");
+  if (read_only_) throw std::logic_error("mmap_vector is read-only");
+}
+
+// Grows a capacity to whole pages, so small appends do not remap.
+template <typename T>
+typename mmap_vector<T>::size_type mmap_vector<T>::roundToPages(
+    size_type elements) const {
+  size_type page = static_cast<size_type>(::sysconf(_SC_PAGESIZE));
+  size_type bytes = (elements * sizeof(T) + page - 1) / page * page;
+  return bytes / sizeof(T);
+}
+
+template <typename T>
+void mmap_vector<T>::fail(const char *what) {
+  throw std::system_error(errno, std::generic_category(), what);
+}
+}  // namespace lib
+
+#endif  // LIB_MMAP_VECTOR_H_
@@ -4,13 +4,14 @@
 #include "lib_tree.h"
 
 namespace lib {
-template <typename Key>
+// Stats = tree_stats makes the underlying tree count its work; see RBTree.
+template <typename Key, typename Stats = void>
 class multiset {
   using key_type = Key;
   using value_type = Key;
   using reference = value_type&;
   using const_reference = const value_type&;
-  using BinaryTree = RBTree<value_type>;
+  using BinaryTree = RBTree<value_type, std::less<value_type>, void, Stats>;
   using size_type = std::size_t;
 
  public:
@@ -98,6 +99,42 @@ class multiset {
     return rbtree_.insertManyDuplicate(std::forward<Args>(args)...);
   }
 
+  template <typename Function>
+  void parallel_for_each(Function f,
+                         thread_pool& pool = thread_pool::global()) const {
+    rbtree_.parallelForEach(f, pool);
+  }
+
+  template <typename Result, typename BinaryOp>
+  Result parallel_reduce(Result init, BinaryOp op,
+                         thread_pool& pool = thread_pool::global()) const {
+    return rbtree_.parallelReduce(
+        std::move(init), op,
+        [](const_reference v) -> const_reference { return v; }, pool);
+  }
+
+  template <typename Result, typename BinaryOp, typename UnaryOp>
+  Result parallel_reduce(Result init, BinaryOp op, UnaryOp transform,
+                         thread_pool& pool = thread_pool::global()) const {
+    return rbtree_.parallelReduce(std::move(init), op, transform, pool);
+  }
+
+  template <typename S = Stats>
+  const S& stats() const noexcept {
+    return rbtree_.stats();
+  }
+
+  template <typename S = Stats>
+  void reset_stats() noexcept {
+    rbtree_.resetStats();
+  }
+
+  size_type height() const noexcept { return rbtree_.height(); }
+
+  vector<size_type> depth_histogram() const {
+    return rbtree_.depthHistogram();
+  }
+
  private:
   BinaryTree rbtree_;
 };
@@ -0,0 +1,525 @@
+#ifndef LIB_PACKED_INT_VECTOR_H_
+#define LIB_PACKED_INT_VECTOR_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <limits>
+#include <new>
+#include <stdexcept>
+#include <utility>
+
+#include "lib_simd.h"
+
+namespace lib {
+// Append-only sequence of 64-bit unsigned integers compressed in blocks of
+// kBlockSize values. Each full block is stored frame-of-reference: its
+// minimum once, then every value minus that minimum in just enough bits for
+// the largest difference. Sorted IDs or small-range values take a few bits
+// each instead of 64. The last, partial block stays uncompressed until it
+// fills.
+//
+// With encoding::delta, a block of non-decreasing values keeps the gaps
+// between neighbours instead when that takes fewer words. This suits sorted
+// IDs with small gaps. Unsorted blocks fall back to frame-of-reference.
+//
+// operator[] extracts one value in constant time. A delta block also stores
+// its running sum at every 32nd value, so a lookup there adds at most 32
+// gaps, two per SIMD step. for_each() and copy_to() decode whole blocks with
+// the same SIMD shifts. Use them for scans.
+class packed_int_vector {
+ public:
+  using value_type = std::uint64_t;
+  using word_type = std::uint64_t;
+  using size_type = std::size_t;
+
+  static constexpr size_type kBlockSize = 128;
+
+  enum class encoding { frame_of_reference, delta };
+
+  explicit packed_int_vector(
+      encoding mode = encoding::frame_of_reference) noexcept;
+  packed_int_vector(std::initializer_list<value_type> values,
+                    encoding mode = encoding::frame_of_reference);
+  packed_int_vector(const packed_int_vector &other);
+  packed_int_vector(packed_int_vector &&other) noexcept;
+  ~packed_int_vector();
+  packed_int_vector &operator=(packed_int_vector &&other) noexcept;
+
+  value_type operator[](size_type pos) const noexcept;
+  value_type at(size_type pos) const;
+  value_type front() const noexcept { return (*this)[0]; }
+  value_type back() const noexcept { return (*this)[size_ - 1]; }
+
+  bool empty() const noexcept { return size_ == 0; }
+  size_type size() const noexcept { return size_; }
+  encoding mode() const noexcept { return mode_; }
+  // Heap bytes held for blocks, block headers and the partial block.
+  size_type memory_usage() const noexcept;
+
+  void push_back(value_type value);
+  void append(const value_type *values, size_type n);
+  void clear() noexcept { size_ = word_count_ = 0; }
+  void shrink_to_fit();
+
+  // Calls f(value) for every value in order.
+  template <typename Function>
+  void for_each(Function f) const;
+  // Writes all size() values to out.
+  void copy_to(value_type *out) const;
+
+ private:
+  // Headers hold two words per full block: the base, then the offset of
+  // its packed words shifted past an 8-bit field of width and delta flag.
+  static constexpr size_type kHeaderWords = 2;
+  // Unpacking reads one word pair past a block, so that many words beyond
+  // the used ones always exist.
+  static constexpr size_type kPadding = 2;
+  // A delta block's packed gaps are followed by its checkpoints: value
+  // k * kCheckpointStride - 1 minus the base for k = 1, 2, 3, each in
+  // checkpointWidth() bits.
+  static constexpr size_type kCheckpointStride = 32;
+  static constexpr size_type kCheckpoints = kBlockSize / kCheckpointStride - 1;
+
+  size_type blockCount() const noexcept { return size_ / kBlockSize; }
+  value_type blockBase(size_type block) const noexcept {
+    return headers_[block * kHeaderWords];
+  }
+  const word_type *blockWords(size_type block) const noexcept {
+    return words_ + (headers_[block * kHeaderWords + 1] >> 8);
+  }
+  unsigned blockWidth(size_type block) const noexcept {
+    return (headers_[block * kHeaderWords + 1] >> 1) & 0x7f;
+  }
+  bool blockIsDelta(size_type block) const noexcept {
+    return headers_[block * kHeaderWords + 1] & 1;
+  }
+
+  void sealBlock();
+  void decodeBlock(size_type block, value_type *out) const noexcept;
+
+  static unsigned bitWidth(value_type value) noexcept;
+  // A checkpoint sums fewer than kBlockSize gaps of width bits.
+  static unsigned checkpointWidth(unsigned width) noexcept {
+    return std::min(width + 7, 64u);
+  }
+  static size_type packedWords(unsigned width, bool delta) noexcept {
+    size_type words = width * kBlockSize / 64;
+    if (delta) words += (kCheckpoints * checkpointWidth(width) + 63) / 64;
+    return words;
+  }
+  static void pack(const value_type *values, unsigned width,
+                   word_type *out) noexcept;
+  static void unpack(const word_type *in, unsigned width,
+                     value_type *out) noexcept;
+  static value_type extract(const word_type *in, unsigned width,
+                            size_type index) noexcept;
+  static void packCheckpoints(const value_type *checkpoints, unsigned width,
+                              word_type *out) noexcept;
+  static value_type checkpoint(const word_type *in, unsigned width,
+                               size_type k) noexcept;
+  static value_type rangeSum(const word_type *in, unsigned width,
+                             size_type first, size_type last) noexcept;
+#if defined(LIB_SIMD_AVX2) || defined(LIB_SIMD_SSE2)
+  static __m128i unpackPair(const word_type *in, unsigned width,
+                            size_type pair, __m128i lane_mask) noexcept;
+#endif
+
+  static void reallocate(word_type *&words, size_type used,
+                         size_type &capacity, size_type fresh_capacity);
+  static word_type *allocate(size_type words);
+  static void release(word_type *words) noexcept;
+
+  word_type *words_;
+  size_type word_count_;
+  size_type word_capacity_;
+  word_type *headers_;
+  size_type header_capacity_;
+  // The partial block, kBlockSize values once allocated.
+  value_type *tail_;
+  size_type size_;
+  encoding mode_;
+};
+
+inline packed_int_vector::packed_int_vector(encoding mode) noexcept
+    : words_(nullptr),
+      word_count_(0),
+      word_capacity_(0),
+      headers_(nullptr),
+      header_capacity_(0),
+      tail_(nullptr),
+      size_(0),
+      mode_(mode) {}
+
+inline packed_int_vector::packed_int_vector(
+    std::initializer_list<value_type> values, encoding mode)
+    : packed_int_vector(mode) {
+  append(values.begin(), values.size());
+}
+
+inline packed_int_vector::packed_int_vector(const packed_int_vector &other)
+    : packed_int_vector(other.mode_) {
+  // The delegated constructor has finished, so the destructor frees
+  // whatever was allocated if a later allocation throws.
+  if (other.words_ != nullptr) {
+    words_ = allocate(other.word_count_ + kPadding);
+    word_capacity_ = other.word_count_ + kPadding;
+    std::memcpy(words_, other.words_,
+                (other.word_count_ + kPadding) * sizeof(word_type));
+  }
+  size_type header_words = other.blockCount() * kHeaderWords;
+  if (header_words > 0) {
+    headers_ = allocate(header_words);
+    header_capacity_ = header_words;
+    std::memcpy(headers_, other.headers_, header_words * sizeof(word_type));
+  }
+  if (other.tail_ != nullptr) {
+    tail_ = allocate(kBlockSize);
+    std::memcpy(tail_, other.tail_,
+                other.size_ % kBlockSize * sizeof(value_type));
+  }
+  word_count_ = other.word_count_;
+  size_ = other.size_;
+}
+
+inline packed_int_vector::packed_int_vector(packed_int_vector &&other) noexcept
+    : words_(std::exchange(other.words_, nullptr)),
+      word_count_(std::exchange(other.word_count_, 0)),
+      word_capacity_(std::exchange(other.word_capacity_, 0)),
+      headers_(std::exchange(other.headers_, nullptr)),
+      header_capacity_(std::exchange(other.header_capacity_, 0)),
+      tail_(std::exchange(other.tail_, nullptr)),
+      size_(std::exchange(other.size_, 0)),
+      mode_(other.mode_) {}
+
+inline packed_int_vector::~packed_int_vector() {
+  release(words_);
+  release(headers_);
+  release(tail_);
+}
+
+inline packed_int_vector &packed_int_vector::operator=(
+    packed_int_vector &&other) noexcept {
+  if (this != &other) {
+    release(words_);
+    release(headers_);
+    release(tail_);
+    words_ = std::exchange(other.words_, nullptr);
+    word_count_ = std::exchange(other.word_count_, 0);
+    word_capacity_ = std::exchange(other.word_capacity_, 0);
+    headers_ = std::exchange(other.headers_, nullptr);
+    header_capacity_ = std::exchange(other.header_capacity_, 0);
+    tail_ = std::exchange(other.tail_, nullptr);
+    size_ = std::exchange(other.size_, 0);
+    mode_ = other.mode_;
+  }
+  return *this;
+}
+
+inline packed_int_vector::value_type packed_int_vector::operator[](
+    size_type pos) const noexcept {
+  size_type block = pos / kBlockSize;
+  size_type index = pos % kBlockSize;
+  if (block == blockCount()) return tail_[index];
+  const word_type *words = blockWords(block);
+  unsigned width = blockWidth(block);
+  value_type value = blockBase(block);
+  if (!blockIsDelta(block)) return value + extract(words, width, index);
+  size_type k = index / kCheckpointStride;
+  if (k > 0) value += checkpoint(words, width, k);
+  return value + rangeSum(words, width, k * kCheckpointStride, index);
+}
+
+inline packed_int_vector::value_type packed_int_vector::at(
+    size_type pos) const {
+  if (pos >= size_) throw std::out_of_range("Index out of range");
+  return (*this)[pos];
+}
+
+inline packed_int_vector::size_type packed_int_vector::memory_usage()
+    const noexcept {
+  size_type words = word_capacity_ + header_capacity_;
+  if (tail_ != nullptr) words += kBlockSize;
+  return words * sizeof(word_type);
+}
+
+inline void packed_int_vector::push_back(value_type value) {
+  if (tail_ == nullptr) tail_ = allocate(kBlockSize);
+  tail_[size_ % kBlockSize] = value;
+  ++size_;
+  if (size_ % kBlockSize == 0) {
+    try {
+      sealBlock();
+    } catch (...) {
+      --size_;
+      throw;
+    }
+  }
+}
+
+inline void packed_int_vector::append(const value_type *values, size_type n) {
+  for (size_type i = 0; i < n; ++i) push_back(values[i]);
+}
+
+inline void packed_int_vector::shrink_to_fit() {
+  size_type header_words = blockCount() * kHeaderWords;
+  if (header_capacity_ > header_words) {
+    reallocate(headers_, header_words, header_capacity_, header_words);
+  }
+  if (word_count_ == 0) {
+    release(words_);
+    words_ = nullptr;
+    word_capacity_ = 0;
+  } else if (word_capacity_ > word_count_ + kPadding) {
+    reallocate(words_, word_count_ + kPadding, word_capacity_,
+               word_count_ + kPadding);
+  }
+  if (size_ % kBlockSize == 0) {
+    release(tail_);
+    tail_ = nullptr;
+  }
+}
+
+template <typename Function>
+void packed_int_vector::for_each(Function f) const {
+  alignas(64) value_type buffer[kBlockSize];
+  for (size_type block = 0, n = blockCount(); block < n; ++block) {
+    decodeBlock(block, buffer);
+    for (size_type i = 0; i < kBlockSize; ++i) f(buffer[i]);
+  }
+  for (size_type i = 0, n = size_ % kBlockSize; i < n; ++i) f(tail_[i]);
+}
+
+inline void packed_int_vector::copy_to(value_type *out) const {
+  size_type blocks = blockCount();
+  for (size_type block = 0; block < blocks; ++block) {
+    decodeBlock(block, out + block * kBlockSize);
+  }
+  if (size_ % kBlockSize != 0) {
+    std::memcpy(out + blocks * kBlockSize, tail_,
+                size_ % kBlockSize * sizeof(value_type));
+  }
+}
+
+// Compresses the full tail into the next block. size_ already counts the
+// tail's values; on failure nothing else has changed.
+inline void packed_int_vector::sealBlock() {
+  const value_type *values = tail_;
+  value_type low = values[0];
+  value_type high = values[0];
+  value_type largest_gap = 0;
+  bool sorted = true;
+  for (size_type i = 1; i < kBlockSize; ++i) {
+    low = std::min(low, values[i]);
+    high = std::max(high, values[i]);
+    sorted = sorted && values[i - 1] <= values[i];
+    largest_gap = std::max(largest_gap, values[i] - values[i - 1]);
+  }
+  unsigned width = bitWidth(high - low);
+  bool delta = false;
+  if (mode_ == encoding::delta && sorted &&
+      packedWords(bitWidth(largest_gap), true) < packedWords(width, false)) {
+    width = bitWidth(largest_gap);
+    delta = true;
+  }
+
+  size_type block = blockCount() - 1;
+  size_type block_words = packedWords(width, delta);
+  if ((block + 1) * kHeaderWords > header_capacity_) {
+    reallocate(headers_, block * kHeaderWords, header_capacity_,
+               std::max((block + 1) * kHeaderWords, header_capacity_ * 2));
+  }
+  if (word_count_ + block_words + kPadding > word_capacity_) {
+    reallocate(words_, word_count_, word_capacity_,
+               std::max(word_count_ + block_words + kPadding,
+                        word_capacity_ * 2));
+  }
+
+  alignas(64) value_type residuals[kBlockSize];
+  value_type base = delta ? values[0] : low;
+  residuals[0] = values[0] - base;
+  for (size_type i = 1; i < kBlockSize; ++i) {
+    residuals[i] = delta ? values[i] - values[i - 1] : values[i] - base;
+  }
+  pack(residuals, width, words_ + word_count_);
+  if (delta) {
+    // Overwrites the residuals, which are packed already.
+    for (size_type k = 1; k <= kCheckpoints; ++k) {
+      residuals[k - 1] = values[k * kCheckpointStride - 1] - base;
+    }
+    packCheckpoints(residuals, checkpointWidth(width),
+                    words_ + word_count_ + width * kBlockSize / 64);
+  }
+  std::fill(words_ + word_count_ + block_words,
+            words_ + word_count_ + block_words + kPadding, word_type(0));
+  headers_[block * kHeaderWords] = base;
+  headers_[block * kHeaderWords + 1] =
+      word_count_ << 8 | width << 1 | (delta ? 1 : 0);
+  word_count_ += block_words;
+}
+
+inline void packed_int_vector::decodeBlock(size_type block,
+                                           value_type *out) const noexcept {
+  unpack(blockWords(block), blockWidth(block), out);
+  value_type base = blockBase(block);
+  if (blockIsDelta(block)) {
+    out[0] = base;
+    for (size_type i = 1; i < kBlockSize; ++i) out[i] += out[i - 1];
+  } else {
+    for (size_type i = 0; i < kBlockSize; ++i) out[i] += base;
+  }
+}
+
+inline unsigned packed_int_vector::bitWidth(value_type value) noexcept {
+  return value == 0 ? 0 : 64 - __builtin_clzll(value);
+}
+
+// A block of width w bits per value takes 2 * w words. Even-indexed values
+// go to the even words and odd-indexed values to the odd words, each lane
+// packed low bits first. Value pairs 2r and 2r + 1 then sit at the same bit
+// offset r * w of their lanes, so unpacking shifts a pair of words as one
+// 128-bit register.
+inline void packed_int_vector::pack(const value_type *values, unsigned width,
+                                    word_type *out) noexcept {
+  std::fill(out, out + width * kBlockSize / 64, word_type(0));
+  if (width == 0) return;
+  for (size_type i = 0; i < kBlockSize; ++i) {
+    size_type bit = i / 2 * width;
+    size_type word = bit / 64 * 2 + i % 2;
+    unsigned shift = bit % 64;
+    out[word] |= values[i] << shift;
+    if (shift + width > 64) out[word + 2] |= values[i] >> (64 - shift);
+  }
+}
+
+// The SIMD shifts yield zero for a count of 64, so a pair that does not
+// straddle two words needs no branch: the next word pair contributes
+// nothing.
+inline void packed_int_vector::unpack(const word_type *in, unsigned width,
+                                      value_type *out) noexcept {
+  if (width == 0) {
+    std::fill(out, out + kBlockSize, value_type(0));
+    return;
+  }
+  value_type mask = width == 64 ? ~value_type(0)
+                                : (value_type(1) << width) - 1;
+#if defined(LIB_SIMD_AVX2) || defined(LIB_SIMD_SSE2)
+  __m128i lane_mask = _mm_set1_epi64x(static_cast<long long>(mask));
+  for (size_type pair = 0; pair < kBlockSize / 2; ++pair) {
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out + pair * 2),
+                     unpackPair(in, width, pair, lane_mask));
+  }
+#else
+  for (size_type i = 0; i < kBlockSize; ++i) out[i] = extract(in, width, i);
+  (void)mask;
+#endif
+}
+
+inline packed_int_vector::value_type packed_int_vector::extract(
+    const word_type *in, unsigned width, size_type index) noexcept {
+  if (width == 0) return 0;
+  size_type bit = index / 2 * width;
+  size_type word = bit / 64 * 2 + index % 2;
+  unsigned shift = bit % 64;
+  value_type value = in[word] >> shift;
+  if (shift + width > 64) value |= in[word + 2] << (64 - shift);
+  return width == 64 ? value : value & ((value_type(1) << width) - 1);
+}
+
+// Checkpoints form one plain bit stream of kCheckpoints fields, low bits
+// first.
+inline void packed_int_vector::packCheckpoints(const value_type *checkpoints,
+                                               unsigned width,
+                                               word_type *out) noexcept {
+  std::fill(out, out + (kCheckpoints * width + 63) / 64, word_type(0));
+  for (size_type k = 0; k < kCheckpoints; ++k) {
+    size_type bit = k * width;
+    unsigned shift = bit % 64;
+    out[bit / 64] |= checkpoints[k] << shift;
+    if (shift + width > 64) out[bit / 64 + 1] |= checkpoints[k] >> (64 - shift);
+  }
+}
+
+// Checkpoint k, from 1, of a delta block whose gaps are width bits wide.
+inline packed_int_vector::value_type packed_int_vector::checkpoint(
+    const word_type *in, unsigned width, size_type k) noexcept {
+  unsigned bits = checkpointWidth(width);
+  const word_type *marks = in + width * kBlockSize / 64;
+  size_type bit = (k - 1) * bits;
+  unsigned shift = bit % 64;
+  value_type value = marks[bit / 64] >> shift;
+  if (shift + bits > 64) value |= marks[bit / 64 + 1] << (64 - shift);
+  return bits == 64 ? value : value & ((value_type(1) << bits) - 1);
+}
+
+// Sums the values first through last of a block, first even: the pairs up
+// to last's, less the odd value of that pair when last is even.
+inline packed_int_vector::value_type packed_int_vector::rangeSum(
+    const word_type *in, unsigned width, size_type first,
+    size_type last) noexcept {
+  if (width == 0) return 0;
+#if defined(LIB_SIMD_AVX2) || defined(LIB_SIMD_SSE2)
+  value_type mask = width == 64 ? ~value_type(0)
+                                : (value_type(1) << width) - 1;
+  __m128i lane_mask = _mm_set1_epi64x(static_cast<long long>(mask));
+  __m128i sums = _mm_setzero_si128();
+  for (size_type pair = first / 2; pair <= last / 2; ++pair) {
+    sums = _mm_add_epi64(sums, unpackPair(in, width, pair, lane_mask));
+  }
+  __m128i high = _mm_unpackhi_epi64(sums, sums);
+  value_type sum = static_cast<value_type>(_mm_cvtsi128_si64(sums)) +
+                   static_cast<value_type>(_mm_cvtsi128_si64(high));
+  if (last % 2 == 0) sum -= extract(in, width, last + 1);
+  return sum;
+#else
+  value_type sum = 0;
+  for (size_type i = first; i <= last; ++i) sum += extract(in, width, i);
+  return sum;
+#endif
+}
+
+#if defined(LIB_SIMD_AVX2) || defined(LIB_SIMD_SSE2)
+// Values 2 * pair and 2 * pair + 1 of a block, in the low and high lane.
+inline __m128i packed_int_vector::unpackPair(const word_type *in,
+                                             unsigned width, size_type pair,
+                                             __m128i lane_mask) noexcept {
+  size_type bit = pair * width;
+  const word_type *words = in + bit / 64 * 2;
+  int shift = static_cast<int>(bit % 64);
+  __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i *>(words));
+  __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i *>(words + 2));
+  __m128i value =
+      _mm_or_si128(_mm_srl_epi64(low, _mm_cvtsi32_si128(shift)),
+                   _mm_sll_epi64(high, _mm_cvtsi32_si128(64 - shift)));
+  return _mm_and_si128(value, lane_mask);
+}
+#endif
+
+inline void packed_int_vector::reallocate(word_type *&words, size_type used,
+                                          size_type &capacity,
+                                          size_type fresh_capacity) {
+  word_type *fresh = allocate(fresh_capacity);
+  if (used > 0) std::memcpy(fresh, words, used * sizeof(word_type));
+  release(words);
+  words = fresh;
+  capacity = fresh_capacity;
+}
+
+inline packed_int_vector::word_type *packed_int_vector::allocate(
+    size_type words) {
+  if (words == 0) return nullptr;
+  if (words > std::numeric_limits<std::ptrdiff_t>::max() / sizeof(word_type)) {
+    throw std::length_error("packed_int_vector too long");
+  }
+  return static_cast<word_type *>(
+      ::operator new(words * sizeof(word_type), std::align_val_t(64)));
+}
+
+inline void packed_int_vector::release(word_type *words) noexcept {
+  if (words != nullptr) ::operator delete(words, std::align_val_t(64));
+}
+}  // namespace lib
+
+#endif  // LIB_PACKED_INT_VECTOR_H_
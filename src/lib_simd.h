@@ -0,0 +1,626 @@
+#ifndef LIB_SIMD_H_
+#define LIB_SIMD_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+#include "lib_vector.h"
+
+// The widest instruction set enabled at compile time is used: AVX2 with
+// -mavx2 or -march=native, otherwise SSE2 on x86-64. Element types without a
+// vector implementation, other targets and builds defining LIB_SIMD_DISABLE
+// run the same kernels one element at a time.
+#if !defined(LIB_SIMD_DISABLE) && defined(__AVX2__)
+#define LIB_SIMD_AVX2 1
+#include <immintrin.h>
+#elif !defined(LIB_SIMD_DISABLE) && defined(__SSE2__)
+#define LIB_SIMD_SSE2 1
+#include <emmintrin.h>
+#endif
+
+namespace lib {
+namespace simd {
+// One lane per register: the fallback for every arithmetic type. The
+// SimdTraits specializations below provide the same operations on SIMD
+// registers. Comparison masks carry one bit per lane, lane 0 in bit 0.
+template <typename T>
+struct ScalarTraits {
+  using reg = T;
+  static constexpr std::size_t kLanes = 1;
+
+  static reg load(const T *p) { return *p; }
+  static void store(T *p, reg a) { *p = a; }
+  static reg broadcast(T value) { return value; }
+  static reg add(reg a, reg b) { return a + b; }
+  static reg mul(reg a, reg b) { return a * b; }
+  static reg min(reg a, reg b) { return b < a ? b : a; }
+  static reg max(reg a, reg b) { return a < b ? b : a; }
+  static unsigned equalMask(reg a, reg b) { return a == b; }
+  static unsigned lessMask(reg a, reg b) { return a < b; }
+  static unsigned greaterMask(reg a, reg b) { return b < a; }
+  static T reduceAdd(reg a) { return a; }
+  static T reduceMin(reg a) { return a; }
+  static T reduceMax(reg a) { return a; }
+};
+
+template <typename T>
+struct SimdTraits : ScalarTraits<T> {};
+
+// Reduces the lanes of a register through memory; the compiler turns this
+// into shuffles.
+template <typename T, typename Traits, typename Op>
+T reduceLanes(typename Traits::reg a, Op op) {
+  alignas(32) T lanes[Traits::kLanes];
+  Traits::store(lanes, a);
+  T result = lanes[0];
+  for (std::size_t i = 1; i < Traits::kLanes; ++i) {
+    result = op(result, lanes[i]);
+  }
+  return result;
+}
+
+#if defined(LIB_SIMD_AVX2)
+template <>
+struct SimdTraits<float> {
+  using reg = __m256;
+  static constexpr std::size_t kLanes = 8;
+
+  static reg load(const float *p) { return _mm256_loadu_ps(p); }
+  static void store(float *p, reg a) { _mm256_storeu_ps(p, a); }
+  static reg broadcast(float value) { return _mm256_set1_ps(value); }
+  static reg add(reg a, reg b) { return _mm256_add_ps(a, b); }
+  static reg mul(reg a, reg b) { return _mm256_mul_ps(a, b); }
+  static reg min(reg a, reg b) { return _mm256_min_ps(a, b); }
+  static reg max(reg a, reg b) { return _mm256_max_ps(a, b); }
+  static unsigned equalMask(reg a, reg b) {
+    return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_EQ_OQ));
+  }
+  static unsigned lessMask(reg a, reg b) {
+    return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_LT_OQ));
+  }
+  static unsigned greaterMask(reg a, reg b) {
+    return _mm256_movemask_ps(_mm256_cmp_ps(a, b, _CMP_GT_OQ));
+  }
+  static float reduceAdd(reg a) {
+    __m128 sum =
+        _mm_add_ps(_mm256_castps256_ps128(a), _mm256_extractf128_ps(a, 1));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+    return _mm_cvtss_f32(sum);
+  }
+  static float reduceMin(reg a) {
+    return reduceLanes<float, SimdTraits>(
+        a, [](float x, float y) { return y < x ? y : x; });
+  }
+  static float reduceMax(reg a) {
+    return reduceLanes<float, SimdTraits>(
+        a, [](float x, float y) { return x < y ? y : x; });
+  }
+};
+
+template <>
+struct SimdTraits<double> {
+  using reg = __m256d;
+  static constexpr std::size_t kLanes = 4;
+
+  static reg load(const double *p) { return _mm256_loadu_pd(p); }
+  static void store(double *p, reg a) { _mm256_storeu_pd(p, a); }
+  static reg broadcast(double value) { return _mm256_set1_pd(value); }
+  static reg add(reg a, reg b) { return _mm256_add_pd(a, b); }
+  static reg mul(reg a, reg b) { return _mm256_mul_pd(a, b); }
+  static reg min(reg a, reg b) { return _mm256_min_pd(a, b); }
+  static reg max(reg a, reg b) { return _mm256_max_pd(a, b); }
+  static unsigned equalMask(reg a, reg b) {
+    return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_EQ_OQ));
+  }
+  static unsigned lessMask(reg a, reg b) {
+    return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_LT_OQ));
+  }
+  static unsigned greaterMask(reg a, reg b) {
+    return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_GT_OQ));
+  }
+  static double reduceAdd(reg a) {
+    __m128d sum =
+        _mm_add_pd(_mm256_castpd256_pd128(a), _mm256_extractf128_pd(a, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(sum, _mm_unpackhi_pd(sum, sum)));
+  }
+  static double reduceMin(reg a) {
+    return reduceLanes<double, SimdTraits>(
+        a, [](double x, double y) { return y < x ? y : x; });
+  }
+  static double reduceMax(reg a) {
+    return reduceLanes<double, SimdTraits>(
+        a, [](double x, double y) { return x < y ? y : x; });
+  }
+};
+
+template <>
+struct SimdTraits<std::int32_t> {
+  using reg = __m256i;
+  static constexpr std::size_t kLanes = 8;
+
+  static reg load(const std::int32_t *p) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+  }
+  static void store(std::int32_t *p, reg a) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), a);
+  }
+  static reg broadcast(std::int32_t value) { return _mm256_set1_epi32(value); }
+  static reg add(reg a, reg b) { return _mm256_add_epi32(a, b); }
+  static reg mul(reg a, reg b) { return _mm256_mullo_epi32(a, b); }
+  static reg min(reg a, reg b) { return _mm256_min_epi32(a, b); }
+  static reg max(reg a, reg b) { return _mm256_max_epi32(a, b); }
+  static unsigned equalMask(reg a, reg b) {
+    return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b)));
+  }
+  static unsigned lessMask(reg a, reg b) { return greaterMask(b, a); }
+  static unsigned greaterMask(reg a, reg b) {
+    return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(a, b)));
+  }
+  static std::int32_t reduceAdd(reg a) {
+    __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(a),
+                                _mm256_extracti128_si256(a, 1));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(sum);
+  }
+  static std::int32_t reduceMin(reg a) {
+    return reduceLanes<std::int32_t, SimdTraits>(
+        a, [](std::int32_t x, std::int32_t y) { return y < x ? y : x; });
+  }
+  static std::int32_t reduceMax(reg a) {
+    return reduceLanes<std::int32_t, SimdTraits>(
+        a, [](std::int32_t x, std::int32_t y) { return x < y ? y : x; });
+  }
+};
+
+template <>
+struct SimdTraits<std::int64_t> {
+  using reg = __m256i;
+  static constexpr std::size_t kLanes = 4;
+
+  static reg load(const std::int64_t *p) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+  }
+  static void store(std::int64_t *p, reg a) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(p), a);
+  }
+  static reg broadcast(std::int64_t value) {
+    return _mm256_set1_epi64x(value);
+  }
+  static reg add(reg a, reg b) { return _mm256_add_epi64(a, b); }
+  // AVX2 has no 64-bit multiply: combine three 32 x 32 -> 64 products.
+  static reg mul(reg a, reg b) {
+    reg low = _mm256_mul_epu32(a, b);
+    reg cross = _mm256_add_epi64(
+        _mm256_mul_epu32(_mm256_srli_epi64(a, 32), b),
+        _mm256_mul_epu32(a, _mm256_srli_epi64(b, 32)));
+    return _mm256_add_epi64(low, _mm256_slli_epi64(cross, 32));
+  }
+  static reg min(reg a, reg b) {
+    return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(a, b));
+  }
+  static reg max(reg a, reg b) {
+    return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(b, a));
+  }
+  static unsigned equalMask(reg a, reg b) {
+    return _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(a, b)));
+  }
+  static unsigned lessMask(reg a, reg b) { return greaterMask(b, a); }
+  static unsigned greaterMask(reg a, reg b) {
+    return _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(a, b)));
+  }
+  static std::int64_t reduceAdd(reg a) {
+    __m128i sum = _mm_add_epi64(_mm256_castsi256_si128(a),
+                                _mm256_extracti128_si256(a, 1));
+    return _mm_cvtsi128_si64(_mm_add_epi64(sum, _mm_unpackhi_epi64(sum, sum)));
+  }
+  static std::int64_t reduceMin(reg a) {
+    return reduceLanes<std::int64_t, SimdTraits>(
+        a, [](std::int64_t x, std::int64_t y) { return y < x ? y : x; });
+  }
+  static std::int64_t reduceMax(reg a) {
+    return reduceLanes<std::int64_t, SimdTraits>(
+        a, [](std::int64_t x, std::int64_t y) { return x < y ? y : x; });
+  }
+};
+#elif defined(LIB_SIMD_SSE2)
+template <>
+struct SimdTraits<float> {
+  using reg = __m128;
+  static constexpr std::size_t kLanes = 4;
+
+  static reg load(const float *p) { return _mm_loadu_ps(p); }
+  static void store(float *p, reg a) { _mm_storeu_ps(p, a); }
+  static reg broadcast(float value) { return _mm_set1_ps(value); }
+  static reg add(reg a, reg b) { return _mm_add_ps(a, b); }
+  static reg mul(reg a, reg b) { return _mm_mul_ps(a, b); }
+  static reg min(reg a, reg b) { return _mm_min_ps(a, b); }
+  static reg max(reg a, reg b) { return _mm_max_ps(a, b); }
+  static unsigned equalMask(reg a, reg b) {
+    return _mm_movemask_ps(_mm_cmpeq_ps(a, b));
+  }
+  static unsigned lessMask(reg a, reg b) {
+    return _mm_movemask_ps(_mm_cmplt_ps(a, b));
+  }
+  static unsigned greaterMask(reg a, reg b) {
+    return _mm_movemask_ps(_mm_cmpgt_ps(a, b));
+  }
+  static float reduceAdd(reg a) {
+    reg sum = _mm_add_ps(a, _mm_movehl_ps(a, a));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+    return _mm_cvtss_f32(sum);
+  }
+  static float reduceMin(reg a) {
+    return reduceLanes<float, SimdTraits>(
+        a, [](float x, float y) { return y < x ? y : x; });
+  }
+  static float reduceMax(reg a) {
+    return reduceLanes<float, SimdTraits>(
+        a, [](float x, float y) { return x < y ? y : x; });
+  }
+};
+
+template <>
+struct SimdTraits<double> {
+  using reg = __m128d;
+  static constexpr std::size_t kLanes = 2;
+
+  static reg load(const double *p) { return _mm_loadu_pd(p); }
+  static void store(double *p, reg a) { _mm_storeu_pd(p, a); }
+  static reg broadcast(double value) { return _mm_set1_pd(value); }
+  static reg add(reg a, reg b) { return _mm_add_pd(a, b); }
+  static reg mul(reg a, reg b) { return _mm_mul_pd(a, b); }
+  static reg min(reg a, reg b) { return _mm_min_pd(a, b); }
+  static reg max(reg a, reg b) { return _mm_max_pd(a, b); }
+  static unsigned equalMask(reg a, reg b) {
+    return _mm_movemask_pd(_mm_cmpeq_pd(a, b));
+  }
+  static unsigned lessMask(reg a, reg b) {
+    return _mm_movemask_pd(_mm_cmplt_pd(a, b));
+  }
+  static unsigned greaterMask(reg a, reg b) {
+    return _mm_movemask_pd(_mm_cmpgt_pd(a, b));
+  }
+  static double reduceAdd(reg a) {
+    return _mm_cvtsd_f64(_mm_add_sd(a, _mm_unpackhi_pd(a, a)));
+  }
+  static double reduceMin(reg a) {
+    return reduceLanes<double, SimdTraits>(
+        a, [](double x, double y) { return y < x ? y : x; });
+  }
+  static double reduceMax(reg a) {
+    return reduceLanes<double, SimdTraits>(
+        a, [](double x, double y) { return x < y ? y : x; });
+  }
+};
+
+template <>
+struct SimdTraits<std::int32_t> {
+  using reg = __m128i;
+  static constexpr std::size_t kLanes = 4;
+
+  static reg load(const std::int32_t *p) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+  }
+  static void store(std::int32_t *p, reg a) {
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(p), a);
+  }
+  static reg broadcast(std::int32_t value) { return _mm_set1_epi32(value); }
+  static reg add(reg a, reg b) { return _mm_add_epi32(a, b); }
+  // SSE2 only multiplies even lanes into 64 bits; do odd lanes separately
+  // and interleave the low halves.
+  static reg mul(reg a, reg b) {
+    reg even = _mm_mul_epu32(a, b);
+    reg odd = _mm_mul_epu32(_mm_srli_si128(a, 4), _mm_srli_si128(b, 4));
+    return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)),
+                              _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+  }
+  static reg min(reg a, reg b) { return select(_mm_cmpgt_epi32(a, b), b, a); }
+  static reg max(reg a, reg b) { return select(_mm_cmpgt_epi32(b, a), b, a); }
+  static unsigned equalMask(reg a, reg b) {
+    return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(a, b)));
+  }
+  static unsigned lessMask(reg a, reg b) { return greaterMask(b, a); }
+  static unsigned greaterMask(reg a, reg b) {
+    return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(a, b)));
+  }
+  static std::int32_t reduceAdd(reg a) {
+    reg sum = _mm_add_epi32(a, _mm_shuffle_epi32(a, _MM_SHUFFLE(1, 0, 3, 2)));
+    sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(sum);
+  }
+  static std::int32_t reduceMin(reg a) {
+    return reduceLanes<std::int32_t, SimdTraits>(
+        a, [](std::int32_t x, std::int32_t y) { return y < x ? y : x; });
+  }
+  static std::int32_t reduceMax(reg a) {
+    return reduceLanes<std::int32_t, SimdTraits>(
+        a, [](std::int32_t x, std::int32_t y) { return x < y ? y : x; });
+  }
+
+ private:
+  static reg select(reg mask, reg if_set, reg if_clear) {
+    return _mm_or_si128(_mm_and_si128(mask, if_set),
+                        _mm_andnot_si128(mask, if_clear));
+  }
+};
+#endif
+
+// Number of elements processed per instruction for T in this build.
+template <typename T>
+constexpr std::size_t lanes() noexcept {
+  return SimdTraits<T>::kLanes;
+}
+
+// Value and position of the first smallest or largest element.
+template <typename T>
+struct indexed_value {
+  T value;
+  std::size_t index;
+};
+
+// Position of the first element equal to value, or n if there is none.
+template <typename T>
+std::size_t find(const T *data, std::size_t n, T value) {
+  static_assert(std::is_arithmetic_v<T>, "simd kernels need arithmetic T");
+  using Traits = SimdTraits<T>;
+  constexpr std::size_t kLanes = Traits::kLanes;
+  typename Traits::reg needle = Traits::broadcast(value);
+  std::size_t i = 0;
+  for (; i + kLanes <= n; i += kLanes) {
+    unsigned mask = Traits::equalMask(Traits::load(data + i), needle);
+    if (mask != 0) return i + __builtin_ctz(mask);
+  }
+  for (; i < n; ++i) {
+    if (data[i] == value) return i;
+  }
+  return n;
+}
+
+template <typename T>
+std::size_t count(const T *data, std::size_t n, T value) {
+  static_assert(std::is_arithmetic_v<T>, "simd kernels need arithmetic T");
+  using Traits = SimdTraits<T>;
+  constexpr std::size_t kLanes = Traits::kLanes;
+  typename Traits::reg needle = Traits::broadcast(value);
+  std::size_t result = 0;
+  std::size_t i = 0;
+  for (; i + kLanes <= n; i += kLanes) {
+    result += __builtin_popcount(
+        Traits::equalMask(Traits::load(data + i), needle));
+  }
+  for (; i < n; ++i) result += data[i] == value;
+  return result;
+}
+
+// Sum of the elements. Floating-point values are added lane by lane, so
+// rounding may differ from a sequential loop.
+template <typename T>
+T sum(const T *data, std::size_t n) {
+  static_assert(std::is_arithmetic_v<T>, "simd kernels need arithmetic T");
+  using Traits = SimdTraits<T>;
+  constexpr std::size_t kLanes = Traits::kLanes;
+  typename Traits::reg first = Traits::broadcast(T());
+  typename Traits::reg second = first;
+  std::size_t i = 0;
+  for (; i + 2 * kLanes <= n; i += 2 * kLanes) {
+    first = Traits::add(first, Traits::load(data + i));
+    second = Traits::add(second, Traits::load(data + i + kLanes));
+  }
+  if (i + kLanes <= n) {
+    first = Traits::add(first, Traits::load(data + i));
+    i += kLanes;
+  }
+  T result = Traits::reduceAdd(Traits::add(first, second));
+  for (; i < n; ++i) result += data[i];
+  return result;
+}
+
+// Sum of a[i] * b[i], with the same rounding caveat as sum().
+template <typename T>
+T dot(const T *a, const T *b, std::size_t n) {
+  static_assert(std::is_arithmetic_v<T>, "simd kernels need arithmetic T");
+  using Traits = SimdTraits<T>;
+  constexpr std::size_t kLanes = Traits::kLanes;
+  typename Traits::reg acc = Traits::broadcast(T());
+  std::size_t i = 0;
+  for (; i + kLanes <= n; i += kLanes) {
+    acc = Traits::add(acc,
+                      Traits::mul(Traits::load(a + i), Traits::load(b + i)));
+  }
+  T result = Traits::reduceAdd(acc);
+  for (; i < n; ++i) result += a[i] * b[i];
+  return result;
+}
+
+// The first smallest element of a non-empty range. The result is
+// unspecified if the range holds NaNs.
+template <typename T>
+indexed_value<T> min_with_index(const T *data, std::size_t n) {
+  static_assert(std::is_arithmetic_v<T>, "simd kernels need arithmetic T");
+  using Traits = SimdTraits<T>;
+  constexpr std::size_t kLanes = Traits::kLanes;
+  T best = data[0];
+  std::size_t i = 0;
+  if (n >= kLanes) {
+    typename Traits::reg acc = Traits::load(data);
+    for (i = kLanes; i + kLanes <= n; i += kLanes) {
+      acc = Traits::min(acc, Traits::load(data + i));
+    }
+    best = Traits::reduceMin(acc);
+  }
+  for (; i < n; ++i) {
+    if (data[i] < best) best = data[i];
+  }
+  return {best, find(data, n, best)};
+}
+
+// The first largest element of a non-empty range, as min_with_index.
+template <typename T>
+indexed_value<T> max_with_index(const T *data, std::size_t n) {
+  static_assert(std::is_arithmetic_v<T>, "simd kernels need arithmetic T");
+  using Traits = SimdTraits<T>;
+  constexpr std::size_t kLanes = Traits::kLanes;
+  T best = data[0];
+  std::size_t i = 0;
+  if (n >= kLanes) {
+    typename Traits::reg acc = Traits::load(data);
+    for (i = kLanes; i + kLanes <= n; i += kLanes) {
+      acc = Traits::max(acc, Traits::load(data + i));
+    }
+    best = Traits::reduceMax(acc);
+  }
+  for (; i < n; ++i) {
+    if (best < data[i]) best = data[i];
+  }
+  return {best, find(data, n, best)};
+}
+
+// Limits every element to [lo, hi] in place.
+template <typename T>
+void clamp(T *data, std::size_t n, T lo, T hi) {
+  static_assert(std::is_arithmetic_v<T>, "simd kernels need arithmetic T");
+  using Traits = SimdTraits<T>;
+  constexpr std::size_t kLanes = Traits::kLanes;
+  typename Traits::reg low = Traits::broadcast(lo);
+  typename Traits::reg high = Traits::broadcast(hi);
+  std::size_t i = 0;
+  for (; i + kLanes <= n; i += kLanes) {
+    Traits::store(data + i,
+                  Traits::min(Traits::max(Traits::load(data + i), low), high));
+  }
+  for (; i < n; ++i) {
+    if (data[i] < lo) data[i] = lo;
+    if (hi < data[i]) data[i] = hi;
+  }
+}
+
+enum class CompareOp { kEqual, kLess, kGreater };
+
+template <CompareOp Op, typename Traits>
+unsigned laneMask(typename Traits::reg a, typename Traits::reg b) {
+  if constexpr (Op == CompareOp::kEqual) {
+    return Traits::equalMask(a, b);
+  } else if constexpr (Op == CompareOp::kLess) {
+    return Traits::lessMask(a, b);
+  } else {
+    return Traits::greaterMask(a, b);
+  }
+}
+
+// Writes one bit per element, set where element Op value holds, into
+// (n + 63) / 64 words: element i goes to bit i % 64 of word i / 64 and the
+// bits past n are zero.
+template <CompareOp Op, typename T>
+void compareMask(const T *data, std::size_t n, T value, std::uint64_t *mask) {
+  static_assert(std::is_arithmetic_v<T>, "simd kernels need arithmetic T");
+  using Traits = SimdTraits<T>;
+  using Scalar = ScalarTraits<T>;
+  constexpr std::size_t kLanes = Traits::kLanes;
+  typename Traits::reg operand = Traits::broadcast(value);
+  for (std::size_t base = 0; base < n; base += 64) {
+    std::size_t end = n - base < 64 ? n : base + 64;
+    std::uint64_t bits = 0;
+    std::size_t i = base;
+    for (; i + kLanes <= end; i += kLanes) {
+      bits |= std::uint64_t(laneMask<Op, Traits>(Traits::load(data + i),
+                                                 operand))
+              << (i - base);
+    }
+    for (; i < end; ++i) {
+      bits |= std::uint64_t(laneMask<Op, Scalar>(data[i], value)) << (i - base);
+    }
+    mask[base / 64] = bits;
+  }
+}
+
+template <typename T>
+void equal_mask(const T *data, std::size_t n, T value, std::uint64_t *mask) {
+  compareMask<CompareOp::kEqual>(data, n, value, mask);
+}
+
+template <typename T>
+void less_mask(const T *data, std::size_t n, T value, std::uint64_t *mask) {
+  compareMask<CompareOp::kLess>(data, n, value, mask);
+}
+
+template <typename T>
+void greater_mask(const T *data, std::size_t n, T value, std::uint64_t *mask) {
+  compareMask<CompareOp::kGreater>(data, n, value, mask);
+}
+
+// Overloads for lib::vector, lib::array, lib::span and any other container
+// with contiguous data() and size(). Views may be passed as temporaries.
+template <typename Container>
+using ValueOf = std::remove_const_t<
+    typename std::remove_reference_t<Container>::value_type>;
+
+template <typename Container>
+std::size_t find(Container &&c, const ValueOf<Container> &value) {
+  return find(c.data(), c.size(), value);
+}
+
+template <typename Container>
+std::size_t count(Container &&c, const ValueOf<Container> &value) {
+  return count(c.data(), c.size(), value);
+}
+
+template <typename Container>
+ValueOf<Container> sum(Container &&c) {
+  return sum(c.data(), c.size());
+}
+
+// a and b must have the same size.
+template <typename A, typename B>
+ValueOf<A> dot(A &&a, B &&b) {
+  return dot(a.data(), b.data(), a.size());
+}
+
+template <typename Container>
+indexed_value<ValueOf<Container>> min_with_index(Container &&c) {
+  return min_with_index(c.data(), c.size());
+}
+
+template <typename Container>
+indexed_value<ValueOf<Container>> max_with_index(Container &&c) {
+  return max_with_index(c.data(), c.size());
+}
+
+template <typename Container>
+void clamp(Container &&c, const ValueOf<Container> &lo,
+           const ValueOf<Container> &hi) {
+  clamp(c.data(), c.size(), lo, hi);
+}
+
+template <CompareOp Op, typename Container>
+vector<std::uint64_t> compareMask(Container &&c,
+                                  const ValueOf<Container> &value) {
+  vector<std::uint64_t> mask((c.size() + 63) / 64);
+  compareMask<Op>(c.data(), c.size(), value, mask.data());
+  return mask;
+}
+
+template <typename Container>
+vector<std::uint64_t> equal_mask(Container &&c,
+                                 const ValueOf<Container> &value) {
+  return compareMask<CompareOp::kEqual>(c, value);
+}
+
+template <typename Container>
+vector<std::uint64_t> less_mask(Container &&c,
+                                const ValueOf<Container> &value) {
+  return compareMask<CompareOp::kLess>(c, value);
+}
+
+template <typename Container>
+vector<std::uint64_t> greater_mask(Container &&c,
+                                   const ValueOf<Container> &value) {
+  return compareMask<CompareOp::kGreater>(c, value);
+}
+}  // namespace simd
+}  // namespace lib
+
+#endif  // LIB_SIMD_H_
@@ -0,0 +1,395 @@
+#ifndef LIB_SMALL_MAP_H_
+#define LIB_SMALL_MAP_H_
+
+#include <limits>
+#include <new>
+#include <optional>
+#include <stdexcept>
+
+#include "lib_map.h"
+#include "lib_set.h"
+
+namespace lib {
+// Keeps up to N values in a sorted array inside the object and searches it
+// linearly. Inserting past N moves everything into the Large tree container,
+// which stays in use until clear(). Until then nothing is allocated.
+// KeyOf::key(value) returns the key of a stored value.
+template <typename Value, typename Key, typename KeyOf, typename Large,
+          std::size_t N>
+class SmallTree {
+  static_assert(N > 0, "inline capacity must be positive");
+
+  template <typename V, typename TreeIterator>
+  class SmallIterator;
+
+ public:
+  using value_type = Value;
+  using reference = Value&;
+  using const_reference = const Value&;
+  using size_type = std::size_t;
+  using iterator = SmallIterator<Value, typename Large::iterator>;
+  using const_iterator =
+      SmallIterator<const Value, typename Large::const_iterator>;
+
+  SmallTree() : size_(0) {}
+  SmallTree(const SmallTree& other) : size_(0) { copyFrom_(other); }
+  SmallTree(SmallTree&& other) : size_(0) { moveFrom_(other); }
+  ~SmallTree() { destroyInline_(); }
+
+  SmallTree& operator=(const SmallTree& other) {
+    if (this != &other) {
+      clear();
+      copyFrom_(other);
+    }
+    return *this;
+  }
+
+  SmallTree& operator=(SmallTree&& other) {
+    if (this != &other) {
+      clear();
+      moveFrom_(other);
+    }
+    return *this;
+  }
+
+  iterator begin() noexcept {
+    return large_ ? iterator(large_->begin()) : iterator(data_());
+  }
+
+  iterator end() noexcept {
+    return large_ ? iterator(large_->end()) : iterator(data_() + size_);
+  }
+
+  const_iterator begin() const noexcept {
+    return large_ ? const_iterator(large_->begin()) : const_iterator(data_());
+  }
+
+  const_iterator end() const noexcept {
+    return large_ ? const_iterator(large_->end())
+                  : const_iterator(data_() + size_);
+  }
+
+  bool empty() const noexcept { return size() == 0; }
+  size_type size() const noexcept { return large_ ? large_->size() : size_; }
+
+  size_type max_size() const noexcept {
+    return std::numeric_limits<size_type>::max() / sizeof(value_type);
+  }
+
+  // True while the values live in the inline array.
+  bool is_inline() const noexcept { return !large_; }
+  static constexpr size_type inline_capacity() noexcept { return N; }
+
+  void clear() {
+    destroyInline_();
+    large_.reset();
+  }
+
+  void erase(iterator pos) { eraseAt_(pos); }
+
+  bool contains(const Key& key) const {
+    return large_ ? large_->contains(key) : findInline_(key) != size_;
+  }
+
+  void swap(SmallTree& other) {
+    SmallTree temp(std::move(other));
+    other = std::move(*this);
+    *this = std::move(temp);
+  }
+
+  // Moves into this container every value of other whose key is absent here.
+  void merge(SmallTree& other) {
+    if (this == &other) return;
+    iterator it = other.begin();
+    while (it != other.end()) {
+      if (insertUnique_(*it).second)
+        it = other.eraseAt_(it);
+      else
+        ++it;
+    }
+  }
+
+  template <typename... Args>
+  vector<std::pair<iterator, bool>> insert_many(Args&&... args) {
+    vector<std::pair<iterator, bool>> result;
+    result.reserve(sizeof...(args));
+    (result.push_back(insertUnique_(value_type(std::forward<Args>(args)))),
+     ...);
+    return result;
+  }
+
+ protected:
+  value_type* data_() noexcept {
+    return std::launder(reinterpret_cast<value_type*>(buffer_));
+  }
+
+  const value_type* data_() const noexcept {
+    return std::launder(reinterpret_cast<const value_type*>(buffer_));
+  }
+
+  // Index of the inline value with the given key, or size_ if absent.
+  size_type findInline_(const Key& key) const {
+    size_type pos = lowerBound_(key);
+    if (pos < size_ && !(key < KeyOf::key(data_()[pos]))) return pos;
+    return size_;
+  }
+
+  std::pair<iterator, bool> insertUnique_(const value_type& value) {
+    if (large_) return large_->insert(value);
+    const Key& key = KeyOf::key(value);
+    size_type pos = lowerBound_(key);
+    value_type* data = data_();
+    if (pos < size_ && !(key < KeyOf::key(data[pos])))
+      return {iterator(data + pos), false};
+    if (size_ == N) {
+      spill_();
+      return large_->insert(value);
+    }
+    value_type item(value);
+    if (pos < size_) {
+      new (data + size_) value_type(std::move(data[size_ - 1]));
+      for (size_type i = size_ - 1; i > pos; --i) {
+        data[i].~value_type();
+        new (data + i) value_type(std::move(data[i - 1]));
+      }
+      data[pos].~value_type();
+    }
+    new (data + pos) value_type(std::move(item));
+    ++size_;
+    return {iterator(data + pos), true};
+  }
+
+  // Erases pos and returns the iterator following it.
+  iterator eraseAt_(iterator pos) {
+    if (large_) {
+      iterator next = pos;
+      ++next;
+      large_->erase(pos.tree_);
+      return next;
+    }
+    value_type* data = data_();
+    size_type index = pos.ptr_ - data;
+    data[index].~value_type();
+    for (size_type i = index + 1; i < size_; ++i) {
+      new (data + i - 1) value_type(std::move(data[i]));
+      data[i].~value_type();
+    }
+    --size_;
+    return iterator(data + index);
+  }
+
+  std::optional<Large> large_;
+
+ private:
+  size_type lowerBound_(const Key& key) const {
+    size_type pos = 0;
+    while (pos < size_ && KeyOf::key(data_()[pos]) < key) ++pos;
+    return pos;
+  }
+
+  void spill_() {
+    large_.emplace();
+    value_type* data = data_();
+    for (size_type i = 0; i < size_; ++i) large_->insert(data[i]);
+    destroyInline_();
+  }
+
+  void destroyInline_() noexcept {
+    value_type* data = data_();
+    for (size_type i = 0; i < size_; ++i) data[i].~value_type();
+    size_ = 0;
+  }
+
+  void copyFrom_(const SmallTree& other) {
+    if (other.large_) {
+      large_.emplace(*other.large_);
+    } else {
+      for (; size_ < other.size_; ++size_) {
+        new (data_() + size_) value_type(other.data_()[size_]);
+      }
+    }
+  }
+
+  void moveFrom_(SmallTree& other) {
+    if (other.large_) {
+      large_.emplace(std::move(*other.large_));
+      other.large_.reset();
+    } else {
+      for (; size_ < other.size_; ++size_) {
+        new (data_() + size_) value_type(std::move(other.data_()[size_]));
+      }
+      other.destroyInline_();
+    }
+  }
+
+  alignas(value_type) unsigned char buffer_[N * sizeof(value_type)];
+  size_type size_;
+};
+
+// Points either into the inline array (ptr_ set) or into the tree.
+template <typename Value, typename Key, typename KeyOf, typename Large,
+          std::size_t N>
+template <typename V, typename TreeIterator>
+class SmallTree<Value, Key, KeyOf, Large, N>::SmallIterator {
+  friend SmallTree;
+  template <typename, typename>
+  friend class SmallIterator;
+
+ public:
+  SmallIterator() : ptr_(nullptr), tree_() {}
+  explicit SmallIterator(V* ptr) : ptr_(ptr), tree_() {}
+  SmallIterator(TreeIterator tree) : ptr_(nullptr), tree_(tree) {}
+
+  template <typename OtherV, typename OtherTreeIterator>
+  SmallIterator(const SmallIterator<OtherV, OtherTreeIterator>& other)
+      : ptr_(other.ptr_), tree_(other.tree_) {}
+
+  V& operator*() { return ptr_ ? *ptr_ : *tree_; }
+
+  SmallIterator& operator++() {
+    if (ptr_)
+      ++ptr_;
+    else
+      ++tree_;
+    return *this;
+  }
+
+  SmallIterator operator++(int) {
+    SmallIterator temp(*this);
+    ++(*this);
+    return temp;
+  }
+
+  SmallIterator& operator--() {
+    if (ptr_)
+      --ptr_;
+    else
+      --tree_;
+    return *this;
+  }
+
+  SmallIterator operator--(int) {
+    SmallIterator temp(*this);
+    --(*this);
+    return temp;
+  }
+
+  bool operator==(const SmallIterator& other) const {
+    return ptr_ == other.ptr_ && (ptr_ != nullptr || tree_ == other.tree_);
+  }
+
+  bool operator!=(const SmallIterator& other) const {
+    return !(*this == other);
+  }
+
+ private:
+  V* ptr_;
+  TreeIterator tree_;
+};
+
+template <typename Key>
+struct SmallSetKey {
+  static const Key& key(const Key& value) { return value; }
+};
+
+template <typename Key, std::size_t N = 8>
+class small_set : public SmallTree<Key, Key, SmallSetKey<Key>, set<Key>, N> {
+  using Base = SmallTree<Key, Key, SmallSetKey<Key>, set<Key>, N>;
+
+ public:
+  using typename Base::const_iterator;
+  using typename Base::const_reference;
+  using typename Base::iterator;
+  using typename Base::value_type;
+  using key_type = Key;
+
+  small_set() = default;
+
+  small_set(std::initializer_list<value_type> const& items) {
+    for (const auto& item : items) insert(item);
+  }
+
+  std::pair<iterator, bool> insert(const_reference key) {
+    return this->insertUnique_(key);
+  }
+
+  iterator find(const Key& key) {
+    if (this->large_) return this->large_->find(key);
+    return iterator(this->data_() + this->findInline_(key));
+  }
+
+  const_iterator find(const Key& key) const {
+    if (this->large_) {
+      const set<Key>& large = *this->large_;
+      return large.find(key);
+    }
+    return const_iterator(this->data_() + this->findInline_(key));
+  }
+};
+
+template <typename Key, typename T>
+struct SmallMapKey {
+  static const Key& key(const std::pair<const Key, T>& value) {
+    return value.first;
+  }
+};
+
+template <typename Key, typename T, std::size_t N = 8>
+class small_map : public SmallTree<std::pair<const Key, T>, Key,
+                                   SmallMapKey<Key, T>, map<Key, T>, N> {
+  using Base = SmallTree<std::pair<const Key, T>, Key, SmallMapKey<Key, T>,
+                         map<Key, T>, N>;
+
+ public:
+  using typename Base::iterator;
+  using typename Base::value_type;
+  using key_type = Key;
+  using mapped_type = T;
+
+  small_map() = default;
+
+  small_map(std::initializer_list<value_type> const& items) {
+    for (const auto& item : items) insert(item);
+  }
+
+  T& at(const Key& key) {
+    if (this->large_) return this->large_->at(key);
+    std::size_t pos = this->findInline_(key);
+    if (pos == this->size()) throw std::out_of_range("Key not found");
+    return this->data_()[pos].second;
+  }
+
+  const T& at(const Key& key) const {
+    if (this->large_) {
+      const map<Key, T>& large = *this->large_;
+      return large.at(key);
+    }
+    std::size_t pos = this->findInline_(key);
+    if (pos == this->size()) throw std::out_of_range("Key not found");
+    return this->data_()[pos].second;
+  }
+
+  T& operator[](const Key& key) {
+    if (this->large_) return (*this->large_)[key];
+    std::size_t pos = this->findInline_(key);
+    if (pos != this->size()) return this->data_()[pos].second;
+    return (*insert(key, T()).first).second;
+  }
+
+  std::pair<iterator, bool> insert(const value_type& value) {
+    return this->insertUnique_(value);
+  }
+
+  std::pair<iterator, bool> insert(const Key& key, const T& obj) {
+    return this->insertUnique_(value_type{key, obj});
+  }
+
+  std::pair<iterator, bool> insert_or_assign(const Key& key, const T& obj) {
+    std::pair<iterator, bool> res = insert(key, obj);
+    if (!res.second) (*res.first).second = obj;
+    return res;
+  }
+};
+}  // namespace lib
+
+#endif  // LIB_SMALL_MAP_H_
@@ -0,0 +1,24 @@
+#ifndef LIB_SMALL_VECTOR_H_
+#define LIB_SMALL_VECTOR_H_
+
+#include "lib_vector.h"
+
+namespace lib {
+// vector that keeps up to N elements inside the object and only allocates
+// once it has to hold more. Shrinking back to N or fewer elements returns to
+// the inline buffer on shrink_to_fit(). Moving an inline small_vector moves
+// its elements one by one instead of handing over a pointer.
+template <typename T, std::size_t N = 8, typename Growth = doubling_growth>
+class small_vector : public BasicVector<T, N, Growth, alignof(T)> {
+  static_assert(N > 0, "inline capacity must be positive");
+
+ public:
+  using BasicVector<T, N, Growth, alignof(T)>::BasicVector;
+
+  // True while the elements live in the inline buffer.
+  bool is_inline() const noexcept { return this->isInline(); }
+  static constexpr std::size_t inline_capacity() noexcept { return N; }
+};
+}  // namespace lib
+
+#endif  // LIB_SMALL_VECTOR_H_
@@ -0,0 +1,456 @@
+#ifndef LIB_SOA_VECTOR_H_
+#define LIB_SOA_VECTOR_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "lib_span.h"
+#include "lib_vector.h"
+
+namespace lib {
+// Sequence of rows of Fields... stored column by column: each field has its
+// own contiguous array, aligned to a cache line, and all columns share one
+// size and capacity. A loop that reads one field streams through exactly
+// that field's bytes; column<I>() hands the array to such loops. Rows are
+// accessed through tuples of references, so structured bindings and
+// std::get work on them, and they convert to row_type for a copy.
+//
+// Columns are moved on reallocation, so every field must be nothrow move
+// constructible.
+template <typename... Fields>
+class soa_vector {
+  static_assert(sizeof...(Fields) > 0, "soa_vector needs at least one field");
+  static_assert((std::is_nothrow_move_constructible_v<Fields> && ...),
+                "soa_vector fields must be nothrow move constructible");
+
+  using Columns = std::tuple<Fields *...>;
+  using Indices = std::index_sequence_for<Fields...>;
+
+ public:
+  using row_type = std::tuple<Fields...>;
+  using reference = std::tuple<Fields &...>;
+  using const_reference = std::tuple<const Fields &...>;
+  using size_type = std::size_t;
+  template <std::size_t I>
+  using field_type = std::tuple_element_t<I, row_type>;
+
+  static constexpr std::size_t kColumnAlignment = 64;
+
+  soa_vector() noexcept;
+  explicit soa_vector(size_type n);
+  soa_vector(std::initializer_list<row_type> rows);
+  soa_vector(const soa_vector &v);
+  soa_vector(soa_vector &&v) noexcept;
+  ~soa_vector();
+  soa_vector &operator=(soa_vector &&v) noexcept;
+
+  reference operator[](size_type pos) { return rowAt(pos, Indices()); }
+  const_reference operator[](size_type pos) const {
+    return rowAt(pos, Indices());
+  }
+  reference at(size_type pos);
+  const_reference at(size_type pos) const;
+  reference front() { return (*this)[0]; }
+  reference back() { return (*this)[size_ - 1]; }
+
+  // The I-th field of every row, as one array.
+  template <std::size_t I>
+  field_type<I> *data() noexcept {
+    return std::get<I>(columns_);
+  }
+  template <std::size_t I>
+  const field_type<I> *data() const noexcept {
+    return std::get<I>(columns_);
+  }
+  template <std::size_t I>
+  span<field_type<I>> column() noexcept {
+    return span<field_type<I>>(data<I>(), size_);
+  }
+  template <std::size_t I>
+  span<const field_type<I>> column() const noexcept {
+    return span<const field_type<I>>(data<I>(), size_);
+  }
+
+  bool empty() const noexcept { return size_ == 0; }
+  size_type size() const noexcept { return size_; }
+  size_type capacity() const noexcept { return capacity_; }
+  size_type max_size() const noexcept;
+  void reserve(size_type n);
+  void shrink_to_fit();
+
+  void clear() noexcept;
+  void push_back(const row_type &row);
+  void push_back(row_type &&row);
+  // Builds a row from one argument per field.
+  template <typename... Args>
+  reference emplace_back(Args &&...args);
+  // Appends whole rows (row_type or anything a row_type is built from).
+  // Rows must not refer to this soa_vector's own elements. If building a row
+  // throws, none of them is kept.
+  template <typename... Rows>
+  void insert_many_back(Rows &&...rows);
+  void pop_back();
+  void swap(soa_vector &other) noexcept;
+
+ private:
+  template <std::size_t... I>
+  reference rowAt(size_type pos, std::index_sequence<I...>) {
+    return reference(std::get<I>(columns_)[pos]...);
+  }
+  template <std::size_t... I>
+  const_reference rowAt(size_type pos, std::index_sequence<I...>) const {
+    return const_reference(std::get<I>(columns_)[pos]...);
+  }
+
+  template <typename Tuple>
+  void appendRow(Tuple &&values);
+  template <typename Tuple, std::size_t... I>
+  static void constructRow(const Columns &columns, size_type pos,
+                           Tuple &&values, std::index_sequence<I...>);
+  template <std::size_t... I>
+  static void destroyFields(const Columns &columns, size_type pos,
+                            size_type count, std::index_sequence<I...>);
+  void reallocate(size_type capacity);
+  void moveInto(const Columns &columns) noexcept;
+  void relocateColumns(const Columns &columns) noexcept;
+  void destroyRows(size_type from) noexcept;
+  void deallocate() noexcept;
+
+  static Columns allocateColumns(size_type n);
+  static void releaseColumns(const Columns &columns) noexcept;
+  template <typename F>
+  static void allocateColumn(F *&column, size_type n);
+  template <typename F>
+  static void releaseColumn(F *column) noexcept;
+  template <typename F>
+  static constexpr std::size_t columnAlignment() {
+    return std::max(kColumnAlignment, alignof(F));
+  }
+
+  static constexpr bool kTrivial =
+      (std::is_trivially_copyable_v<Fields> && ...);
+
+  Columns columns_;
+  size_type size_;
+  size_type capacity_;
+};
+
+template <typename... Fields>
+soa_vector<Fields...>::soa_vector() noexcept
+    : columns_(), size_(0), capacity_(0) {}
+
+template <typename... Fields>
+soa_vector<Fields...>::soa_vector(size_type n) : soa_vector() {
+  reserve(n);
+  try {
+    for (; size_ < n; ++size_) {
+      constructRow(columns_, size_, row_type(), Indices());
+    }
+  } catch (...) {
+    deallocate();
+    throw;
+  }
+}
+
+template <typename... Fields>
+soa_vector<Fields...>::soa_vector(std::initializer_list<row_type> rows)
+    : soa_vector() {
+  reserve(rows.size());
+  try {
+    for (const auto &row : rows) {
+      constructRow(columns_, size_, row, Indices());
+      ++size_;
+    }
+  } catch (...) {
+    deallocate();
+    throw;
+  }
+}
+
+template <typename... Fields>
+soa_vector<Fields...>::soa_vector(const soa_vector &v) : soa_vector() {
+  reserve(v.size_);
+  if (v.size_ == 0) return;
+  if constexpr (kTrivial) {
+    std::apply(
+        [&](auto *...to) {
+          std::apply(
+              [&](auto *...from) {
+                (std::memcpy(to, from, v.size_ * sizeof(*from)), ...);
+              },
+              v.columns_);
+        },
+        columns_);
+    size_ = v.size_;
+  } else {
+    try {
+      for (; size_ < v.size_; ++size_) {
+        constructRow(columns_, size_, v[size_], Indices());
+      }
+    } catch (...) {
+      deallocate();
+      throw;
+    }
+  }
+}
+
+template <typename... Fields>
+soa_vector<Fields...>::soa_vector(soa_vector &&v) noexcept
+    : columns_(std::exchange(v.columns_, Columns())),
+      size_(std::exchange(v.size_, 0)),
+      capacity_(std::exchange(v.capacity_, 0)) {}
+
+template <typename... Fields>
+soa_vector<Fields...>::~soa_vector() {
+  deallocate();
+}
+
+template <typename... Fields>
+soa_vector<Fields...> &soa_vector<Fields...>::operator=(
+    soa_vector &&v) noexcept {
+  if (this != &v) {
+    deallocate();
+    columns_ = std::exchange(v.columns_, Columns());
+    size_ = std::exchange(v.size_, 0);
+    capacity_ = std::exchange(v.capacity_, 0);
+  }
+  return *this;
+}
+
+template <typename... Fields>
+typename soa_vector<Fields...>::reference soa_vector<Fields...>::at(
+    size_type pos) {
+  if (pos >= size_) throw std::out_of_range("Index out of range");
+  return (*this)[pos];
+}
+
+template <typename... Fields>
+typename soa_vector<Fields...>::const_reference soa_vector<Fields...>::at(
+    size_type pos) const {
+  if (pos >= size_) throw std::out_of_range("Index out of range");
+  return (*this)[pos];
+}
+
+// A row costs the sum of its field sizes, spread over the columns.
+template <typename... Fields>
+typename soa_vector<Fields...>::size_type soa_vector<Fields...>::max_size()
+    const noexcept {
+  return std::numeric_limits<std::ptrdiff_t>::max() /
+         std::max({sizeof(Fields)...});
+}
+
+template <typename... Fields>
+void soa_vector<Fields...>::reserve(size_type n) {
+  if (n > capacity_) reallocate(n);
+}
+
+template <typename... Fields>
+void soa_vector<Fields...>::shrink_to_fit() {
+  if (size_ < capacity_) reallocate(size_);
+}
+
+template <typename... Fields>
+void soa_vector<Fields...>::clear() noexcept {
+  destroyRows(0);
+}
+
+template <typename... Fields>
+void soa_vector<Fields...>::push_back(const row_type &row) {
+  appendRow(row);
+}
+
+template <typename... Fields>
+void soa_vector<Fields...>::push_back(row_type &&row) {
+  appendRow(std::move(row));
+}
+
+template <typename... Fields>
+template <typename... Args>
+typename soa_vector<Fields...>::reference soa_vector<Fields...>::emplace_back(
+    Args &&...args) {
+  static_assert(sizeof...(Args) == sizeof...(Fields),
+                "emplace_back takes one argument per field");
+  appendRow(std::forward_as_tuple(std::forward<Args>(args)...));
+  return back();
+}
+
+template <typename... Fields>
+template <typename... Rows>
+void soa_vector<Fields...>::insert_many_back(Rows &&...rows) {
+  size_type needed = size_ + sizeof...(rows);
+  if (needed > capacity_) {
+    reserve(doubling_growth::next(capacity_, needed));
+  }
+  // Reserved above, so no append reallocates and a throw undoes them all.
+  size_type old_size = size_;
+  try {
+    (appendRow(std::forward<Rows>(rows)), ...);
+  } catch (...) {
+    destroyRows(old_size);
+    throw;
+  }
+}
+
+template <typename... Fields>
+void soa_vector<Fields...>::pop_back() {
+  --size_;
+  destroyFields(columns_, size_, sizeof...(Fields), Indices());
+}
+
+template <typename... Fields>
+void soa_vector<Fields...>::swap(soa_vector &other) noexcept {
+  std::swap(columns_, other.columns_);
+  std::swap(size_, other.size_);
+  std::swap(capacity_, other.capacity_);
+}
+
+// When the row does not fit, it is built in the new columns before the old
+// ones are released, so values may refer to elements of this soa_vector.
+template <typename... Fields>
+template <typename Tuple>
+void soa_vector<Fields...>::appendRow(Tuple &&values) {
+  if (size_ < capacity_) {
+    constructRow(columns_, size_, std::forward<Tuple>(values), Indices());
+  } else {
+    size_type capacity = doubling_growth::next(capacity_, size_ + 1);
+    Columns columns = allocateColumns(capacity);
+    try {
+      constructRow(columns, size_, std::forward<Tuple>(values), Indices());
+    } catch (...) {
+      releaseColumns(columns);
+      throw;
+    }
+    moveInto(columns);
+    capacity_ = capacity;
+  }
+  ++size_;
+}
+
+// Builds field I at pos from std::get<I>(values); a throwing field destroys
+// the ones already built.
+template <typename... Fields>
+template <typename Tuple, std::size_t... I>
+void soa_vector<Fields...>::constructRow(const Columns &columns, size_type pos,
+                                         Tuple &&values,
+                                         std::index_sequence<I...>) {
+  size_type built = 0;
+  try {
+    ((new (std::get<I>(columns) + pos)
+          field_type<I>(std::get<I>(std::forward<Tuple>(values))),
+      ++built),
+     ...);
+  } catch (...) {
+    destroyFields(columns, pos, built, Indices());
+    throw;
+  }
+}
+
+// Destroys the first count fields of the row at pos.
+template <typename... Fields>
+template <std::size_t... I>
+void soa_vector<Fields...>::destroyFields(const Columns &columns,
+                                          size_type pos, size_type count,
+                                          std::index_sequence<I...>) {
+  ((I < count ? std::destroy_at(std::get<I>(columns) + pos) : void()), ...);
+}
+
+template <typename... Fields>
+void soa_vector<Fields...>::reallocate(size_type capacity) {
+  if (capacity > max_size()) throw std::length_error("soa_vector too long");
+  Columns columns = allocateColumns(capacity);
+  moveInto(columns);
+  capacity_ = capacity;
+}
+
+// Moves the rows into columns, releases the old ones and adopts columns.
+template <typename... Fields>
+void soa_vector<Fields...>::moveInto(const Columns &columns) noexcept {
+  if (size_ > 0) relocateColumns(columns);
+  releaseColumns(columns_);
+  columns_ = columns;
+}
+
+template <typename... Fields>
+void soa_vector<Fields...>::relocateColumns(const Columns &columns) noexcept {
+  std::apply(
+      [&](auto *...to) {
+        std::apply(
+            [&](auto *...from) {
+              if constexpr (kTrivial) {
+                (std::memcpy(to, from, size_ * sizeof(*from)), ...);
+              } else {
+                (std::uninitialized_move(from, from + size_, to), ...);
+                (std::destroy(from, from + size_), ...);
+              }
+            },
+            columns_);
+      },
+      columns);
+}
+
+template <typename... Fields>
+void soa_vector<Fields...>::destroyRows(size_type from) noexcept {
+  if constexpr (!kTrivial) {
+    std::apply(
+        [&](auto *...column) {
+          (std::destroy(column + from, column + size_), ...);
+        },
+        columns_);
+  }
+  size_ = from;
+}
+
+template <typename... Fields>
+void soa_vector<Fields...>::deallocate() noexcept {
+  destroyRows(0);
+  releaseColumns(columns_);
+  columns_ = Columns();
+  capacity_ = 0;
+}
+
+// Allocates every column or none.
+template <typename... Fields>
+typename soa_vector<Fields...>::Columns soa_vector<Fields...>::allocateColumns(
+    size_type n) {
+  Columns columns;
+  if (n == 0) return columns;
+  try {
+    std::apply([n](auto *&...column) { (allocateColumn(column, n), ...); },
+               columns);
+  } catch (...) {
+    releaseColumns(columns);
+    throw;
+  }
+  return columns;
+}
+
+template <typename... Fields>
+void soa_vector<Fields...>::releaseColumns(const Columns &columns) noexcept {
+  std::apply([](auto *...column) { (releaseColumn(column), ...); }, columns);
+}
+
+template <typename... Fields>
+template <typename F>
+void soa_vector<Fields...>::allocateColumn(F *&column, size_type n) {
+  column = static_cast<F *>(
+      ::operator new(n * sizeof(F), std::align_val_t(columnAlignment<F>())));
+}
+
+template <typename... Fields>
+template <typename F>
+void soa_vector<Fields...>::releaseColumn(F *column) noexcept {
+  if (column == nullptr) return;
+  ::operator delete(column, std::align_val_t(columnAlignment<F>()));
+}
+}  // namespace lib
+
+#endif  // LIB_SOA_VECTOR_H_
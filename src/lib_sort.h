@@ -0,0 +1,382 @@
+#ifndef LIB_SORT_H_
+#define LIB_SORT_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Sorting kernels behind vector::sort, vector::stable_sort,
+// vector::sort_by_key, lib::sort and lib::parallel_sort.
+//
+// Comparison sorts are introsort (median-of-three quicksort that switches to
+// heapsort when the recursion gets too deep, insertion sort below 16
+// elements) and a top-down merge sort with a buffer of half the range. For
+// integer and floating-point keys compared with std::less or std::greater,
+// an LSD radix sort with 8-bit digits takes over from kRadixMinSize
+// elements: one pass over the data builds every histogram, digits shared by
+// all keys are skipped, and the sort is stable.
+namespace lib {
+namespace sort_detail {
+constexpr std::size_t kInsertionCutoff = 16;
+constexpr std::size_t kMergeCutoff = 32;
+constexpr std::size_t kRadixMinSize = 512;
+
+// Maps keys to unsigned integers that sort in the same order: signed
+// integers get their sign bit flipped, negative floating-point values all
+// their bits and positive ones the sign bit. NaNs end up at either end.
+template <typename T, typename = void>
+struct RadixKey {
+  static constexpr bool kSortable = false;
+};
+
+template <typename T>
+struct RadixKey<T, std::enable_if_t<std::is_integral_v<T> &&
+                                    !std::is_same_v<T, bool>>> {
+  static constexpr bool kSortable = true;
+  using type = std::make_unsigned_t<T>;
+
+  static type get(T value) noexcept {
+    type key = static_cast<type>(value);
+    if constexpr (std::is_signed_v<T>) {
+      key ^= type(1) << (sizeof(type) * 8 - 1);
+    }
+    return key;
+  }
+};
+
+template <typename T, typename Bits>
+struct FloatRadixKey {
+  static constexpr bool kSortable = true;
+  using type = Bits;
+
+  static type get(T value) noexcept {
+    // -0.0 and +0.0 compare equal, so stable sorts must keep their order.
+    if (value == T(0)) value = T(0);
+    type key;
+    std::memcpy(&key, &value, sizeof(key));
+    constexpr type kSign = type(1) << (sizeof(type) * 8 - 1);
+    return key & kSign ? ~key : key | kSign;
+  }
+};
+
+template <>
+struct RadixKey<float> : FloatRadixKey<float, std::uint32_t> {};
+template <>
+struct RadixKey<double> : FloatRadixKey<double, std::uint64_t> {};
+
+template <typename Compare, typename T>
+constexpr bool kIsLess = std::is_same_v<Compare, std::less<>> ||
+                         std::is_same_v<Compare, std::less<T>>;
+
+template <typename Compare, typename T>
+constexpr bool kIsGreater = std::is_same_v<Compare, std::greater<>> ||
+                            std::is_same_v<Compare, std::greater<T>>;
+
+// Stable LSD radix sort of items[0, n) by keyOf(item), an unsigned integer,
+// using buffer[0, n) as scratch space.
+template <typename Item, typename KeyOf>
+void radixSort(Item *items, Item *buffer, std::size_t n, KeyOf keyOf) {
+  using Key = decltype(keyOf(*items));
+  constexpr std::size_t kDigits = sizeof(Key);
+  std::size_t counts[kDigits][256] = {};
+  for (std::size_t i = 0; i < n; ++i) {
+    Key key = keyOf(items[i]);
+    for (std::size_t d = 0; d < kDigits; ++d) {
+      ++counts[d][(key >> (8 * d)) & 0xff];
+    }
+  }
+
+  Item *from = items;
+  Item *to = buffer;
+  Key first_key = keyOf(items[0]);
+  for (std::size_t d = 0; d < kDigits; ++d) {
+    std::size_t *count = counts[d];
+    if (count[(first_key >> (8 * d)) & 0xff] == n) continue;
+    std::size_t offset = 0;
+    for (std::size_t digit = 0; digit < 256; ++digit) {
+      std::size_t digit_count = count[digit];
+      count[digit] = offset;
+      offset += digit_count;
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+      to[count[(keyOf(from[i]) >> (8 * d)) & 0xff]++] = std::move(from[i]);
+    }
+    std::swap(from, to);
+  }
+  if (from != items) std::move(from, from + n, items);
+}
+
+// Radix sorts arithmetic values in ascending or descending order.
+template <typename T>
+void radixSortValues(T *first, std::size_t n, bool descending) {
+  std::unique_ptr<T[]> buffer(new T[n]);
+  if (descending) {
+    radixSort(first, buffer.get(), n,
+              [](T value) {
+                using Key = typename RadixKey<T>::type;
+                return Key(~RadixKey<T>::get(value));
+              });
+  } else {
+    radixSort(first, buffer.get(), n,
+              [](T value) { return RadixKey<T>::get(value); });
+  }
+}
+
+template <typename RandomIt, typename Compare>
+void insertionSort(RandomIt first, RandomIt last, Compare &comp) {
+  if (first == last) return;
+  for (RandomIt i = first + 1; i != last; ++i) {
+    auto value = std::move(*i);
+    if (comp(value, *first)) {
+      std::move_backward(first, i, i + 1);
+      *first = std::move(value);
+    } else {
+      // *first is not greater than value, so the scan stops there.
+      RandomIt j = i;
+      for (; comp(value, *(j - 1)); --j) *j = std::move(*(j - 1));
+      *j = std::move(value);
+    }
+  }
+}
+
+template <typename RandomIt, typename Compare>
+void moveMedianToFirst(RandomIt result, RandomIt a, RandomIt b, RandomIt c,
+                       Compare &comp) {
+  if (comp(*a, *b)) {
+    if (comp(*b, *c))
+      std::iter_swap(result, b);
+    else if (comp(*a, *c))
+      std::iter_swap(result, c);
+    else
+      std::iter_swap(result, a);
+  } else if (comp(*a, *c)) {
+    std::iter_swap(result, a);
+  } else if (comp(*b, *c)) {
+    std::iter_swap(result, c);
+  } else {
+    std::iter_swap(result, b);
+  }
+}
+
+// Hoare partition around *first. The median-of-three leaves an element no
+// smaller and one no larger than the pivot in the range, so neither scan
+// needs a bounds check.
+template <typename RandomIt, typename Compare>
+RandomIt hoarePartition(RandomIt first, RandomIt last, Compare &comp) {
+  RandomIt left = first + 1;
+  RandomIt right = last;
+  while (true) {
+    while (comp(*left, *first)) ++left;
+    --right;
+    while (comp(*first, *right)) --right;
+    if (!(left < right)) return left;
+    std::iter_swap(left, right);
+    ++left;
+  }
+}
+
+// Leaves ranges of up to kInsertionCutoff elements for a final insertion
+// sort. Recurses into the right part and loops on the left one.
+template <typename RandomIt, typename Compare>
+void introsortLoop(RandomIt first, RandomIt last, std::size_t depth,
+                   Compare &comp) {
+  while (std::size_t(last - first) > kInsertionCutoff) {
+    if (depth == 0) {
+      std::make_heap(first, last, comp);
+      std::sort_heap(first, last, comp);
+      return;
+    }
+    --depth;
+    moveMedianToFirst(first, first + 1, first + (last - first) / 2, last - 1,
+                      comp);
+    RandomIt cut = hoarePartition(first, last, comp);
+    introsortLoop(cut, last, depth, comp);
+    last = cut;
+  }
+}
+
+template <typename RandomIt, typename Compare>
+void introsort(RandomIt first, RandomIt last, Compare comp) {
+  std::size_t n = last - first;
+  if (n < 2) return;
+  std::size_t depth = 0;
+  for (std::size_t size = n; size > 1; size >>= 1) depth += 2;
+  introsortLoop(first, last, depth, comp);
+  insertionSort(first, last, comp);
+}
+
+// Uninitialized storage for the merge sort buffer.
+template <typename T>
+class RawBuffer {
+ public:
+  explicit RawBuffer(std::size_t n)
+      : p_(std::allocator<T>().allocate(n)), n_(n) {}
+  RawBuffer(const RawBuffer &) = delete;
+  RawBuffer &operator=(const RawBuffer &) = delete;
+  ~RawBuffer() { std::allocator<T>().deallocate(p_, n_); }
+
+  T *get() const noexcept { return p_; }
+
+ private:
+  T *p_;
+  std::size_t n_;
+};
+
+// Destroys the first n elements of a buffer when a merge ends, even through
+// an exception.
+template <typename T>
+struct BufferElements {
+  T *p;
+  std::size_t n;
+  ~BufferElements() { std::destroy(p, p + n); }
+};
+
+// Stable merge of [first, mid) and [mid, last): the left half is moved out
+// to buffer and merged back, taking from it on ties.
+template <typename RandomIt, typename T, typename Compare>
+void mergeWithBuffer(RandomIt first, RandomIt mid, RandomIt last, T *buffer,
+                     Compare &comp) {
+  if (!comp(*mid, *(mid - 1))) return;
+  std::uninitialized_move(first, mid, buffer);
+  BufferElements<T> left{buffer, std::size_t(mid - first)};
+  T *from = buffer;
+  T *from_end = buffer + left.n;
+  RandomIt out = first;
+  while (from != from_end && mid != last) {
+    if (comp(*mid, *from))
+      *out++ = std::move(*mid++);
+    else
+      *out++ = std::move(*from++);
+  }
+  std::move(from, from_end, out);
+}
+
+template <typename RandomIt, typename T, typename Compare>
+void mergeSortLoop(RandomIt first, RandomIt last, T *buffer, Compare &comp) {
+  std::size_t n = last - first;
+  if (n <= kMergeCutoff) {
+    insertionSort(first, last, comp);
+    return;
+  }
+  RandomIt mid = first + n / 2;
+  mergeSortLoop(first, mid, buffer, comp);
+  mergeSortLoop(mid, last, buffer, comp);
+  mergeWithBuffer(first, mid, last, buffer, comp);
+}
+
+template <typename RandomIt, typename Compare>
+void mergeSort(RandomIt first, RandomIt last, Compare comp) {
+  using T = typename std::iterator_traits<RandomIt>::value_type;
+  std::size_t n = last - first;
+  if (n <= kMergeCutoff) {
+    insertionSort(first, last, comp);
+    return;
+  }
+  RawBuffer<T> buffer(n / 2);
+  mergeSortLoop(first, last, buffer.get(), comp);
+}
+
+template <typename RandomIt, typename Compare>
+constexpr bool kRadixSortable =
+    std::is_pointer_v<RandomIt> &&
+    RadixKey<typename std::iterator_traits<RandomIt>::value_type>::kSortable &&
+    (kIsLess<Compare, typename std::iterator_traits<RandomIt>::value_type> ||
+     kIsGreater<Compare, typename std::iterator_traits<RandomIt>::value_type>);
+
+// True if every element is smaller than the one before. Reversing such a
+// range sorts it, stably since no two elements are equal.
+template <typename RandomIt, typename Compare>
+bool isStrictlyDescending(RandomIt first, RandomIt last, Compare &comp) {
+  if (first == last) return true;
+  for (RandomIt next = first + 1; next != last; ++first, ++next) {
+    if (!comp(*next, *first)) return false;
+  }
+  return true;
+}
+
+// Returns at once for ranges already in order or in strictly reverse order,
+// which costs one comparison on most other inputs. Radix sorts large ranges
+// of numbers under std::less or std::greater and calls comparison_sort for
+// everything else.
+template <typename RandomIt, typename Compare, typename ComparisonSort>
+void sortDispatch(RandomIt first, RandomIt last, Compare comp,
+                  ComparisonSort comparison_sort) {
+  using T = typename std::iterator_traits<RandomIt>::value_type;
+  if (std::is_sorted(first, last, comp)) return;
+  if (isStrictlyDescending(first, last, comp)) {
+    std::reverse(first, last);
+    return;
+  }
+  if constexpr (kRadixSortable<RandomIt, Compare>) {
+    std::size_t n = last - first;
+    if (n >= kRadixMinSize) {
+      radixSortValues(first, n, kIsGreater<Compare, T>);
+      return;
+    }
+  }
+  comparison_sort(first, last, comp);
+}
+
+template <typename RandomIt, typename Compare>
+void sort(RandomIt first, RandomIt last, Compare comp) {
+  sortDispatch(first, last, comp, [](RandomIt f, RandomIt l, Compare &c) {
+    introsort(f, l, c);
+  });
+}
+
+template <typename RandomIt, typename Compare>
+void stableSort(RandomIt first, RandomIt last, Compare comp) {
+  sortDispatch(first, last, comp, [](RandomIt f, RandomIt l, Compare &c) {
+    mergeSort(f, l, c);
+  });
+}
+
+template <typename Key>
+struct KeyedIndex {
+  Key key;
+  std::size_t index;
+};
+
+// Stable sort of [first, first + n) by key(element). Numeric keys of
+// elements that move without throwing are radix sorted together with the
+// element positions, and the elements are then moved once into their final
+// places; otherwise the keys are compared in a merge sort.
+template <typename T, typename Projection>
+void sortByKey(T *first, std::size_t n, Projection &key) {
+  using Key = std::decay_t<std::invoke_result_t<Projection &, const T &>>;
+  if constexpr (RadixKey<Key>::kSortable &&
+                std::is_nothrow_move_constructible_v<T> &&
+                std::is_nothrow_move_assignable_v<T>) {
+    if (n >= kRadixMinSize) {
+      using Item = KeyedIndex<typename RadixKey<Key>::type>;
+      std::unique_ptr<Item[]> items(new Item[2 * n]);
+      for (std::size_t i = 0; i < n; ++i) {
+        items[i] = {RadixKey<Key>::get(key(first[i])), i};
+      }
+      radixSort(items.get(), items.get() + n, n,
+                [](const Item &item) { return item.key; });
+      RawBuffer<T> buffer(n);
+      T *sorted = buffer.get();
+      for (std::size_t i = 0; i < n; ++i) {
+        new (sorted + i) T(std::move(first[items[i].index]));
+      }
+      std::move(sorted, sorted + n, first);
+      std::destroy(sorted, sorted + n);
+      return;
+    }
+  }
+  mergeSort(first, first + n, [&key](const T &a, const T &b) {
+    return key(a) < key(b);
+  });
+}
+}  // namespace sort_detail
+}  // namespace lib
+
+#endif  // LIB_SORT_H_
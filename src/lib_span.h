@@ -0,0 +1,333 @@
+#ifndef LIB_SPAN_H_
+#define LIB_SPAN_H_
+
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "lib_array.h"
+
+namespace lib {
+inline constexpr std::size_t dynamic_extent = static_cast<std::size_t>(-1);
+
+namespace span_detail {
+// A span of fixed extent keeps only the pointer.
+template <typename T, std::size_t Extent>
+class SpanStorage {
+ protected:
+  constexpr SpanStorage(T *data, std::size_t) noexcept : data_(data) {}
+  constexpr std::size_t count() const noexcept { return Extent; }
+
+  T *data_;
+};
+
+template <typename T>
+class SpanStorage<T, dynamic_extent> {
+ protected:
+  constexpr SpanStorage(T *data, std::size_t size) noexcept
+      : data_(data), size_(size) {}
+  constexpr std::size_t count() const noexcept { return size_; }
+
+  T *data_;
+  std::size_t size_;
+};
+
+// Containers a span can view: contiguous data() convertible to T *, and
+// size().
+template <typename Container, typename T, typename = void>
+struct IsViewable : std::false_type {};
+
+template <typename Container, typename T>
+struct IsViewable<
+    Container, T,
+    std::void_t<decltype(std::declval<Container &>().size()),
+                decltype(std::declval<Container &>().data())>>
+    : std::bool_constant<
+          std::is_convertible_v<decltype(std::declval<Container &>().data()),
+                                T *> &&
+          std::is_same_v<std::remove_cv_t<std::remove_pointer_t<decltype(
+                             std::declval<Container &>().data())>>,
+                         std::remove_cv_t<T>>> {};
+}  // namespace span_detail
+
+// Non-owning view of size() contiguous elements starting at data(): a
+// lib::vector, lib::array, soa_vector column or any other container with
+// data() and size(), or a part of one. Copying a span copies the pointer
+// and the size, never the elements. With a fixed Extent the size is part
+// of the type and is not stored.
+//
+// at(), first(), last() and subspan() throw std::out_of_range for ranges
+// past the end; operator[] does not check.
+template <typename T, std::size_t Extent = dynamic_extent>
+class span : private span_detail::SpanStorage<T, Extent> {
+  using Storage = span_detail::SpanStorage<T, Extent>;
+
+ public:
+  using element_type = T;
+  using value_type = std::remove_cv_t<T>;
+  using reference = T &;
+  using pointer = T *;
+  using iterator = T *;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+
+  static constexpr size_type extent = Extent;
+
+  template <std::size_t E = Extent,
+            typename = std::enable_if_t<E == dynamic_extent || E == 0>>
+  constexpr span() noexcept : Storage(nullptr, 0) {}
+  // For a fixed extent, size must equal Extent.
+  constexpr span(T *data, size_type size) noexcept : Storage(data, size) {}
+  template <typename Container,
+            typename = std::enable_if_t<
+                Extent == dynamic_extent &&
+                span_detail::IsViewable<Container, T>::value>>
+  constexpr span(Container &c) : Storage(c.data(), c.size()) {}
+  template <typename U, std::size_t N,
+            typename = std::enable_if_t<
+                (Extent == dynamic_extent || Extent == N) &&
+                std::is_convertible_v<U (*)[], T (*)[]>>>
+  constexpr span(array<U, N> &a) : Storage(a.data(), N) {}
+  // span<T> from span<T, N>, and span<const T> from span<T>.
+  template <typename U, std::size_t N,
+            typename = std::enable_if_t<
+                (Extent == dynamic_extent || Extent == N) &&
+                std::is_convertible_v<U (*)[], T (*)[]>>>
+  constexpr span(const span<U, N> &other) noexcept
+      : Storage(other.data(), other.size()) {}
+
+  constexpr T *data() const noexcept { return this->data_; }
+  constexpr size_type size() const noexcept { return this->count(); }
+  constexpr size_type size_bytes() const noexcept { return size() * sizeof(T); }
+  constexpr bool empty() const noexcept { return size() == 0; }
+
+  constexpr reference operator[](size_type pos) const { return data()[pos]; }
+  constexpr reference at(size_type pos) const;
+  constexpr reference front() const { return data()[0]; }
+  constexpr reference back() const { return data()[size() - 1]; }
+  constexpr iterator begin() const noexcept { return data(); }
+  constexpr iterator end() const noexcept { return data() + size(); }
+
+  constexpr span<T> first(size_type count) const;
+  constexpr span<T> last(size_type count) const;
+  // count == dynamic_extent runs to the end.
+  constexpr span<T> subspan(size_type offset,
+                            size_type count = dynamic_extent) const;
+
+  template <std::size_t Count>
+  constexpr span<T, Count> first() const;
+  template <std::size_t Count>
+  constexpr span<T, Count> last() const;
+
+ private:
+  constexpr void checkRange(size_type offset, size_type count) const;
+};
+
+template <typename T>
+span(T *, std::size_t) -> span<T>;
+template <typename T, std::size_t N>
+span(array<T, N> &) -> span<T, N>;
+template <typename Container>
+span(Container &) -> span<std::remove_pointer_t<
+    decltype(std::declval<Container &>().data())>>;
+
+template <typename T, std::size_t Extent>
+constexpr typename span<T, Extent>::reference span<T, Extent>::at(
+    size_type pos) const {
+  if (pos >= size()) throw std::out_of_range("Index out of range");
+  return data()[pos];
+}
+
+template <typename T, std::size_t Extent>
+constexpr span<T> span<T, Extent>::first(size_type count) const {
+  checkRange(0, count);
+  return span<T>(data(), count);
+}
+
+template <typename T, std::size_t Extent>
+constexpr span<T> span<T, Extent>::last(size_type count) const {
+  checkRange(0, count);
+  return span<T>(data() + size() - count, count);
+}
+
+template <typename T, std::size_t Extent>
+constexpr span<T> span<T, Extent>::subspan(size_type offset,
+                                           size_type count) const {
+  if (offset > size()) throw std::out_of_range("Index out of range");
+  if (count == dynamic_extent) count = size() - offset;
+  checkRange(offset, count);
+  return span<T>(data() + offset, count);
+}
+
+template <typename T, std::size_t Extent>
+template <std::size_t Count>
+constexpr span<T, Count> span<T, Extent>::first() const {
+  static_assert(Extent == dynamic_extent || Count <= Extent,
+                "first<Count>() past the end of the span");
+  checkRange(0, Count);
+  return span<T, Count>(data(), Count);
+}
+
+template <typename T, std::size_t Extent>
+template <std::size_t Count>
+constexpr span<T, Count> span<T, Extent>::last() const {
+  static_assert(Extent == dynamic_extent || Count <= Extent,
+                "last<Count>() past the end of the span");
+  checkRange(0, Count);
+  return span<T, Count>(data() + size() - Count, Count);
+}
+
+template <typename T, std::size_t Extent>
+constexpr void span<T, Extent>::checkRange(size_type offset,
+                                           size_type count) const {
+  if (offset > size() || count > size() - offset) {
+    throw std::out_of_range("Index out of range");
+  }
+}
+
+// Non-owning view of size() elements spaced stride() elements apart, such
+// as one column of a row-major matrix or one channel of interleaved
+// samples. A negative stride walks backwards from data().
+template <typename T>
+class strided_view {
+ public:
+  using element_type = T;
+  using value_type = std::remove_cv_t<T>;
+  using reference = T &;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+
+  class iterator;
+
+  constexpr strided_view() noexcept : data_(nullptr), size_(0), stride_(1) {}
+  constexpr strided_view(T *data, size_type size,
+                         difference_type stride) noexcept
+      : data_(data), size_(size), stride_(stride) {}
+  // Every stride-th element of s, starting with the first; stride > 0.
+  template <std::size_t Extent>
+  constexpr strided_view(span<T, Extent> s, difference_type stride) noexcept
+      : data_(s.data()),
+        size_(s.empty() ? 0 : (s.size() - 1) / stride + 1),
+        stride_(stride) {}
+
+  constexpr T *data() const noexcept { return data_; }
+  constexpr size_type size() const noexcept { return size_; }
+  constexpr difference_type stride() const noexcept { return stride_; }
+  constexpr bool empty() const noexcept { return size_ == 0; }
+
+  constexpr reference operator[](size_type pos) const {
+    return data_[difference_type(pos) * stride_];
+  }
+  constexpr reference at(size_type pos) const {
+    if (pos >= size_) throw std::out_of_range("Index out of range");
+    return (*this)[pos];
+  }
+  constexpr iterator begin() const noexcept {
+    return iterator(data_, 0, stride_);
+  }
+  constexpr iterator end() const noexcept {
+    return iterator(data_, difference_type(size_), stride_);
+  }
+
+ private:
+  T *data_;
+  size_type size_;
+  difference_type stride_;
+};
+
+template <typename T, std::size_t Extent>
+strided_view(span<T, Extent>, std::ptrdiff_t) -> strided_view<T>;
+
+// Holds the view's first element and an index, so that no pointer is
+// formed past the ends of the underlying array.
+template <typename T>
+class strided_view<T>::iterator {
+ public:
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = std::remove_cv_t<T>;
+  using difference_type = std::ptrdiff_t;
+  using pointer = T *;
+  using reference = T &;
+
+  constexpr iterator() noexcept : data_(nullptr), index_(0), stride_(1) {}
+  constexpr iterator(T *data, difference_type index,
+                     difference_type stride) noexcept
+      : data_(data), index_(index), stride_(stride) {}
+
+  constexpr reference operator*() const { return data_[index_ * stride_]; }
+  constexpr pointer operator->() const { return &**this; }
+  constexpr reference operator[](difference_type n) const {
+    return data_[(index_ + n) * stride_];
+  }
+
+  constexpr iterator &operator++() noexcept {
+    ++index_;
+    return *this;
+  }
+  constexpr iterator operator++(int) noexcept {
+    return iterator(data_, index_++, stride_);
+  }
+  constexpr iterator &operator--() noexcept {
+    --index_;
+    return *this;
+  }
+  constexpr iterator operator--(int) noexcept {
+    return iterator(data_, index_--, stride_);
+  }
+  constexpr iterator &operator+=(difference_type n) noexcept {
+    index_ += n;
+    return *this;
+  }
+  constexpr iterator &operator-=(difference_type n) noexcept {
+    index_ -= n;
+    return *this;
+  }
+  friend constexpr iterator operator+(iterator it, difference_type n) noexcept {
+    return it += n;
+  }
+  friend constexpr iterator operator+(difference_type n, iterator it) noexcept {
+    return it += n;
+  }
+  friend constexpr iterator operator-(iterator it, difference_type n) noexcept {
+    return it -= n;
+  }
+  friend constexpr difference_type operator-(const iterator &a,
+                                             const iterator &b) noexcept {
+    return a.index_ - b.index_;
+  }
+
+  friend constexpr bool operator==(const iterator &a,
+                                   const iterator &b) noexcept {
+    return a.index_ == b.index_;
+  }
+  friend constexpr bool operator!=(const iterator &a,
+                                   const iterator &b) noexcept {
+    return a.index_ != b.index_;
+  }
+  friend constexpr bool operator<(const iterator &a,
+                                  const iterator &b) noexcept {
+    return a.index_ < b.index_;
+  }
+  friend constexpr bool operator>(const iterator &a,
+                                  const iterator &b) noexcept {
+    return a.index_ > b.index_;
+  }
+  friend constexpr bool operator<=(const iterator &a,
+                                   const iterator &b) noexcept {
+    return a.index_ <= b.index_;
+  }
+  friend constexpr bool operator>=(const iterator &a,
+                                   const iterator &b) noexcept {
+    return a.index_ >= b.index_;
+  }
+
+ private:
+  T *data_;
+  difference_type index_;
+  difference_type stride_;
+};
+}  // namespace lib
+
+#endif  // LIB_SPAN_H_
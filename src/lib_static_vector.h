@@ -0,0 +1,374 @@
+#ifndef LIB_STATIC_VECTOR_H_
+#define LIB_STATIC_VECTOR_H_
+
+#include <cstddef>
+#include <initializer_list>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace lib {
+namespace static_vector_detail {
+enum class Kind { kTrivial, kTriviallyCopyable, kManaged };
+
+template <typename T>
+constexpr Kind kindOf() {
+  if (std::is_trivial_v<T>) return Kind::kTrivial;
+  if (std::is_trivially_copyable_v<T>) return Kind::kTriviallyCopyable;
+  return Kind::kManaged;
+}
+
+// Selects the constructor that zeroes trivial slots, which constant
+// evaluation needs because it cannot copy uninitialized objects.
+struct zeroed_t {};
+inline constexpr zeroed_t zeroed{};
+
+// Trivial elements live in a plain array. The compiler-generated copies
+// are then one memcpy and constant expressions can use the storage. The
+// default constructor leaves the slots uninitialized.
+template <typename T, std::size_t N, Kind K = kindOf<T>()>
+class Storage {
+ protected:
+  Storage() noexcept : size_(0) {}
+  constexpr explicit Storage(zeroed_t) noexcept : slots_{}, size_(0) {}
+
+  constexpr T *slots() noexcept { return slots_; }
+  constexpr const T *slots() const noexcept { return slots_; }
+
+  T slots_[N];
+  std::size_t size_;
+};
+
+// Trivially copyable elements without a trivial default constructor live
+// in raw bytes, still copied as one block.
+template <typename T, std::size_t N>
+class Storage<T, N, Kind::kTriviallyCopyable> {
+ protected:
+  Storage() noexcept : size_(0) {}
+  explicit Storage(zeroed_t) noexcept : size_(0) {}
+
+  T *slots() noexcept { return reinterpret_cast<T *>(bytes_); }
+  const T *slots() const noexcept {
+    return reinterpret_cast<const T *>(bytes_);
+  }
+
+  alignas(T) unsigned char bytes_[N * sizeof(T)];
+  std::size_t size_;
+};
+
+// Any other element type is constructed and destroyed one by one.
+template <typename T, std::size_t N>
+class Storage<T, N, Kind::kManaged> {
+ protected:
+  Storage() noexcept : size_(0) {}
+  explicit Storage(zeroed_t) noexcept : size_(0) {}
+  Storage(const Storage &other) : size_(0) { copyFrom(other); }
+  Storage(Storage &&other) noexcept(std::is_nothrow_move_constructible_v<T>)
+      : size_(0) {
+    moveFrom(other);
+  }
+  ~Storage() { destroyFrom(0); }
+  Storage &operator=(const Storage &other) {
+    if (this != &other) {
+      destroyFrom(0);
+      copyFrom(other);
+    }
+    return *this;
+  }
+  Storage &operator=(Storage &&other) noexcept(
+      std::is_nothrow_move_constructible_v<T>) {
+    if (this != &other) {
+      destroyFrom(0);
+      moveFrom(other);
+    }
+    return *this;
+  }
+
+  T *slots() noexcept { return reinterpret_cast<T *>(bytes_); }
+  const T *slots() const noexcept {
+    return reinterpret_cast<const T *>(bytes_);
+  }
+  void destroyFrom(std::size_t from) noexcept {
+    for (std::size_t i = from; i < size_; ++i) slots()[i].~T();
+    size_ = from;
+  }
+
+  alignas(T) unsigned char bytes_[N * sizeof(T)];
+  std::size_t size_;
+
+ private:
+  // size_ counts the elements built so far, so a throwing copy leaves a
+  // consistent prefix that the caller's cleanup destroys.
+  void copyFrom(const Storage &other) {
+    try {
+      for (; size_ < other.size_; ++size_) {
+        new (slots() + size_) T(other.slots()[size_]);
+      }
+    } catch (...) {
+      destroyFrom(0);
+      throw;
+    }
+  }
+  // The moved-from elements stay in other, as after a vector's move of
+  // elements one by one.
+  void moveFrom(Storage &other) {
+    try {
+      for (; size_ < other.size_; ++size_) {
+        new (slots() + size_) T(std::move(other.slots()[size_]));
+      }
+    } catch (...) {
+      destroyFrom(0);
+      throw;
+    }
+  }
+};
+}  // namespace static_vector_detail
+
+// vector with room for N elements inside the object and no heap storage at
+// all, for bounded buffers on hot paths. Elements are constructed only as
+// they are added, and size() counts them. Adding past N throws
+// std::length_error and leaves the vector unchanged; try_push_back()
+// returns false instead.
+//
+// A static_vector of trivial elements is trivially copyable, its default
+// constructor leaves the storage uninitialized, and every member except
+// that constructor works in constant expressions. Start those from a
+// braced list, which may be empty: static_vector<int, 8> v({}).
+template <typename T, std::size_t N>
+class static_vector : private static_vector_detail::Storage<T, N> {
+  static_assert(N > 0, "capacity must be positive");
+
+  using Storage = static_vector_detail::Storage<T, N>;
+
+ public:
+  using value_type = T;
+  using reference = T &;
+  using const_reference = const T &;
+  using iterator = T *;
+  using const_iterator = const T *;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+
+  static_vector() noexcept {}
+  constexpr static_vector(std::initializer_list<value_type> items);
+
+  constexpr reference operator[](size_type pos) { return data()[pos]; }
+  constexpr const_reference operator[](size_type pos) const {
+    return data()[pos];
+  }
+  constexpr reference at(size_type pos);
+  constexpr const_reference at(size_type pos) const;
+  constexpr reference front() { return data()[0]; }
+  constexpr const_reference front() const { return data()[0]; }
+  constexpr reference back() { return data()[this->size_ - 1]; }
+  constexpr const_reference back() const { return data()[this->size_ - 1]; }
+  constexpr T *data() noexcept { return this->slots(); }
+  constexpr const T *data() const noexcept { return this->slots(); }
+
+  constexpr iterator begin() noexcept { return data(); }
+  constexpr iterator end() noexcept { return data() + this->size_; }
+  constexpr const_iterator begin() const noexcept { return data(); }
+  constexpr const_iterator end() const noexcept {
+    return data() + this->size_;
+  }
+
+  constexpr bool empty() const noexcept { return this->size_ == 0; }
+  constexpr bool full() const noexcept { return this->size_ == N; }
+  constexpr size_type size() const noexcept { return this->size_; }
+  static constexpr size_type capacity() noexcept { return N; }
+  static constexpr size_type max_size() noexcept { return N; }
+
+  constexpr void push_back(const_reference value) { emplace_back(value); }
+  constexpr void push_back(value_type &&value) {
+    emplace_back(std::move(value));
+  }
+  // push_back() that returns false instead of throwing when full.
+  constexpr bool try_push_back(const_reference value);
+  constexpr bool try_push_back(value_type &&value);
+  template <typename... Args>
+  constexpr reference emplace_back(Args &&...args);
+  constexpr void pop_back();
+
+  constexpr iterator insert(const_iterator pos, const_reference value) {
+    return emplace(pos, value);
+  }
+  constexpr iterator insert(const_iterator pos, value_type &&value) {
+    return emplace(pos, std::move(value));
+  }
+  template <typename... Args>
+  constexpr iterator emplace(const_iterator pos, Args &&...args);
+  constexpr iterator erase(const_iterator pos) { return erase(pos, pos + 1); }
+  constexpr iterator erase(const_iterator first, const_iterator last);
+  // Appends every argument, or none when they do not all fit.
+  template <typename... Args>
+  constexpr void insert_many_back(Args &&...args);
+  constexpr void clear() noexcept { erase(begin(), end()); }
+
+ private:
+  template <typename... Args>
+  constexpr void construct(T *slot, Args &&...args);
+  constexpr void destroy(T *slot) noexcept;
+  constexpr void requireRoom(size_type count) const;
+  template <typename... Args>
+  void appendAllOrNone(Args &&...args);
+};
+
+template <typename T, std::size_t N>
+constexpr static_vector<T, N>::static_vector(
+    std::initializer_list<value_type> items)
+    : Storage(static_vector_detail::zeroed) {
+  requireRoom(items.size());
+  for (const_reference item : items) {
+    construct(data() + this->size_, item);
+    ++this->size_;
+  }
+}
+
+template <typename T, std::size_t N>
+constexpr typename static_vector<T, N>::reference static_vector<T, N>::at(
+    size_type pos) {
+  if (pos >= this->size_) throw std::out_of_range("Index out of range");
+  return data()[pos];
+}
+
+template <typename T, std::size_t N>
+constexpr typename static_vector<T, N>::const_reference
+static_vector<T, N>::at(size_type pos) const {
+  if (pos >= this->size_) throw std::out_of_range("Index out of range");
+  return data()[pos];
+}
+
+template <typename T, std::size_t N>
+constexpr bool static_vector<T, N>::try_push_back(const_reference value) {
+  if (full()) return false;
+  construct(end(), value);
+  ++this->size_;
+  return true;
+}
+
+template <typename T, std::size_t N>
+constexpr bool static_vector<T, N>::try_push_back(value_type &&value) {
+  if (full()) return false;
+  construct(end(), std::move(value));
+  ++this->size_;
+  return true;
+}
+
+template <typename T, std::size_t N>
+template <typename... Args>
+constexpr typename static_vector<T, N>::reference
+static_vector<T, N>::emplace_back(Args &&...args) {
+  requireRoom(1);
+  construct(end(), std::forward<Args>(args)...);
+  return data()[this->size_++];
+}
+
+template <typename T, std::size_t N>
+constexpr void static_vector<T, N>::pop_back() {
+  destroy(data() + --this->size_);
+}
+
+// The new element is built first, since args may refer to an element about
+// to be shifted. The last element is then moved into the free slot, and the
+// rest shift up by assignment.
+template <typename T, std::size_t N>
+template <typename... Args>
+constexpr typename static_vector<T, N>::iterator static_vector<T, N>::emplace(
+    const_iterator pos, Args &&...args) {
+  size_type offset = pos - begin();
+  requireRoom(1);
+  if (offset == this->size_) {
+    emplace_back(std::forward<Args>(args)...);
+    return begin() + offset;
+  }
+  value_type item(std::forward<Args>(args)...);
+  T *p = data();
+  construct(p + this->size_, std::move(p[this->size_ - 1]));
+  ++this->size_;
+  for (size_type i = this->size_ - 2; i > offset; --i) {
+    p[i] = std::move(p[i - 1]);
+  }
+  p[offset] = std::move(item);
+  return begin() + offset;
+}
+
+template <typename T, std::size_t N>
+constexpr typename static_vector<T, N>::iterator static_vector<T, N>::erase(
+    const_iterator first, const_iterator last) {
+  size_type offset = first - begin();
+  size_type count = last - first;
+  T *p = data();
+  for (size_type i = offset; i + count < this->size_; ++i) {
+    p[i] = std::move(p[i + count]);
+  }
+  for (size_type i = this->size_ - count; i < this->size_; ++i) destroy(p + i);
+  this->size_ -= count;
+  return begin() + offset;
+}
+
+template <typename T, std::size_t N>
+template <typename... Args>
+constexpr void static_vector<T, N>::insert_many_back(Args &&...args) {
+  requireRoom(sizeof...(args));
+  if constexpr ((std::is_nothrow_constructible_v<T, Args &&> && ...)) {
+    ((construct(end(), std::forward<Args>(args)), ++this->size_), ...);
+  } else {
+    appendAllOrNone(std::forward<Args>(args)...);
+  }
+}
+
+// Trivial slots are assigned rather than constructed in place, which
+// constant evaluation does not allow.
+template <typename T, std::size_t N>
+template <typename... Args>
+constexpr void static_vector<T, N>::construct(T *slot, Args &&...args) {
+  if constexpr (std::is_trivial_v<T>) {
+    *slot = T(std::forward<Args>(args)...);
+  } else {
+    new (slot) T(std::forward<Args>(args)...);
+  }
+}
+
+template <typename T, std::size_t N>
+constexpr void static_vector<T, N>::destroy(T *slot) noexcept {
+  if constexpr (!std::is_trivially_destructible_v<T>) slot->~T();
+}
+
+template <typename T, std::size_t N>
+constexpr void static_vector<T, N>::requireRoom(size_type count) const {
+  if (count > N - this->size_) {
+    throw std::length_error("static_vector capacity exceeded");
+  }
+}
+
+template <typename T, std::size_t N>
+template <typename... Args>
+void static_vector<T, N>::appendAllOrNone(Args &&...args) {
+  size_type old_size = this->size_;
+  try {
+    ((construct(end(), std::forward<Args>(args)), ++this->size_), ...);
+  } catch (...) {
+    erase(begin() + old_size, end());
+    throw;
+  }
+}
+
+template <typename T, std::size_t N>
+constexpr bool operator==(const static_vector<T, N> &a,
+                          const static_vector<T, N> &b) {
+  if (a.size() != b.size()) return false;
+  for (std::size_t i = 0; i < a.size(); ++i) {
+    if (!(a[i] == b[i])) return false;
+  }
+  return true;
+}
+
+template <typename T, std::size_t N>
+constexpr bool operator!=(const static_vector<T, N> &a,
+                          const static_vector<T, N> &b) {
+  return !(a == b);
+}
+}  // namespace lib
+
+#endif  // LIB_STATIC_VECTOR_H_
@@ -0,0 +1,236 @@
+#ifndef LIB_THREAD_POOL_H_
+#define LIB_THREAD_POOL_H_
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace lib {
+// Fixed set of worker threads that execute index-parallel loops. The thread
+// calling parallel_for takes part in the work, so a pool of size n spawns
+// n - 1 workers. Each thread starts on its own contiguous share of the
+// indices and, once that runs out, steals the upper half of the largest
+// share left, so neighbouring indices mostly run on the same thread.
+class thread_pool {
+ public:
+  using size_type = std::size_t;
+
+  explicit thread_pool(size_type threads = hardwareThreads());
+  thread_pool(const thread_pool &) = delete;
+  thread_pool &operator=(const thread_pool &) = delete;
+  ~thread_pool();
+
+  size_type size() const noexcept;
+
+  // Calls f(i) for every i in [0, count) and returns once all calls are
+  // done. The first exception thrown by f is rethrown to the caller. Calls
+  // made from inside a running loop execute sequentially.
+  template <typename Function>
+  void parallel_for(size_type count, Function &&f);
+
+  static thread_pool &global();
+
+ private:
+  // Indices [begin, end) still to run, owned by one thread. Padded to a
+  // cache line so owners do not contend on each other's counters.
+  struct alignas(64) WorkRange {
+    std::mutex mutex;
+    size_type begin = 0;
+    size_type end = 0;
+  };
+
+  void workerLoop(size_type slot);
+  void runTasks(size_type slot);
+  bool popTask(size_type slot, size_type &index);
+  bool stealTasks(size_type slot);
+
+  static size_type hardwareThreads() noexcept;
+  static bool &insidePool() noexcept;
+
+  std::unique_ptr<std::thread[]> workers_;
+  size_type worker_count_;
+  // One per thread: the caller uses slot 0, worker i slot i + 1.
+  std::unique_ptr<WorkRange[]> ranges_;
+
+  std::mutex submit_mutex_;
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable done_;
+
+  const std::function<void(size_type)> *task_;
+  std::atomic<bool> cancelled_;
+  size_type busy_;
+  std::uint64_t generation_;
+  bool stop_;
+  std::exception_ptr error_;
+};
+
+inline thread_pool::thread_pool(size_type threads)
+    : worker_count_(threads > 1 ? threads - 1 : 0),
+      ranges_(new WorkRange[worker_count_ + 1]),
+      task_(nullptr),
+      cancelled_(false),
+      busy_(0),
+      generation_(0),
+      stop_(false) {
+  workers_.reset(new std::thread[worker_count_]);
+  for (size_type i = 0; i < worker_count_; ++i) {
+    workers_[i] = std::thread(&thread_pool::workerLoop, this, i + 1);
+  }
+}
+
+inline thread_pool::~thread_pool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  wake_.notify_all();
+  for (size_type i = 0; i < worker_count_; ++i) {
+    workers_[i].join();
+  }
+}
+
+inline thread_pool::size_type thread_pool::size() const noexcept {
+  return worker_count_ + 1;
+}
+
+template <typename Function>
+void thread_pool::parallel_for(size_type count, Function &&f) {
+  if (count == 0) return;
+  if (worker_count_ == 0 || count == 1 || insidePool()) {
+    for (size_type i = 0; i < count; ++i) f(i);
+    return;
+  }
+
+  std::lock_guard<std::mutex> submit(submit_mutex_);
+  std::function<void(size_type)> task = [&f](size_type i) { f(i); };
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_.wait(lock, [this] { return busy_ == 0; });
+    task_ = &task;
+    size_type slots = size();
+    for (size_type slot = 0; slot < slots; ++slot) {
+      std::lock_guard<std::mutex> range_lock(ranges_[slot].mutex);
+      ranges_[slot].begin = count * slot / slots;
+      ranges_[slot].end = count * (slot + 1) / slots;
+    }
+    cancelled_.store(false);
+    error_ = nullptr;
+    ++generation_;
+    ++busy_;
+  }
+  wake_.notify_all();
+
+  insidePool() = true;
+  runTasks(0);
+  insidePool() = false;
+
+  std::exception_ptr error;
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    --busy_;
+    done_.wait(lock, [this] { return busy_ == 0; });
+    task_ = nullptr;
+    error = error_;
+    error_ = nullptr;
+  }
+  if (error) std::rethrow_exception(error);
+}
+
+inline thread_pool &thread_pool::global() {
+  static thread_pool pool;
+  return pool;
+}
+
+inline void thread_pool::workerLoop(size_type slot) {
+  insidePool() = true;
+  std::uint64_t seen = 0;
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+    if (stop_) return;
+    seen = generation_;
+    if (task_ == nullptr) continue;
+    ++busy_;
+    lock.unlock();
+    runTasks(slot);
+    lock.lock();
+    if (--busy_ == 0) done_.notify_all();
+  }
+}
+
+inline void thread_pool::runTasks(size_type slot) {
+  size_type i;
+  while (!cancelled_.load(std::memory_order_relaxed) &&
+         (popTask(slot, i) || (stealTasks(slot) && popTask(slot, i)))) {
+    try {
+      (*task_)(i);
+    } catch (...) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!error_) error_ = std::current_exception();
+      cancelled_.store(true);
+    }
+  }
+}
+
+inline bool thread_pool::popTask(size_type slot, size_type &index) {
+  WorkRange &range = ranges_[slot];
+  std::lock_guard<std::mutex> lock(range.mutex);
+  if (range.begin == range.end) return false;
+  index = range.begin++;
+  return true;
+}
+
+// Moves the upper half of the largest other range into this thread's own,
+// which is empty. Returns false once no work is left anywhere.
+inline bool thread_pool::stealTasks(size_type slot) {
+  size_type slots = size();
+  while (true) {
+    size_type victim = slot;
+    size_type most = 0;
+    for (size_type other = 0; other < slots; ++other) {
+      if (other == slot) continue;
+      std::lock_guard<std::mutex> lock(ranges_[other].mutex);
+      size_type left = ranges_[other].end - ranges_[other].begin;
+      if (left > most) {
+        most = left;
+        victim = other;
+      }
+    }
+    if (victim == slot) return false;
+
+    size_type begin;
+    size_type end;
+    {
+      std::lock_guard<std::mutex> lock(ranges_[victim].mutex);
+      WorkRange &range = ranges_[victim];
+      if (range.begin == range.end) continue;
+      end = range.end;
+      begin = range.end - (range.end - range.begin + 1) / 2;
+      range.end = begin;
+    }
+    std::lock_guard<std::mutex> lock(ranges_[slot].mutex);
+    ranges_[slot].begin = begin;
+    ranges_[slot].end = end;
+    return true;
+  }
+}
+
+inline thread_pool::size_type thread_pool::hardwareThreads() noexcept {
+  size_type threads = std::thread::hardware_concurrency();
+  return threads > 0 ? threads : 1;
+}
+
+inline bool &thread_pool::insidePool() noexcept {
+  thread_local bool inside = false;
+  return inside;
+}
+}  // namespace lib
+
+#endif  // LIB_THREAD_POOL_H_
@@ -1,22 +1,93 @@
 #ifndef SRC_LIB_TREE_H_
 #define SRC_LIB_TREE_H_
 
+#include <functional>
+#include <limits>
+#include <optional>
+#include <type_traits>
+
+#include "lib_thread_pool.h"
 #include "lib_vector.h"
 
 namespace lib {
-template <typename Key>
-class RBTree {
+// Monoids for RBTree subtree aggregates: value_type, its identity() and an
+// associative combine(). Users may supply their own with the same members.
+template <typename T>
+struct sum_aggregate {
+  using value_type = T;
+  static value_type identity() { return T{}; }
+  static value_type combine(const T& a, const T& b) { return a + b; }
+};
+
+template <typename T>
+struct min_aggregate {
+  using value_type = T;
+  static value_type identity() { return std::numeric_limits<T>::max(); }
+  static value_type combine(const T& a, const T& b) { return b < a ? b : a; }
+};
+
+template <typename T>
+struct max_aggregate {
+  using value_type = T;
+  static value_type identity() { return std::numeric_limits<T>::lowest(); }
+  static value_type combine(const T& a, const T& b) { return a < b ? b : a; }
+};
+
+// Per-node cache of the subtree aggregate; empty when the tree is not
+// augmented.
+template <typename Augment>
+struct RBAugmentData {
+  RBAugmentData() : agg_(Augment::identity()) {}
+  typename Augment::value_type agg_;
+};
+
+template <>
+struct RBAugmentData<void> {};
+
+// Counters collected by an RBTree whose Stats policy is tree_stats. Lookups
+// update them too, so a tree with statistics enabled must not be searched
+// from several threads at once.
+struct tree_stats {
+  std::size_t comparisons = 0;
+  std::size_t rotations = 0;
+  std::size_t insert_fixup_iterations = 0;
+  std::size_t erase_fixup_iterations = 0;
+  std::size_t allocations = 0;
+  std::size_t deallocations = 0;
+};
+
+// Holds the tree's Stats policy; empty, and free through the empty base
+// optimization, when statistics are disabled.
+template <typename Stats>
+struct RBStatsData {
+  mutable Stats stats_;
+};
+
+template <>
+struct RBStatsData<void> {};
+
+// Augment, when not void, is an aggregate monoid with an extra static
+// project(const Key&) mapping an element to Augment::value_type. Every node
+// then caches the aggregate of its subtree, kept up to date by insertions,
+// erasures and rotations. Stats, when not void, is a counter set shaped like
+// tree_stats that the tree updates as it works.
+template <typename Key, typename Compare = std::less<Key>,
+          typename Augment = void, typename Stats = void>
+class RBTree : private RBStatsData<Stats> {
   class RBNode;
   class RBIterator;
   class RBConstIterator;
   using reference = Key&;
   using const_reference = const Key&;
   using size_type = std::size_t;
-  using comparator = std::less<Key>;
+  using comparator = Compare;
   using NodePtr = RBNode*;
 
   enum NodeColor { BLACK, RED };
 
+  static constexpr bool kAugmented = !std::is_void_v<Augment>;
+  static constexpr bool kStats = !std::is_void_v<Stats>;
+
  public:
   using iterator = RBIterator;
   using const_iterator = RBConstIterator;
@@ -37,11 +108,10 @@ class RBTree {
         clear();
       } else {
         if (root_->parent_) clear();
-        NodePtr root = copyRBNode_(other.root_->parent_, nullptr);
+        NodePtr root = copyRBNode_(other.root_->parent_, root_);
         root_->parent_ = root;
-        root_->parent_->parent_ = root;
-        root_->left_ = other.root_->left_;
-        root_->right_ = other.root_->right_;
+        root_->left_ = searchLeft_(root);
+        root_->right_ = searchRight_(root);
         size_ = other.size_;
       }
     }
@@ -80,14 +150,14 @@ class RBTree {
   }
 
   std::pair<iterator, bool> insertUnique(const value_type& value) {
-    NodePtr new_node = new RBNode(value);
+    NodePtr new_node = newNode_(value);
     std::pair<iterator, bool> res = insertNode_(new_node, true);
     if (!res.second) eraseNode_(new_node);
     return res;
   }
 
   iterator insertDuplicate(const value_type& value) {
-    NodePtr new_node = new RBNode(value);
+    NodePtr new_node = newNode_(value);
     return insertNode_(new_node, false).first;
   }
 
@@ -101,13 +171,13 @@ class RBTree {
 
   iterator find(const_reference key) noexcept {
     iterator res = iterator(findNode_(key));
-    if (res == end() || comparator{}(*res, key)) return end();
+    if (res == end() || less_(*res, key)) return end();
     return res;
   }
 
   const_iterator find(const_reference key) const noexcept {
     const_iterator res = lower_bound(key);
-    if (res == end() || comparator{}(*res, key)) return end();
+    if (res == end() || less_(*res, key)) return end();
     return res;
   }
 
@@ -120,7 +190,7 @@ class RBTree {
     iterator result = end();
     NodePtr begin = root_->parent_;
     while (begin != nullptr) {
-      if (comparator{}(value, begin->data_)) {
+      if (less_(value, begin->data_)) {
         result = iterator(begin);
         begin = begin->left_;
       } else
@@ -133,7 +203,7 @@ class RBTree {
     const_iterator result = end();
     NodePtr begin = root_->parent_;
     while (begin != nullptr) {
-      if (comparator{}(value, begin->data_)) {
+      if (less_(value, begin->data_)) {
         result = const_iterator(begin);
         begin = begin->left_;
       } else
@@ -146,7 +216,7 @@ class RBTree {
     iterator result = end();
     NodePtr begin = root_->parent_;
     while (begin != nullptr) {
-      if (comparator{}(begin->data_, value)) {
+      if (less_(begin->data_, value)) {
         begin = begin->right_;
       } else {
         result = iterator(begin);
@@ -160,7 +230,7 @@ class RBTree {
     const_iterator result = end();
     NodePtr begin = root_->parent_;
     while (begin != nullptr) {
-      if (comparator{}(begin->data_, value)) {
+      if (less_(begin->data_, value)) {
         begin = begin->right_;
       } else {
         result = const_iterator(begin);
@@ -217,7 +287,9 @@ class RBTree {
     if (this != &other) {
       iterator it = other.begin();
       while (it != other.end()) {
-        if (find(it.node_->data_) == end()) {
+        // Equivalence under the comparator decides, as for insertion: a
+        // map entry whose key is taken stays in other.
+        if (findEquivalentNode_(it.node_->data_) == root_) {
           NodePtr node = it.node_;
           it++;
           node = other.extractNode_(node);
@@ -228,15 +300,145 @@ class RBTree {
     }
   }
 
+  // Calls f on every element. The tree is cut into in-order pieces that are
+  // walked concurrently on the pool, so f must be safe to call in parallel.
+  template <typename Function>
+  void parallelForEach(Function f, thread_pool& pool) {
+    forEachPiece_(pool, [&f](NodePtr node, bool subtree) {
+      if (subtree)
+        walkSubtree_(node, f);
+      else
+        f(node->data_);
+    });
+  }
+
+  template <typename Function>
+  void parallelForEach(Function f, thread_pool& pool) const {
+    forEachPiece_(pool, [&f](NodePtr node, bool subtree) {
+      auto visit = [&f](const_reference value) { f(value); };
+      if (subtree)
+        walkSubtree_(node, visit);
+      else
+        visit(node->data_);
+    });
+  }
+
+  // Folds transform(element) with op in key order. Partial results of the
+  // pieces are combined left to right, so for an associative op the result
+  // equals the sequential fold starting from init.
+  template <typename T, typename BinaryOp, typename UnaryOp>
+  T parallelReduce(T init, BinaryOp op, UnaryOp transform,
+                   thread_pool& pool) const {
+    vector<std::pair<NodePtr, bool>> pieces = partition_(pool);
+    vector<std::optional<T>> partials(pieces.size());
+    pool.parallel_for(pieces.size(), [&](size_type i) {
+      std::optional<T>& acc = partials[i];
+      auto fold = [&](const_reference value) {
+        if (acc)
+          acc = op(std::move(*acc), transform(value));
+        else
+          acc.emplace(transform(value));
+      };
+      if (pieces[i].second)
+        walkSubtree_(pieces[i].first, fold);
+      else
+        fold(pieces[i].first->data_);
+    });
+    for (size_type i = 0; i < partials.size(); ++i) {
+      init = op(std::move(init), std::move(*partials[i]));
+    }
+    return init;
+  }
+
+  // Aggregate of the elements e with lo <= e < hi, in O(log n). K may be any
+  // type the comparator can order against the stored elements.
+  template <typename K, typename A = Augment>
+  typename A::value_type aggregate(const K& lo, const K& hi) const {
+    NodePtr node = root_->parent_;
+    while (node != nullptr) {
+      if (less_(node->data_, lo))
+        node = node->right_;
+      else if (!less_(node->data_, hi))
+        node = node->left_;
+      else
+        break;
+    }
+    if (node == nullptr) return A::identity();
+    typename A::value_type result = aggregateFrom_(node->left_, lo);
+    result = A::combine(result, A::project(node->data_));
+    return A::combine(result, aggregateBelow_(node->right_, hi));
+  }
+
+  template <typename A = Augment>
+  typename A::value_type aggregate() const {
+    if (root_->parent_ == nullptr) return A::identity();
+    return root_->parent_->agg_;
+  }
+
+  // Recomputes the cached aggregates from pos up to the root. Call it after
+  // changing the projected part of an element in place.
+  void refreshAggregates(iterator pos) noexcept {
+    updateAggregatesUp_(pos.node_);
+  }
+
+  // Like find, but accepts any key the comparator can order against the
+  // stored elements.
+  template <typename K>
+  iterator findEquivalent(const K& key) noexcept {
+    return iterator(findEquivalentNode_(key));
+  }
+
+  template <typename K>
+  const_iterator findEquivalent(const K& key) const noexcept {
+    return const_iterator(iterator(findEquivalentNode_(key)));
+  }
+
+  // In-order search pruned by the cached aggregates: a subtree is entered
+  // only if enter(its aggregate) holds, and the walk stops at the first
+  // element for which within(element) is false. visit receives an iterator
+  // to every element reached.
+  template <typename Enter, typename Within, typename Visit>
+  void searchAugmented(Enter enter, Within within, Visit visit) {
+    searchAugmented_(root_->parent_, enter, within,
+                     [&visit](NodePtr node) { visit(iterator(node)); });
+  }
+
+  template <typename Enter, typename Within, typename Visit>
+  void searchAugmented(Enter enter, Within within, Visit visit) const {
+    searchAugmented_(root_->parent_, enter, within, [&visit](NodePtr node) {
+      visit(const_iterator(iterator(node)));
+    });
+  }
+
+  template <typename S = Stats>
+  const S& stats() const noexcept {
+    return this->stats_;
+  }
+
+  template <typename S = Stats>
+  void resetStats() noexcept {
+    this->stats_ = S();
+  }
+
+  // Number of levels: 0 for an empty tree, 1 for a single node.
+  size_type height() const noexcept { return heightOf_(root_->parent_); }
+
+  // Element i is the number of nodes at depth i, the root being at depth 0.
+  vector<size_type> depthHistogram() const {
+    vector<size_type> histogram;
+    countDepths_(root_->parent_, 0, histogram);
+    return histogram;
+  }
+
   template <typename... Args>
   vector<std::pair<iterator, bool>> insertMany(Args&&... args) {
     vector<std::pair<iterator, bool>> result;
     result.reserve(sizeof...(args));
     auto insert_node = [this](auto&& arg) {
-      NodePtr new_node = new RBNode(std::forward<decltype(arg)>(arg));
+      NodePtr new_node = newNode_(std::forward<decltype(arg)>(arg));
       auto res = insertNode_(new_node, true);
       if (!res.second) {
-        delete new_node;
+        eraseNode_(new_node);
       }
       return res;
     };
@@ -250,7 +452,7 @@ class RBTree {
     vector<std::pair<iterator, bool>> result;
     result.reserve(sizeof...(args));
     ((result.push_back(
-         {insertNode_(new RBNode(std::forward<Args>(args)), false)})),
+         {insertNode_(newNode_(std::forward<Args>(args)), false)})),
      ...);
     return result;
   }
@@ -259,14 +461,26 @@ class RBTree {
   NodePtr root_;
   size_type size_;
 
+  template <typename A, typename B>
+  bool less_(const A& a, const B& b) const {
+    if constexpr (kStats) ++this->stats_.comparisons;
+    return comparator{}(a, b);
+  }
+
+  template <typename... Args>
+  NodePtr newNode_(Args&&... args) {
+    if constexpr (kStats) ++this->stats_.allocations;
+    return new RBNode(std::forward<Args>(args)...);
+  }
+
   std::pair<iterator, bool> insertNode_(NodePtr new_node, bool unique) {
     NodePtr node = root_->parent_;
     NodePtr parent = nullptr;
     while (node != nullptr) {
       parent = node;
-      if (comparator{}(new_node->data_, node->data_))
+      if (less_(new_node->data_, node->data_))
         node = node->left_;
-      else if (comparator{}(node->data_, new_node->data_))
+      else if (less_(node->data_, new_node->data_))
         node = node->right_;
       else if (unique == false)
         node = node->right_;
@@ -280,19 +494,21 @@ class RBTree {
       new_node->color_ = BLACK;
     } else {
       new_node->parent_ = parent;
-      comparator{}(new_node->data_, parent->data_) ? parent->left_ = new_node
+      less_(new_node->data_, parent->data_) ? parent->left_ = new_node
                                                    : parent->right_ = new_node;
     }
     if (!root_->right_ || root_->right_->right_) {
       root_->right_ = new_node;
     }
     if (!root_->left_ || root_->left_->left_) root_->left_ = new_node;
+    updateAggregatesUp_(new_node);
     balanceAfterInsert_(new_node);
     return {iterator(new_node), true};
   }
 
   void eraseNode_(NodePtr node) {
     if (node != nullptr) {
+      if constexpr (kStats) ++this->stats_.deallocations;
       node->left_ = nullptr;
       node->right_ = nullptr;
       node->parent_ = nullptr;
@@ -302,6 +518,7 @@ class RBTree {
   }
 
   void leftRotate_(NodePtr node) noexcept {
+    if constexpr (kStats) ++this->stats_.rotations;
     NodePtr help_node = node->right_;
     node->right_ = help_node->left_;
     if (help_node->left_ != nullptr) {
@@ -317,9 +534,12 @@ class RBTree {
     }
     help_node->left_ = node;
     node->parent_ = help_node;
+    updateAggregate_(node);
+    updateAggregate_(help_node);
   }
 
   void rightRotate_(NodePtr node) noexcept {
+    if constexpr (kStats) ++this->stats_.rotations;
     NodePtr help_node = node->left_;
     node->left_ = help_node->right_;
     if (help_node->right_ != nullptr) {
@@ -335,11 +555,14 @@ class RBTree {
     }
     help_node->right_ = node;
     node->parent_ = help_node;
+    updateAggregate_(node);
+    updateAggregate_(help_node);
   }
 
   void balanceAfterInsert_(NodePtr node) noexcept {
     NodePtr u;
     while (node->parent_->color_ == RED && node != root_->parent_) {
+      if constexpr (kStats) ++this->stats_.insert_fixup_iterations;
       if (node->parent_ == node->parent_->parent_->right_) {
         u = node->parent_->parent_->left_;
         if (u != nullptr && u->color_ == RED) {
@@ -413,7 +636,7 @@ class RBTree {
     NodePtr ptr = root_->parent_;
     while (ptr) {
       if (ptr->data_ == key) return ptr;
-      if (comparator{}(ptr->data_, key))
+      if (less_(ptr->data_, key))
         ptr = ptr->right_;
       else
         ptr = ptr->left_;
@@ -439,9 +662,11 @@ class RBTree {
       if (!node->right_ && node->left_ != nullptr) {
         swapNodes_(node, node->left_);
       }
+      updateAggregatesUp_(node);
       if (node->color_ == BLACK && (!node->left_ && !node->right_)) {
         balanceAfterDelete_(node);
       }
+      NodePtr parent = node->parent_;
       if (root_->parent_ == node) {
         root_->parent_ = nullptr;
         root_->right_ = nullptr;
@@ -452,6 +677,7 @@ class RBTree {
         if (root_->left_ == node) root_->left_ = searchLeft_(root_->parent_);
         if (root_->right_ == node) root_->right_ = searchRight_(root_->parent_);
       }
+      updateAggregatesUp_(parent);
       eraseNode_(node);
       size_--;
     }
@@ -467,8 +693,10 @@ class RBTree {
       }
       if (node->right_ && !node->left_) swapNodes_(node, node->right_);
       if (node->left_ && !node->right_) swapNodes_(node, node->left_);
+      updateAggregatesUp_(node);
       if (node->color_ == BLACK && (!node->right_ && !node->left_))
         balanceAfterDelete_(node);
+      NodePtr parent = node->parent_;
       if (root_->left_ == node) root_->left_ = node->successor();
       if (root_->right_ == node) root_->right_ = node->predecessor();
       if (root_->parent_ == node)
@@ -476,6 +704,7 @@ class RBTree {
       else
         node->parent_->left_ == node ? node->parent_->left_ = nullptr
                                      : node->parent_->right_ = nullptr;
+      updateAggregatesUp_(parent);
       size_--;
       node->left_ = nullptr;
       node->right_ = nullptr;
@@ -487,6 +716,7 @@ class RBTree {
 
   void balanceAfterDelete_(NodePtr node) {
     while (node != root_->parent_ && node->color_ == BLACK) {
+      if constexpr (kStats) ++this->stats_.erase_fixup_iterations;
       NodePtr sibling = (node == node->parent_->left_) ? node->parent_->right_
                                                        : node->parent_->left_;
 
@@ -536,6 +766,147 @@ class RBTree {
     node->color_ = BLACK;
   }
 
+  void updateAggregate_(NodePtr node) noexcept {
+    if constexpr (kAugmented) {
+      typename Augment::value_type agg = Augment::project(node->data_);
+      if (node->left_) agg = Augment::combine(node->left_->agg_, agg);
+      if (node->right_) agg = Augment::combine(agg, node->right_->agg_);
+      node->agg_ = std::move(agg);
+    }
+  }
+
+  void updateAggregatesUp_(NodePtr node) noexcept {
+    if constexpr (kAugmented) {
+      for (; node != nullptr && node != root_; node = node->parent_) {
+        updateAggregate_(node);
+      }
+    }
+  }
+
+  template <typename K>
+  NodePtr findEquivalentNode_(const K& key) const noexcept {
+    NodePtr node = root_->parent_;
+    while (node != nullptr) {
+      if (less_(node->data_, key))
+        node = node->right_;
+      else if (less_(key, node->data_))
+        node = node->left_;
+      else
+        return node;
+    }
+    return root_;
+  }
+
+  // Returns false once the walk has passed the last element within bounds.
+  template <typename Enter, typename Within, typename Visit>
+  static bool searchAugmented_(NodePtr node, Enter& enter, Within& within,
+                               const Visit& visit) {
+    while (node != nullptr && enter(node->agg_)) {
+      if (!searchAugmented_(node->left_, enter, within, visit)) return false;
+      if (!within(node->data_)) return false;
+      visit(node);
+      node = node->right_;
+    }
+    return true;
+  }
+
+  // Aggregate of the elements >= lo in the subtree of node, in order.
+  template <typename K, typename A = Augment>
+  typename A::value_type aggregateFrom_(NodePtr node, const K& lo) const {
+    typename A::value_type result = A::identity();
+    while (node != nullptr) {
+      if (less_(node->data_, lo)) {
+        node = node->right_;
+      } else {
+        typename A::value_type part = A::project(node->data_);
+        if (node->right_) part = A::combine(part, node->right_->agg_);
+        result = A::combine(part, result);
+        node = node->left_;
+      }
+    }
+    return result;
+  }
+
+  // Aggregate of the elements < hi in the subtree of node, in order.
+  template <typename K, typename A = Augment>
+  typename A::value_type aggregateBelow_(NodePtr node, const K& hi) const {
+    typename A::value_type result = A::identity();
+    while (node != nullptr) {
+      if (less_(node->data_, hi)) {
+        if (node->left_) result = A::combine(result, node->left_->agg_);
+        result = A::combine(result, A::project(node->data_));
+        node = node->right_;
+      } else {
+        node = node->left_;
+      }
+    }
+    return result;
+  }
+
+  // Below this many elements a parallel walk costs more than it saves.
+  static constexpr size_type kParallelGrain = 4096;
+  static constexpr size_type kPiecesPerThread = 4;
+
+  // Splits the tree into in-order pieces: whole subtrees rooted deep enough
+  // that there are about kPiecesPerThread of them per pool thread, separated
+  // by the single nodes above them. A small tree is a single piece.
+  vector<std::pair<NodePtr, bool>> partition_(const thread_pool& pool) const {
+    vector<std::pair<NodePtr, bool>> pieces;
+    if (root_->parent_ == nullptr) return pieces;
+    size_type depth = 0;
+    if (pool.size() > 1 && size_ >= kParallelGrain) {
+      size_type wanted = pool.size() * kPiecesPerThread;
+      while ((size_type(1) << depth) < wanted) ++depth;
+    }
+    collectPieces_(root_->parent_, depth, pieces);
+    return pieces;
+  }
+
+  static void collectPieces_(NodePtr node, size_type depth,
+                             vector<std::pair<NodePtr, bool>>& pieces) {
+    if (node == nullptr) return;
+    if (depth == 0) {
+      pieces.push_back({node, true});
+    } else {
+      collectPieces_(node->left_, depth - 1, pieces);
+      pieces.push_back({node, false});
+      collectPieces_(node->right_, depth - 1, pieces);
+    }
+  }
+
+  template <typename Function>
+  void forEachPiece_(thread_pool& pool, Function visit) const {
+    vector<std::pair<NodePtr, bool>> pieces = partition_(pool);
+    pool.parallel_for(pieces.size(), [&](size_type i) {
+      visit(pieces[i].first, pieces[i].second);
+    });
+  }
+
+  // In-order walk without successor(): recursion depth is the tree height.
+  template <typename Function>
+  static void walkSubtree_(NodePtr node, Function& f) {
+    while (node != nullptr) {
+      walkSubtree_(node->left_, f);
+      f(node->data_);
+      node = node->right_;
+    }
+  }
+
+  static size_type heightOf_(NodePtr node) noexcept {
+    if (node == nullptr) return 0;
+    size_type left = heightOf_(node->left_), right = heightOf_(node->right_);
+    return 1 + (left > right ? left : right);
+  }
+
+  static void countDepths_(NodePtr node, size_type depth,
+                           vector<size_type>& histogram) {
+    for (; node != nullptr; node = node->right_, ++depth) {
+      if (histogram.size() == depth) histogram.push_back(0);
+      ++histogram[depth];
+      countDepths_(node->left_, depth + 1, histogram);
+    }
+  }
+
   void eraseTree_(NodePtr node) {
     if (node == nullptr) return;
     eraseTree_(node->left_);
@@ -545,7 +916,7 @@ class RBTree {
 
   NodePtr copyRBNode_(NodePtr source_node, NodePtr parent) {
     if (!source_node) return nullptr;
-    NodePtr new_node = new RBNode(source_node);
+    NodePtr new_node = newNode_(source_node);
     new_node->parent_ = parent;
     if (source_node->left_)
       new_node->left_ = copyRBNode_(source_node->left_, new_node);
@@ -554,7 +925,7 @@ class RBTree {
     return new_node;
   }
 
-  class RBNode {
+  class RBNode : public RBAugmentData<Augment> {
    public:
     RBNode()
         : data_(Key{}),
@@ -578,7 +949,8 @@ class RBTree {
           right_(nullptr) {}
 
     RBNode(const RBNode* node)
-        : data_(node->data_),
+        : RBAugmentData<Augment>(*node),
+          data_(node->data_),
           color_(node->color_),
           parent_(nullptr),
           left_(nullptr),
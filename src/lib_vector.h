@@ -1,13 +1,86 @@
 #ifndef LIB_VECTOR_H_
 #define LIB_VECTOR_H_
 
+#include <algorithm>
 #include <cstddef>
+#include <cstring>
 #include <initializer_list>
+#include <iterator>
 #include <limits>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "lib_sort.h"
 
 namespace lib {
-template <typename T>
-class vector {
+// Growth policies pick the capacity a vector moves to once it is full:
+// next(capacity, required) returns at least required.
+
+// Multiplies the capacity by Num / Den.
+template <std::size_t Num, std::size_t Den>
+struct geometric_growth {
+  static_assert(Num > Den && Den > 0, "growth factor must exceed 1");
+
+  static std::size_t next(std::size_t capacity, std::size_t required) {
+    std::size_t grown = capacity / Den * Num + capacity % Den * Num / Den;
+    return std::max(grown, required);
+  }
+};
+
+using doubling_growth = geometric_growth<2, 1>;
+using one_and_half_growth = geometric_growth<3, 2>;
+using golden_growth = geometric_growth<1618, 1000>;
+
+// Adds Increment elements at a time, bounding the slack of huge buffers.
+template <std::size_t Increment>
+struct linear_growth {
+  static_assert(Increment > 0, "increment must be positive");
+
+  static std::size_t next(std::size_t capacity, std::size_t required) {
+    return std::max(capacity + Increment, required);
+  }
+};
+
+// Raw storage for the first N elements inside the object itself.
+template <typename T, std::size_t N, std::size_t Alignment>
+class VectorInlineBuffer {
+ protected:
+  T *inlineData() noexcept { return reinterpret_cast<T *>(buffer_); }
+  const T *inlineData() const noexcept {
+    return reinterpret_cast<const T *>(buffer_);
+  }
+
+ private:
+  alignas(Alignment) unsigned char buffer_[N * sizeof(T)];
+};
+
+template <typename T, std::size_t Alignment>
+class VectorInlineBuffer<T, 0, Alignment> {
+ protected:
+  T *inlineData() const noexcept { return nullptr; }
+};
+
+// Elements live in raw storage: only [0, size()) is constructed, spare
+// capacity stays uninitialized, and removed elements are destroyed at once.
+// Trivially copyable elements are copied and shifted with memcpy/memmove;
+// others are moved on reallocation when their move constructor is noexcept.
+// With N > 0 the first N elements are kept in an inline buffer and the heap
+// is only used once the capacity needed exceeds N; vector is the N == 0 case.
+// Storage grows only when an insertion does not fit, to the capacity chosen
+// by the Growth policy; reserve() and shrink_to_fit() allocate exactly.
+// data() is aligned to Alignment bytes, both inline and on the heap.
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+class BasicVector : private VectorInlineBuffer<T, N, Alignment> {
+  static_assert((Alignment & (Alignment - 1)) == 0 && Alignment >= alignof(T),
+                "alignment must be a power of two no smaller than alignof(T)");
+
+  static constexpr bool kNothrowMove =
+      N == 0 || std::is_nothrow_move_constructible_v<T>;
+  static constexpr bool kOverAligned =
+      Alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
  public:
   using value_type = T;
   using reference = T &;
@@ -17,25 +90,28 @@ class vector {
   using size_type = size_t;
   using difference_type = std::ptrdiff_t;
 
-  vector();
-  explicit vector(size_type n);
-  vector(std::initializer_list<value_type> const &items);
-  vector(const vector &v);
-  vector(vector &&v);
-  ~vector();
-  vector &operator=(vector &&v);
+  BasicVector();
+  explicit BasicVector(size_type n);
+  BasicVector(std::initializer_list<value_type> const &items);
+  BasicVector(const BasicVector &v);
+  BasicVector(BasicVector &&v) noexcept(kNothrowMove);
+  ~BasicVector();
+  BasicVector &operator=(BasicVector &&v) noexcept(kNothrowMove);
 
   reference at(size_type pos);
   reference operator[](size_type pos);
   const_reference front();
   const_reference back();
   T *data();
+  const T *data() const;
 
   iterator begin();
   iterator end();
+  const_iterator begin() const;
+  const_iterator end() const;
 
-  bool empty();
-  size_type size();
+  bool empty() const;
+  size_type size() const;
   size_type max_size();
   void reserve(size_type size);
   size_type capacity();
@@ -43,10 +119,51 @@ class vector {
 
   void clear();
   iterator insert(iterator pos, const_reference value);
-  void erase(iterator pos);
+  iterator insert(iterator pos, value_type &&value);
+  iterator insert(const_iterator pos, std::initializer_list<value_type> items);
+  template <typename InputIt>
+  iterator insert(const_iterator pos, InputIt first, InputIt last);
+  iterator erase(const_iterator pos);
+  iterator erase(const_iterator first, const_iterator last);
+  iterator unordered_erase(const_iterator pos);
+  template <typename Predicate>
+  size_type erase_if(Predicate pred);
   void push_back(const_reference value);
+  void push_back(value_type &&value);
   void pop_back();
-  void swap(vector &other);
+  void swap(BasicVector &other);
+  // Shrinking destroys the elements past n; growing appends value-initialized
+  // elements or copies of value, through the Growth policy.
+  void resize(size_type n);
+  void resize(size_type n, const_reference value);
+  // resize() for trivial element types that leaves the new elements
+  // uninitialized, so a buffer about to be filled by read() or memcpy is not
+  // zeroed first. They must be written before they are read.
+  void resize_default_init(size_type n);
+  // resize_default_init() for any trivially copyable element type, including
+  // ones with default member initializers, which the new elements skip: they
+  // hold no value until raw bytes are copied or read into them.
+  void resize_for_overwrite(size_type n);
+
+  // Not stable. Large ranges of integers or floating-point values compared
+  // with std::less or std::greater are radix sorted, everything else goes
+  // through introsort.
+  void sort();
+  template <typename Compare>
+  void sort(Compare comp);
+  void stable_sort();
+  template <typename Compare>
+  void stable_sort(Compare comp);
+  // Stable sort by the value key(element) returns; numeric keys are radix
+  // sorted.
+  template <typename Projection>
+  void sort_by_key(Projection key);
+
+  template <typename... Args>
+  iterator emplace(const_iterator pos, Args &&...args);
+
+  template <typename... Args>
+  reference emplace_back(Args &&...args);
 
   template <typename... Args>
   iterator insert_many(const_iterator pos, Args &&...args);
@@ -54,258 +171,733 @@ class vector {
   template <typename... Args>
   void insert_many_back(Args &&...args);
 
+ protected:
+  bool isInline() const noexcept {
+    return N > 0 && p_ == this->inlineData();
+  }
+
  private:
   T *p_;
   size_t size_;
   size_t capacity_;
 
-  void resizeIfNeeded(size_type incoming_amount = 1);
+  size_type grownCapacity(size_type incoming_amount) const;
+  template <typename Construct>
+  iterator insertConstructed(size_type offset, size_type count,
+                             Construct construct);
   void adjustCapacity(size_type capacity);
-  void copyData(value_type *arr, size_type size);
-  void pasteData(const value_type *arr, size_type size);
+  void reallocate(size_type capacity);
+  template <typename... Args>
+  void reallocateAndEmplace(Args &&...args);
+  void destroyElements(size_type from);
   void deallocate();
+  void takeFrom(BasicVector &v);
+  value_type *storageFor(size_type capacity);
+  void releaseStorage(value_type *p) noexcept;
+
+  static value_type *allocate(size_type n);
+  static void release(value_type *p);
+  static void copyConstruct(const value_type *from, size_type n,
+                            value_type *to);
+  static void transfer(value_type *from, size_type n, value_type *to);
+  static void relocate(value_type *from, size_type n, value_type *to);
+  static void relocateWithin(value_type *from, size_type n, value_type *to);
+  static void destroy(value_type *first, size_type n) noexcept;
+
+  static constexpr bool kTrivial = std::is_trivially_copyable_v<value_type>;
+  static constexpr bool kMoveOnRelocate =
+      std::is_nothrow_move_constructible_v<value_type> ||
+      !std::is_copy_constructible_v<value_type>;
 };
 
-template <typename T>
-vector<T>::vector() : p_(nullptr), size_(0), capacity_(0) {}
+template <typename T, typename Growth = doubling_growth,
+          std::size_t Alignment = alignof(T)>
+class vector : public BasicVector<T, 0, Growth, Alignment> {
+ public:
+  using BasicVector<T, 0, Growth, Alignment>::BasicVector;
+};
 
-template <typename T>
-vector<T>::vector(size_type n)
-    : p_(new value_type[n]()), size_(n), capacity_(n) {}
+// vector whose data() starts on a cache line, or on a wider boundary for
+// SIMD kernels that want aligned loads of the whole register.
+template <typename T, std::size_t Alignment = 64>
+using aligned_vector = vector<T, doubling_growth, Alignment>;
+
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+BasicVector<T, N, Growth, Alignment>::BasicVector()
+    : p_(this->inlineData()), size_(0), capacity_(N) {}
+
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+BasicVector<T, N, Growth, Alignment>::BasicVector(size_type n)
+    : p_(storageFor(n)), size_(0), capacity_(std::max(n, N)) {
+  try {
+    for (; size_ < n; ++size_) new (p_ + size_) value_type();
+  } catch (...) {
+    deallocate();
+    throw;
+  }
+}
 
-template <typename T>
-vector<T>::vector(std::initializer_list<value_type> const &items) {
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+BasicVector<T, N, Growth, Alignment>::BasicVector(
+    std::initializer_list<value_type> const &items)
+    : p_(storageFor(items.size())),
+      size_(0),
+      capacity_(std::max(items.size(), N)) {
+  try {
+    copyConstruct(items.begin(), items.size(), p_);
+  } catch (...) {
+    releaseStorage(p_);
+    throw;
+  }
   size_ = items.size();
-  capacity_ = size_;
-  p_ = new value_type[size_];
-  pasteData(items.begin(), items.size());
 }
 
-template <typename T>
-vector<T>::vector(const vector &v) {
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+BasicVector<T, N, Growth, Alignment>::BasicVector(const BasicVector &v)
+    : p_(storageFor(v.capacity_)), size_(0), capacity_(v.capacity_) {
+  try {
+    copyConstruct(v.p_, v.size_, p_);
+  } catch (...) {
+    releaseStorage(p_);
+    throw;
+  }
   size_ = v.size_;
-  capacity_ = v.capacity_;
-  p_ = new value_type[v.capacity_]();
-  pasteData(v.p_, v.size_);
 }
 
-template <typename T>
-vector<T>::vector(vector &&v) {
-  size_ = v.size_;
-  capacity_ = v.capacity_;
-  p_ = v.p_;
-  v.size_ = 0;
-  v.capacity_ = 0;
-  v.p_ = nullptr;
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+BasicVector<T, N, Growth, Alignment>::BasicVector(
+    BasicVector &&v) noexcept(kNothrowMove)
+    : p_(this->inlineData()), size_(0), capacity_(N) {
+  takeFrom(v);
 }
 
-template <typename T>
-vector<T>::~vector() {
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+BasicVector<T, N, Growth, Alignment>::~BasicVector() {
   deallocate();
 }
 
-template <typename T>
-vector<T> &vector<T>::operator=(vector<T> &&v) {
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+BasicVector<T, N, Growth, Alignment> &
+BasicVector<T, N, Growth, Alignment>::operator=(
+    BasicVector &&v) noexcept(kNothrowMove) {
   if (this == &v) {
     return *this;
   }
   deallocate();
-  size_ = v.size_;
-  capacity_ = v.capacity_;
-  p_ = v.p_;
-  v.size_ = 0;
-  v.capacity_ = 0;
-  v.p_ = nullptr;
+  takeFrom(v);
   return *this;
 }
 
-template <typename T>
-typename vector<T>::reference vector<T>::at(size_type pos) {
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+typename BasicVector<T, N, Growth, Alignment>::reference
+BasicVector<T, N, Growth, Alignment>::at(size_type pos) {
   if (pos >= size_) {
     throw std::out_of_range("Error: Index out of range");
   }
   return p_[pos];
 }
 
-template <typename T>
-typename vector<T>::reference vector<T>::operator[](size_type pos) {
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+typename BasicVector<T, N, Growth, Alignment>::reference
+BasicVector<T, N, Growth, Alignment>::operator[](size_type pos) {
   return p_[pos];
 }
 
-template <typename T>
-typename vector<T>::const_reference vector<T>::front() {
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+typename BasicVector<T, N, Growth, Alignment>::const_reference
+BasicVector<T, N, Growth, Alignment>::front() {
   return p_[0];
 }
 
-template <typename T>
-typename vector<T>::const_reference vector<T>::back() {
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+typename BasicVector<T, N, Growth, Alignment>::const_reference
+BasicVector<T, N, Growth, Alignment>::back() {
   return p_[size_ - 1];
 }
 
-template <typename T>
-T *vector<T>::data() {
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+T *BasicVector<T, N, Growth, Alignment>::data() {
+  return p_;
+}
+
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+const T *BasicVector<T, N, Growth, Alignment>::data() const {
   return p_;
 }
 
-template <typename T>
-typename vector<T>::iterator vector<T>::begin() {
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+typename BasicVector<T, N, Growth, Alignment>::iterator
+BasicVector<T, N, Growth, Alignment>::begin() {
   return p_;
 }
 
-template <typename T>
-typename vector<T>::iterator vector<T>::end() {
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+typename BasicVector<T, N, Growth, Alignment>::iterator
+BasicVector<T, N, Growth, Alignment>::end() {
   return p_ + size_;
 }
 
-template <typename T>
-bool vector<T>::empty() {
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+typename BasicVector<T, N, Growth, Alignment>::const_iterator
+BasicVector<T, N, Growth, Alignment>::begin() const {
+  return p_;
+}
+
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+typename BasicVector<T, N, Growth, Alignment>::const_iterator
+BasicVector<T, N, Growth, Alignment>::end() const {
+  return p_ + size_;
+}
+
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+bool BasicVector<T, N, Growth, Alignment>::empty() const {
   return size_ == 0;
 }
 
-template <typename T>
-typename vector<T>::size_type vector<T>::size() {
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+typename BasicVector<T, N, Growth, Alignment>::size_type
+BasicVector<T, N, Growth, Alignment>::size() const {
   return size_;
 }
 
-template <typename T>
-typename vector<T>::size_type vector<T>::max_size() {
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+typename BasicVector<T, N, Growth, Alignment>::size_type
+BasicVector<T, N, Growth, Alignment>::max_size() {
   return std::numeric_limits<size_type>::max() / sizeof(value_type);
 }
 
-template <typename T>
-void vector<T>::reserve(size_type size) {
-  if (size > capacity_) {
-    auto resize = new value_type[size]();
-    copyData(resize, size);
-    deallocate();
-    p_ = resize;
-    capacity_ = size;
-  }
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+void BasicVector<T, N, Growth, Alignment>::reserve(size_type size) {
+  if (size > capacity_) reallocate(size);
 }
 
-template <typename T>
-typename vector<T>::size_type vector<T>::capacity() {
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+typename BasicVector<T, N, Growth, Alignment>::size_type
+BasicVector<T, N, Growth, Alignment>::capacity() {
   return capacity_;
 }
 
-template <typename T>
-void vector<T>::shrink_to_fit() {
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+void BasicVector<T, N, Growth, Alignment>::shrink_to_fit() {
   adjustCapacity(size_);
 }
 
-template <typename T>
-void vector<T>::clear() {
-  size_ = 0;
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+void BasicVector<T, N, Growth, Alignment>::clear() {
+  destroyElements(0);
 }
 
-template <typename T>
-typename vector<T>::iterator vector<T>::insert(iterator pos,
-                                               const_reference value) {
-  if (pos == end()) {
-    push_back(value);
-    pos = end();
-    return --pos;
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+typename BasicVector<T, N, Growth, Alignment>::iterator
+BasicVector<T, N, Growth, Alignment>::insert(iterator pos,
+                                             const_reference value) {
+  return emplace(pos, value);
+}
+
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+typename BasicVector<T, N, Growth, Alignment>::iterator
+BasicVector<T, N, Growth, Alignment>::insert(iterator pos, value_type &&value) {
+  return emplace(pos, std::move(value));
+}
+
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+typename BasicVector<T, N, Growth, Alignment>::iterator
+BasicVector<T, N, Growth, Alignment>::insert(
+    const_iterator pos, std::initializer_list<value_type> items) {
+  return insert(pos, items.begin(), items.end());
+}
+
+// Forward ranges are built straight into the gap. Single-pass input ranges
+// are appended and then rotated into place. The range must not point into
+// this vector.
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+template <typename InputIt>
+typename BasicVector<T, N, Growth, Alignment>::iterator
+BasicVector<T, N, Growth, Alignment>::insert(const_iterator pos, InputIt first,
+                                             InputIt last) {
+  size_type offset = pos - begin();
+  using Category = typename std::iterator_traits<InputIt>::iterator_category;
+  if constexpr (std::is_base_of_v<std::forward_iterator_tag, Category>) {
+    size_type count = std::distance(first, last);
+    return insertConstructed(
+        offset, count, [&](value_type *gap, size_type &built) {
+          for (; first != last; ++first) {
+            new (gap + built) value_type(*first);
+            ++built;
+          }
+        });
+  } else {
+    size_type old_size = size_;
+    for (; first != last; ++first) emplace_back(*first);
+    std::rotate(begin() + offset, begin() + old_size, end());
+    return begin() + offset;
   }
-  difference_type offset = pos - begin();
-  resizeIfNeeded();
-  auto insert_pos = begin() + offset;
-  pos = insert_pos;
-  value_type displaced_item = *pos;
-  *pos = value;
-  pos++;
-  for (; pos <= end(); ++pos) {
-    std::swap(*pos, displaced_item);
+}
+
+// Appending constructs the element in place. Anywhere else it is built
+// first, since args may refer to elements about to be shifted, and then
+// moved into the gap.
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+template <typename... Args>
+typename BasicVector<T, N, Growth, Alignment>::iterator
+BasicVector<T, N, Growth, Alignment>::emplace(const_iterator pos,
+                                              Args &&...args) {
+  size_type offset = pos - begin();
+  if (offset == size_) {
+    emplace_back(std::forward<Args>(args)...);
+    return begin() + offset;
   }
-  ++size_;
-  return insert_pos;
+  value_type item(std::forward<Args>(args)...);
+  return insertConstructed(offset, 1,
+                           [&item](value_type *gap, size_type &built) {
+                             new (gap) value_type(std::move(item));
+                             ++built;
+                           });
 }
 
-template <typename T>
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
 template <typename... Args>
-typename vector<T>::iterator vector<T>::insert_many(const_iterator pos,
-                                                    Args &&...args) {
-  difference_type offset = pos - begin();
-  resizeIfNeeded(sizeof...(args));
-  auto return_pos = begin() + offset;
-  (insert(return_pos++, value_type(std::forward<Args>(args))), ...);
-  return_pos = begin() + offset;
-  return return_pos;
+typename BasicVector<T, N, Growth, Alignment>::reference
+BasicVector<T, N, Growth, Alignment>::emplace_back(Args &&...args) {
+  if (size_ == capacity_) {
+    reallocateAndEmplace(std::forward<Args>(args)...);
+  } else {
+    new (p_ + size_) value_type(std::forward<Args>(args)...);
+  }
+  return p_[size_++];
 }
 
-template <typename T>
+// Constructs every argument in place after a single tail shift. The
+// arguments must not refer to elements at or after pos.
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
 template <typename... Args>
-void vector<T>::insert_many_back(Args &&...args) {
-  resizeIfNeeded(sizeof...(args));
-  (push_back(value_type(std::forward<Args>(args))), ...);
+typename BasicVector<T, N, Growth, Alignment>::iterator
+BasicVector<T, N, Growth, Alignment>::insert_many(const_iterator pos,
+                                                  Args &&...args) {
+  size_type offset = pos - begin();
+  if constexpr (sizeof...(args) == 0) {
+    return begin() + offset;
+  } else {
+    return insertConstructed(
+        offset, sizeof...(args), [&](value_type *gap, size_type &built) {
+          ((new (gap + built) value_type(std::forward<Args>(args)), ++built),
+           ...);
+        });
+  }
+}
+
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+template <typename... Args>
+void BasicVector<T, N, Growth, Alignment>::insert_many_back(Args &&...args) {
+  insert_many(end(), std::forward<Args>(args)...);
 }
 
-template <typename T>
-void vector<T>::erase(iterator pos) {
-  auto next = pos;
-  next++;
-  for (; next < end(); ++next, ++pos) {
-    std::swap(*next, *pos);
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+typename BasicVector<T, N, Growth, Alignment>::iterator
+BasicVector<T, N, Growth, Alignment>::erase(const_iterator pos) {
+  return erase(pos, pos + 1);
+}
+
+// Destroys [first, last) and moves the tail down over the hole once.
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+typename BasicVector<T, N, Growth, Alignment>::iterator
+BasicVector<T, N, Growth, Alignment>::erase(const_iterator first,
+                                            const_iterator last) {
+  size_type offset = first - begin();
+  size_type count = last - first;
+  if (count > 0) {
+    value_type *hole = p_ + offset;
+    destroy(hole, count);
+    relocateWithin(hole + count, size_ - offset - count, hole);
+    size_ -= count;
   }
-  --size_;
+  return begin() + offset;
 }
 
-template <typename T>
-void vector<T>::push_back(const_reference value) {
-  resizeIfNeeded();
-  p_[size_++] = value;
+// Fills pos with the last element instead of shifting the tail, so the
+// order of the remaining elements is not kept. Returns pos, which now holds
+// the former last element (or end() if pos was last).
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+typename BasicVector<T, N, Growth, Alignment>::iterator
+BasicVector<T, N, Growth, Alignment>::unordered_erase(const_iterator pos) {
+  size_type offset = pos - begin();
+  if (offset + 1 != size_) p_[offset] = std::move(p_[size_ - 1]);
+  pop_back();
+  return begin() + offset;
 }
 
-template <typename T>
-void vector<T>::pop_back() {
-  --size_;
+// Removes every element for which pred is true in one pass, keeping the
+// order of the rest, and returns how many were removed.
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+template <typename Predicate>
+typename BasicVector<T, N, Growth, Alignment>::size_type
+BasicVector<T, N, Growth, Alignment>::erase_if(Predicate pred) {
+  size_type kept = 0;
+  for (size_type i = 0; i < size_; ++i) {
+    if (pred(p_[i])) continue;
+    if (kept != i) p_[kept] = std::move(p_[i]);
+    ++kept;
+  }
+  size_type removed = size_ - kept;
+  destroyElements(kept);
+  return removed;
 }
 
-template <typename T>
-void vector<T>::swap(vector &other) {
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+void BasicVector<T, N, Growth, Alignment>::push_back(const_reference value) {
+  emplace_back(value);
+}
+
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+void BasicVector<T, N, Growth, Alignment>::push_back(value_type &&value) {
+  emplace_back(std::move(value));
+}
+
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+void BasicVector<T, N, Growth, Alignment>::pop_back() {
+  p_[--size_].~value_type();
+}
+
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+void BasicVector<T, N, Growth, Alignment>::swap(BasicVector &other) {
   std::swap(*this, other);
 }
 
-template <typename T>
-void vector<T>::resizeIfNeeded(size_type incoming_amount) {
-  if (capacity_ <= size_ + incoming_amount) {
-    if (capacity_ == 0) capacity_ = 1;
-    while (capacity_ < (size_ + incoming_amount)) capacity_ = 2 * capacity_;
-    auto resize = new value_type[capacity_]();
-    copyData(resize, capacity_);
-    deallocate();
-    p_ = resize;
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+void BasicVector<T, N, Growth, Alignment>::resize(size_type n) {
+  if (n <= size_) {
+    destroyElements(n);
+    return;
   }
+  size_type count = n - size_;
+  insertConstructed(size_, count, [count](value_type *gap, size_type &built) {
+    for (; built < count; ++built) new (gap + built) value_type();
+  });
 }
 
-template <typename T>
-void vector<T>::adjustCapacity(size_type capacity) {
-  auto adjusted = new value_type[capacity]();
-  copyData(adjusted, capacity);
-  deallocate();
+// When the vector grows into fresh storage the copies are made before the
+// old elements move, so value may be one of them.
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+void BasicVector<T, N, Growth, Alignment>::resize(size_type n,
+                                                  const_reference value) {
+  if (n <= size_) {
+    destroyElements(n);
+    return;
+  }
+  size_type count = n - size_;
+  insertConstructed(size_, count, [&](value_type *gap, size_type &built) {
+    for (; built < count; ++built) new (gap + built) value_type(value);
+  });
+}
+
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+void BasicVector<T, N, Growth, Alignment>::resize_default_init(size_type n) {
+  static_assert(std::is_trivially_default_constructible_v<value_type> &&
+                    std::is_trivially_destructible_v<value_type>,
+                "resize_default_init needs a trivial element type");
+  resize_for_overwrite(n);
+}
+
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+void BasicVector<T, N, Growth, Alignment>::resize_for_overwrite(size_type n) {
+  static_assert(kTrivial && std::is_trivially_destructible_v<value_type>,
+                "resize_for_overwrite needs a trivially copyable element type");
+  if (n <= size_) {
+    size_ = n;
+    return;
+  }
+  // The bytes copied in later make the objects; no constructor runs.
+  size_type count = n - size_;
+  insertConstructed(size_, count,
+                    [count](value_type *, size_type &built) { built = count; });
+}
+
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+void BasicVector<T, N, Growth, Alignment>::sort() {
+  sort(std::less<>());
+}
+
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+template <typename Compare>
+void BasicVector<T, N, Growth, Alignment>::sort(Compare comp) {
+  sort_detail::sort(p_, p_ + size_, comp);
+}
+
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+void BasicVector<T, N, Growth, Alignment>::stable_sort() {
+  stable_sort(std::less<>());
+}
+
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+template <typename Compare>
+void BasicVector<T, N, Growth, Alignment>::stable_sort(Compare comp) {
+  sort_detail::stableSort(p_, p_ + size_, comp);
+}
+
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+template <typename Projection>
+void BasicVector<T, N, Growth, Alignment>::sort_by_key(Projection key) {
+  sort_detail::sortByKey(p_, size_, key);
+}
+
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+typename BasicVector<T, N, Growth, Alignment>::size_type
+BasicVector<T, N, Growth, Alignment>::grownCapacity(
+    size_type incoming_amount) const {
+  return Growth::next(capacity_, size_ + incoming_amount);
+}
+
+// Opens a gap of count slots at offset and calls construct(gap, built),
+// which builds the new elements in order and counts them in built. When the
+// storage is full the new elements go straight into the fresh buffer and the
+// old ones move around them; otherwise the tail is shifted once.
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+template <typename Construct>
+typename BasicVector<T, N, Growth, Alignment>::iterator
+BasicVector<T, N, Growth, Alignment>::insertConstructed(size_type offset,
+                                                        size_type count,
+                                                        Construct construct) {
+  if (count == 0) return begin() + offset;
+  size_type built = 0;
+  size_type tail = size_ - offset;
+  if (size_ + count > capacity_) {
+    size_type capacity = grownCapacity(count);
+    value_type *fresh = allocate(capacity);
+    try {
+      construct(fresh + offset, built);
+      transfer(p_, offset, fresh);
+      try {
+        transfer(p_ + offset, tail, fresh + offset + count);
+      } catch (...) {
+        destroy(fresh, offset);
+        throw;
+      }
+    } catch (...) {
+      destroy(fresh + offset, built);
+      release(fresh);
+      throw;
+    }
+    destroy(p_, size_);
+    releaseStorage(p_);
+    p_ = fresh;
+    capacity_ = capacity;
+  } else {
+    value_type *gap = p_ + offset;
+    relocateWithin(gap, tail, gap + count);
+    try {
+      construct(gap, built);
+    } catch (...) {
+      destroy(gap, built);
+      relocateWithin(gap + count, tail, gap);
+      throw;
+    }
+  }
+  size_ += count;
+  return begin() + offset;
+}
+
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+void BasicVector<T, N, Growth, Alignment>::adjustCapacity(size_type capacity) {
+  if (capacity != capacity_) reallocate(capacity);
+}
+
+// Moves the live elements into fresh storage of the given capacity, which
+// must be at least size_. Capacities up to N map to the inline buffer.
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+void BasicVector<T, N, Growth, Alignment>::reallocate(size_type capacity) {
+  capacity = std::max(capacity, N);
+  if (capacity == N && isInline()) return;
+  value_type *fresh = storageFor(capacity);
+  try {
+    relocate(p_, size_, fresh);
+  } catch (...) {
+    releaseStorage(fresh);
+    throw;
+  }
+  releaseStorage(p_);
+  p_ = fresh;
+  capacity_ = capacity;
+}
+
+// Grows a full vector, building the new last element in the fresh storage
+// before the old elements move, so args may refer to one of them. size_ is
+// left for the caller to bump.
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+template <typename... Args>
+void BasicVector<T, N, Growth, Alignment>::reallocateAndEmplace(
+    Args &&...args) {
+  size_type capacity = grownCapacity(1);
+  value_type *fresh = allocate(capacity);
+  try {
+    new (fresh + size_) value_type(std::forward<Args>(args)...);
+  } catch (...) {
+    release(fresh);
+    throw;
+  }
+  try {
+    relocate(p_, size_, fresh);
+  } catch (...) {
+    fresh[size_].~value_type();
+    release(fresh);
+    throw;
+  }
+  releaseStorage(p_);
+  p_ = fresh;
   capacity_ = capacity;
-  p_ = adjusted;
 }
 
-template <typename T>
-void vector<T>::copyData(value_type *arr, size_type size) {
-  for (size_type i = 0; i < size && i < size_; ++i) {
-    arr[i] = p_[i];
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+void BasicVector<T, N, Growth, Alignment>::destroyElements(size_type from) {
+  while (size_ > from) p_[--size_].~value_type();
+}
+
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+void BasicVector<T, N, Growth, Alignment>::deallocate() {
+  destroyElements(0);
+  releaseStorage(p_);
+  p_ = this->inlineData();
+  capacity_ = N;
+}
+
+// Takes over the elements of v, which is left empty. Heap storage changes
+// hands; inline elements are moved one by one.
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+void BasicVector<T, N, Growth, Alignment>::takeFrom(BasicVector &v) {
+  if (v.isInline()) {
+    relocate(v.p_, v.size_, p_);
+    size_ = v.size_;
+    v.size_ = 0;
+    return;
+  }
+  p_ = v.p_;
+  size_ = v.size_;
+  capacity_ = v.capacity_;
+  v.p_ = v.inlineData();
+  v.size_ = 0;
+  v.capacity_ = N;
+}
+
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+typename BasicVector<T, N, Growth, Alignment>::value_type *
+BasicVector<T, N, Growth, Alignment>::storageFor(size_type capacity) {
+  return capacity <= N ? this->inlineData() : allocate(capacity);
+}
+
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+void BasicVector<T, N, Growth, Alignment>::releaseStorage(
+    value_type *p) noexcept {
+  if (N == 0 || p != this->inlineData()) release(p);
+}
+
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+typename BasicVector<T, N, Growth, Alignment>::value_type *
+BasicVector<T, N, Growth, Alignment>::allocate(size_type n) {
+  if (n == 0) return nullptr;
+  if (n > std::numeric_limits<size_type>::max() / sizeof(value_type)) {
+    throw std::length_error("Error: vector capacity overflow");
+  }
+  if constexpr (kOverAligned) {
+    return static_cast<value_type *>(
+        ::operator new(n * sizeof(value_type), std::align_val_t(Alignment)));
+  } else {
+    return static_cast<value_type *>(::operator new(n * sizeof(value_type)));
+  }
+}
+
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+void BasicVector<T, N, Growth, Alignment>::release(value_type *p) {
+  if constexpr (kOverAligned) {
+    ::operator delete(p, std::align_val_t(Alignment));
+  } else {
+    ::operator delete(p);
+  }
+}
+
+// Copy-constructs n elements into raw storage; on failure destroys the ones
+// already built before rethrowing.
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+void BasicVector<T, N, Growth, Alignment>::copyConstruct(const value_type *from,
+                                                         size_type n,
+                                                         value_type *to) {
+  if constexpr (kTrivial) {
+    if (n > 0) std::memcpy(to, from, n * sizeof(value_type));
+    return;
+  }
+  size_type i = 0;
+  try {
+    for (; i < n; ++i) new (to + i) value_type(from[i]);
+  } catch (...) {
+    while (i > 0) to[--i].~value_type();
+    throw;
+  }
+}
+
+// Builds n elements in separate raw storage from the ones at from, leaving
+// the originals alive. Elements are moved when that cannot throw (or is the
+// only option) and copied otherwise, so a throwing copy leaves the source
+// intact.
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+void BasicVector<T, N, Growth, Alignment>::transfer(value_type *from,
+                                                    size_type n,
+                                                    value_type *to) {
+  if constexpr (kTrivial || !kMoveOnRelocate) {
+    copyConstruct(from, n, to);
+  } else {
+    size_type i = 0;
+    try {
+      for (; i < n; ++i) new (to + i) value_type(std::move(from[i]));
+    } catch (...) {
+      destroy(to, i);
+      throw;
+    }
+  }
+}
+
+// Transfers n elements to separate raw storage and destroys the originals.
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+void BasicVector<T, N, Growth, Alignment>::relocate(value_type *from,
+                                                    size_type n,
+                                                    value_type *to) {
+  transfer(from, n, to);
+  destroy(from, n);
+}
+
+// Moves n elements to a possibly overlapping position inside the same
+// buffer; the destination slots not covered by the source must be raw.
+// Afterwards the source slots not covered by the destination are raw.
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+void BasicVector<T, N, Growth, Alignment>::relocateWithin(value_type *from,
+                                                          size_type n,
+                                                          value_type *to) {
+  if (n == 0 || from == to) return;
+  if constexpr (kTrivial) {
+    std::memmove(to, from, n * sizeof(value_type));
+  } else if (to > from) {
+    for (size_type i = n; i > 0; --i) {
+      new (to + i - 1) value_type(std::move(from[i - 1]));
+      from[i - 1].~value_type();
+    }
+  } else {
+    for (size_type i = 0; i < n; ++i) {
+      new (to + i) value_type(std::move(from[i]));
+      from[i].~value_type();
+    }
   }
 }
 
-template <typename T>
-void vector<T>::pasteData(const value_type *arr, size_type size) {
-  clear();
-  for (size_type i = 0; i < size; ++i) {
-    p_[i] = arr[i];
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+void BasicVector<T, N, Growth, Alignment>::destroy(value_type *first,
+                                                   size_type n) noexcept {
+  if constexpr (!std::is_trivially_destructible_v<value_type>) {
+    for (size_type i = 0; i < n; ++i) first[i].~value_type();
   }
-  size_ = size;
 }
 
-template <typename T>
-void vector<T>::deallocate() {
-  delete[] p_;
-  p_ = nullptr;
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment,
+          typename Predicate>
+typename BasicVector<T, N, Growth, Alignment>::size_type erase_if(
+    BasicVector<T, N, Growth, Alignment> &v, Predicate pred) {
+  return v.erase_if(pred);
 }
 }  // namespace lib
 
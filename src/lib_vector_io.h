@@ -0,0 +1,246 @@
+#ifndef LIB_VECTOR_IO_H_
+#define LIB_VECTOR_IO_H_
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include "lib_vector.h"
+
+namespace lib {
+// Bulk transfer between files and vectors of trivially copyable records
+// (POSIX only). A file holds the raw elements and nothing else, the layout
+// mmap_vector maps. Reads grow the vector once with resize_for_overwrite and
+// pread straight into its storage; writes pwrite straight out of it. Both
+// loop over short transfers and EINTR, so one call moves the whole range.
+//
+// The storage of an aligned_vector<T, 4096> meets O_DIRECT's buffer
+// alignment: a descriptor opened with O_DIRECT then transfers between the
+// device and the vector without the page cache, provided the offset and the
+// byte count are block multiples too.
+//
+// Failing system calls throw std::system_error, and a file that ends inside
+// a record throws std::runtime_error. Either way the vector keeps the
+// elements it had.
+namespace io_detail {
+[[noreturn]] inline void fail(const char *what) {
+  throw std::system_error(errno, std::generic_category(), what);
+}
+
+// Reads bytes from offset on; fewer come back only at end of file.
+inline std::size_t readAt(int fd, void *data, std::size_t bytes,
+                          off_t offset) {
+  char *p = static_cast<char *>(data);
+  std::size_t done = 0;
+  while (done < bytes) {
+    ssize_t n = ::pread(fd, p + done, bytes - done,
+                        offset + static_cast<off_t>(done));
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      fail("pread");
+    }
+    if (n == 0) break;
+    done += static_cast<std::size_t>(n);
+  }
+  return done;
+}
+
+inline void writeAt(int fd, const void *data, std::size_t bytes,
+                    off_t offset) {
+  const char *p = static_cast<const char *>(data);
+  std::size_t done = 0;
+  while (done < bytes) {
+    ssize_t n = ::pwrite(fd, p + done, bytes - done,
+                         offset + static_cast<off_t>(done));
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      fail("pwrite");
+    }
+    done += static_cast<std::size_t>(n);
+  }
+}
+
+// Owns a descriptor opened by path for the length of one call.
+class File {
+ public:
+  File(const std::string &path, int flags) {
+    fd_ = ::open(path.c_str(), flags | O_CLOEXEC, 0644);
+    if (fd_ < 0) fail("open");
+  }
+  File(const File &) = delete;
+  File &operator=(const File &) = delete;
+  ~File() { ::close(fd_); }
+
+  int fd() const noexcept { return fd_; }
+  // Records of record_size in the file, which must hold whole ones.
+  std::size_t records(const std::string &path, std::size_t record_size) {
+    struct stat info;
+    if (::fstat(fd_, &info) != 0) fail("fstat");
+    std::size_t bytes = static_cast<std::size_t>(info.st_size);
+    if (bytes % record_size != 0) {
+      throw std::runtime_error(path + ": size is not a multiple of the record");
+    }
+    return bytes / record_size;
+  }
+  // Asks the kernel for aggressive readahead; only a hint.
+  void adviseSequential() noexcept {
+    ::posix_fadvise(fd_, 0, 0, POSIX_FADV_SEQUENTIAL);
+  }
+
+ private:
+  int fd_;
+};
+}  // namespace io_detail
+
+// Appends up to count records read from fd at byte offset and returns how
+// many arrived: fewer than count means the file ended. fd must be seekable;
+// its file position is left alone.
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+std::size_t append_from(BasicVector<T, N, Growth, Alignment> &v, int fd,
+                        std::size_t count, off_t offset = 0) {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "append_from reads raw bytes of trivially copyable T");
+  if (count > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+    throw std::length_error("append_from count too large");
+  }
+  std::size_t old_size = v.size();
+  v.resize_for_overwrite(old_size + count);
+  std::size_t bytes = 0;
+  try {
+    bytes = io_detail::readAt(fd, v.data() + old_size, count * sizeof(T),
+                              offset);
+  } catch (...) {
+    v.resize_for_overwrite(old_size);
+    throw;
+  }
+  if (bytes % sizeof(T) != 0) {
+    v.resize_for_overwrite(old_size);
+    throw std::runtime_error("file ends inside a record");
+  }
+  v.resize_for_overwrite(old_size + bytes / sizeof(T));
+  return bytes / sizeof(T);
+}
+
+// Appends every record of the file at path and returns how many.
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+std::size_t append_from(BasicVector<T, N, Growth, Alignment> &v,
+                        const std::string &path) {
+  io_detail::File file(path, O_RDONLY);
+  std::size_t count = file.records(path, sizeof(T));
+  file.adviseSequential();
+  return append_from(v, file.fd(), count);
+}
+
+// Writes the elements to fd at byte offset. fd must be seekable; its file
+// position is left alone.
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+void write_to(const BasicVector<T, N, Growth, Alignment> &v, int fd,
+              off_t offset = 0) {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "write_to writes raw bytes of trivially copyable T");
+  io_detail::writeAt(fd, v.data(), v.size() * sizeof(T), offset);
+}
+
+// Replaces the file at path, creating it if missing, by the elements.
+template <typename T, std::size_t N, typename Growth, std::size_t Alignment>
+void write_to(const BasicVector<T, N, Growth, Alignment> &v,
+              const std::string &path) {
+  io_detail::File file(path, O_WRONLY | O_CREAT | O_TRUNC);
+  write_to(v, file.fd());
+}
+
+// Streams a file of records too large for one buffer: each next() call
+// replaces the contents of a caller's vector by the following chunk of at
+// most chunk_size() records. Passing the same vector every time reuses its
+// storage, so a pass over the file allocates once.
+template <typename T>
+class record_reader {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "record_reader reads raw bytes of trivially copyable T");
+
+ public:
+  using size_type = std::size_t;
+
+  // About 1 MiB of records.
+  static constexpr size_type kDefaultChunkSize =
+      std::max<size_type>((size_type(1) << 20) / sizeof(T), 1);
+
+  explicit record_reader(const std::string &path,
+                         size_type chunk_size = kDefaultChunkSize);
+  record_reader(const record_reader &) = delete;
+  record_reader(record_reader &&other) noexcept;
+  ~record_reader();
+  record_reader &operator=(const record_reader &) = delete;
+  record_reader &operator=(record_reader &&other) noexcept;
+
+  // Returns false, leaving chunk empty, once the file is exhausted.
+  template <std::size_t N, typename Growth, std::size_t Alignment>
+  bool next(BasicVector<T, N, Growth, Alignment> &chunk);
+
+  size_type chunk_size() const noexcept { return chunk_size_; }
+  // Records handed out so far.
+  size_type position() const noexcept { return position_; }
+
+ private:
+  int fd_;
+  size_type chunk_size_;
+  size_type position_;
+};
+
+template <typename T>
+record_reader<T>::record_reader(const std::string &path,
+                                size_type chunk_size)
+    : fd_(-1), chunk_size_(chunk_size), position_(0) {
+  if (chunk_size == 0) {
+    throw std::invalid_argument("record_reader chunk size must be positive");
+  }
+  fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd_ < 0) io_detail::fail("open");
+  ::posix_fadvise(fd_, 0, 0, POSIX_FADV_SEQUENTIAL);
+}
+
+template <typename T>
+record_reader<T>::record_reader(record_reader &&other) noexcept
+    : fd_(std::exchange(other.fd_, -1)),
+      chunk_size_(other.chunk_size_),
+      position_(std::exchange(other.position_, 0)) {}
+
+template <typename T>
+record_reader<T>::~record_reader() {
+  if (fd_ >= 0) ::close(fd_);
+}
+
+template <typename T>
+record_reader<T> &record_reader<T>::operator=(record_reader &&other) noexcept {
+  if (this != &other) {
+    if (fd_ >= 0) ::close(fd_);
+    fd_ = std::exchange(other.fd_, -1);
+    chunk_size_ = other.chunk_size_;
+    position_ = std::exchange(other.position_, 0);
+  }
+  return *this;
+}
+
+template <typename T>
+template <std::size_t N, typename Growth, std::size_t Alignment>
+bool record_reader<T>::next(BasicVector<T, N, Growth, Alignment> &chunk) {
+  if (fd_ < 0) throw std::logic_error("record_reader is not open");
+  chunk.clear();
+  size_type count = append_from(chunk, fd_, chunk_size_,
+                                static_cast<off_t>(position_ * sizeof(T)));
+  position_ += count;
+  return count > 0;
+}
+}  // namespace lib
+
+#endif  // LIB_VECTOR_IO_H_
@@ -0,0 +1,226 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../lib_containersplus.h"
+
+namespace {
+lib::vector<int> randomInts(std::size_t n, int range) {
+  std::mt19937 gen(static_cast<unsigned>(n));
+  std::uniform_int_distribution<int> dist(-range, range);
+  lib::vector<int> values;
+  for (std::size_t i = 0; i < n; ++i) values.push_back(dist(gen));
+  return values;
+}
+
+std::vector<int> toStd(lib::vector<int>& values) {
+  return std::vector<int>(values.begin(), values.end());
+}
+}  // namespace
+
+TEST(Algorithm, ParallelSortMatchesStdSort) {
+  lib::thread_pool pool(4);
+  lib::thread_pool odd_pool(3);
+  for (std::size_t n : {0, 1, 17, 20000, 100003, 300000}) {
+    lib::vector<int> values = randomInts(n, 1000);
+    std::vector<int> expected = toStd(values);
+    std::sort(expected.begin(), expected.end());
+    lib::vector<int> copy = values;
+
+    lib::parallel_sort(values, std::less<>(), pool);
+    EXPECT_EQ(expected, toStd(values)) << n;
+    lib::parallel_sort(copy.begin(), copy.end(), std::greater<>(), odd_pool);
+    std::reverse(expected.begin(), expected.end());
+    EXPECT_EQ(expected, toStd(copy)) << n;
+  }
+}
+
+TEST(Algorithm, ParallelSortMovesElements) {
+  lib::thread_pool pool(4);
+  lib::vector<std::string> words;
+  for (int i = 0; i < 10000; ++i) {
+    words.push_back(std::to_string(i * 7919 % 10000) + std::string(20, 'x'));
+  }
+  std::vector<std::string> expected(words.begin(), words.end());
+  std::sort(expected.begin(), expected.end());
+  lib::parallel_sort(words, std::less<>(), pool);
+  ASSERT_EQ(expected.size(), words.size());
+  for (std::size_t i = 0; i < words.size(); ++i) {
+    EXPECT_EQ(expected[i], words[i]);
+  }
+}
+
+namespace {
+// Not default constructible; counts the live instances.
+struct Ranked {
+  explicit Ranked(int r) : rank(r) { ++live; }
+  Ranked(const Ranked& other) : rank(other.rank) { ++live; }
+  Ranked& operator=(const Ranked&) = default;
+  ~Ranked() { --live; }
+
+  int rank;
+  static int live;
+};
+int Ranked::live = 0;
+}  // namespace
+
+TEST(Algorithm, ParallelSortNeedsNoDefaultConstructor) {
+  lib::thread_pool pool(4);
+  const int n = 200000;
+  {
+    lib::vector<Ranked> values;
+    for (int i = 0; i < n; ++i) values.push_back(Ranked(i * 7919 % n));
+    auto by_rank = [](const Ranked& a, const Ranked& b) {
+      return a.rank < b.rank;
+    };
+    lib::parallel_sort(values, by_rank, pool);
+    for (int i = 0; i < n; ++i) ASSERT_EQ(i, values[i].rank);
+    EXPECT_EQ(n, Ranked::live);
+
+    // Four runs, then two merges of about n comparisons each. Failing
+    // 1.5 * n comparisons before the end lands in the first merge, which
+    // fills the buffer.
+    std::atomic<int> calls{0};
+    int fail_at = -1;
+    auto failing = [&](const Ranked& a, const Ranked& b) {
+      if (++calls == fail_at) throw std::runtime_error("compare");
+      return a.rank < b.rank;
+    };
+    lib::vector<Ranked> shuffled = values;
+    std::mt19937 gen(5);
+    std::shuffle(shuffled.begin(), shuffled.end(), gen);
+    lib::vector<Ranked> copy = shuffled;
+    lib::parallel_sort(copy, failing, pool);
+    fail_at = calls - n * 3 / 2;
+    calls = 0;
+    EXPECT_THROW(lib::parallel_sort(shuffled, failing, pool),
+                 std::runtime_error);
+    EXPECT_EQ(3 * n, Ranked::live);
+  }
+  EXPECT_EQ(0, Ranked::live);
+}
+
+TEST(Algorithm, SequentialSort) {
+  lib::vector<int> values = {5, 3, 9, 1, 3};
+  lib::sort(values);
+  EXPECT_EQ(std::vector<int>({1, 3, 3, 5, 9}), toStd(values));
+}
+
+TEST(Algorithm, ParallelReduceIsDeterministic) {
+  lib::vector<double> values;
+  std::mt19937 gen(7);
+  std::uniform_real_distribution<double> dist(-1.0, 1.0);
+  for (int i = 0; i < 200000; ++i) values.push_back(dist(gen) * 1e10);
+
+  lib::thread_pool single(1);
+  lib::thread_pool pool(4);
+  lib::thread_pool odd_pool(3);
+  double expected = lib::parallel_reduce(values, 0.0, std::plus<>(), single);
+  for (int round = 0; round < 5; ++round) {
+    EXPECT_EQ(expected, lib::parallel_reduce(values, 0.0, std::plus<>(), pool));
+    EXPECT_EQ(expected,
+              lib::parallel_reduce(values, 0.0, std::plus<>(), odd_pool));
+  }
+}
+
+TEST(Algorithm, ParallelReduceMatchesSequentialForIntegers) {
+  lib::thread_pool pool(4);
+  for (std::size_t n : {0, 1, 16384, 16385, 100003}) {
+    lib::vector<int> values = randomInts(n, 1000000);
+    long long expected = lib::reduce(values, 5LL);
+    EXPECT_EQ(expected,
+              lib::parallel_reduce(values, 5LL, std::plus<>(), pool));
+  }
+  lib::vector<int> values = randomInts(50000, 1000);
+  auto max = [](int a, int b) { return std::max(a, b); };
+  EXPECT_EQ(*std::max_element(values.begin(), values.end()),
+            lib::parallel_reduce(values.begin(), values.end(), -1000, max,
+                                 pool));
+}
+
+TEST(Algorithm, ParallelInclusiveScanMatchesSequential) {
+  lib::thread_pool pool(4);
+  for (std::size_t n : {0, 1, 16384, 16385, 100003}) {
+    lib::vector<int> values = randomInts(n, 100);
+    lib::vector<int> expected = values;
+    lib::inclusive_scan(expected);
+
+    lib::vector<int> out = values;
+    lib::parallel_inclusive_scan(values.begin(), values.end(), out.begin(),
+                                 std::plus<>(), pool);
+    EXPECT_EQ(toStd(expected), toStd(out)) << n;
+    lib::parallel_inclusive_scan(values, std::plus<>(), pool);
+    EXPECT_EQ(toStd(expected), toStd(values)) << n;
+  }
+}
+
+TEST(Algorithm, ParallelTransformAndForEach) {
+  lib::thread_pool pool(4);
+  lib::vector<int> values = randomInts(70000, 1000);
+  lib::vector<long long> squares(values.size());
+  lib::parallel_transform(
+      values.begin(), values.end(), squares.begin(),
+      [](int x) { return static_cast<long long>(x) * x; }, pool);
+  for (std::size_t i = 0; i < values.size(); ++i) {
+    ASSERT_EQ(static_cast<long long>(values[i]) * values[i], squares[i]);
+  }
+
+  lib::vector<int> doubled = values;
+  lib::parallel_transform(doubled, [](int x) { return 2 * x; }, pool);
+  std::atomic<long long> total{0};
+  lib::parallel_for_each(
+      doubled, [&](int x) { total += x; }, pool);
+  EXPECT_EQ(2 * lib::reduce(values, 0LL), total.load());
+}
+
+TEST(Algorithm, ReadOnlyFormsTakeConstVectors) {
+  lib::thread_pool pool(4);
+  const lib::vector<int> values = randomInts(70000, 1000);
+  long long expected = 0;
+  for (int x : values) expected += x;
+  EXPECT_EQ(expected, lib::reduce(values, 0LL));
+  EXPECT_EQ(expected, lib::parallel_reduce(values, 0LL, std::plus<>(), pool));
+
+  long long total = 0;
+  lib::for_each(values, [&](const int& x) { total += x; });
+  EXPECT_EQ(expected, total);
+  std::atomic<long long> parallel_total{0};
+  lib::parallel_for_each(
+      values, [&](const int& x) { parallel_total += x; }, pool);
+  EXPECT_EQ(expected, parallel_total.load());
+}
+
+TEST(Algorithm, SpanAndStridedViewForms) {
+  lib::thread_pool pool(4);
+  lib::vector<int> values = randomInts(50000, 1000);
+  std::vector<int> expected = toStd(values);
+
+  // Sort only the middle of the vector, in place.
+  lib::parallel_sort(lib::span<int>(values).subspan(100, 40000),
+                     std::less<>(), pool);
+  std::sort(expected.begin() + 100, expected.begin() + 40100);
+  EXPECT_EQ(expected, toStd(values));
+  EXPECT_EQ(std::accumulate(expected.begin(), expected.end(), 0LL),
+            lib::parallel_reduce(lib::span<int>(values), 0LL,
+                                 std::plus<>(), pool));
+
+  // Column 1 of a 10000 x 3 row-major matrix.
+  lib::vector<int> matrix(30000);
+  lib::strided_view<int> column(matrix.data() + 1, 10000, 3);
+  lib::for_each(column, [](int& x) { x = 1; });
+  lib::parallel_inclusive_scan(column, std::plus<>(), pool);
+  EXPECT_EQ(10000, column[9999]);
+  EXPECT_EQ(0, matrix[29999]);
+  EXPECT_EQ(50005000LL, lib::reduce(column, 0LL));
+  lib::transform(column, [](int x) { return -x; });
+  lib::sort(column);
+  EXPECT_EQ(-10000, matrix[1]);
+  EXPECT_EQ(-1, matrix[29998]);
+}
@@ -0,0 +1,11 @@
+#ifndef SRC_TESTS_ALLOCATION_COUNTER_H_
+#define SRC_TESTS_ALLOCATION_COUNTER_H_
+
+#include <cstddef>
+
+namespace test {
+// Number of global operator new calls made so far by any thread.
+std::size_t allocationCount();
+}  // namespace test
+
+#endif  // SRC_TESTS_ALLOCATION_COUNTER_H_
@@ -0,0 +1,188 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "../lib_containersplus.h"
+#include "allocation_counter.h"
+
+TEST(Deque, PushAndPopAtBothEnds) {
+  lib::deque<int> d;
+  EXPECT_TRUE(d.empty());
+  for (int i = 0; i < 3000; ++i) {
+    d.push_back(i);
+    d.push_front(-i - 1);
+  }
+  ASSERT_EQ(6000, d.size());
+  EXPECT_EQ(-3000, d.front());
+  EXPECT_EQ(2999, d.back());
+  for (int i = 0; i < 6000; ++i) ASSERT_EQ(i - 3000, d[i]);
+  EXPECT_THROW(d.at(6000), std::out_of_range);
+
+  for (int i = 0; i < 2000; ++i) {
+    d.pop_front();
+    d.pop_back();
+  }
+  ASSERT_EQ(2000, d.size());
+  EXPECT_EQ(-1000, d.front());
+  EXPECT_EQ(999, d.at(1999));
+  while (!d.empty()) d.pop_back();
+  d.push_front(7);
+  EXPECT_EQ(7, d.back());
+}
+
+TEST(Deque, AlternatingAcrossBlockBoundaryDoesNotAllocate) {
+  lib::deque<int> d;
+  for (int i = 0; i < 4096; ++i) d.push_back(i);
+  d.push_front(-1);
+  // The first push past the last block may still have to grow the map.
+  d.push_back(0);
+  d.pop_back();
+  std::size_t before = test::allocationCount();
+  for (int i = 0; i < 1000; ++i) {
+    d.push_back(i);
+    d.pop_back();
+    d.pop_front();
+    d.push_front(i);
+  }
+  EXPECT_EQ(test::allocationCount(), before);
+}
+
+TEST(Deque, MatchesStdDequeUnderRandomOperations) {
+  std::mt19937 gen(7);
+  lib::deque<std::string> d;
+  std::deque<std::string> expected;
+  for (int step = 0; step < 20000; ++step) {
+    std::string value = std::to_string(step);
+    switch (gen() % 5) {
+      case 0:
+      case 1:
+        d.push_back(value);
+        expected.push_back(value);
+        break;
+      case 2:
+        d.emplace_front(value);
+        expected.push_front(value);
+        break;
+      case 3:
+        if (!expected.empty()) {
+          d.pop_back();
+          expected.pop_back();
+        }
+        break;
+      case 4:
+        if (!expected.empty()) {
+          d.pop_front();
+          expected.pop_front();
+        }
+        break;
+    }
+  }
+  ASSERT_EQ(expected.size(), d.size());
+  EXPECT_TRUE(std::equal(d.begin(), d.end(), expected.begin()));
+}
+
+TEST(Deque, ReferencesSurviveGrowth) {
+  lib::deque<std::string> d;
+  d.push_back("middle");
+  std::string* middle = &d.front();
+  for (int i = 0; i < 100000; ++i) {
+    d.push_back("b");
+    d.push_front("f");
+  }
+  EXPECT_EQ(middle, &d[100000]);
+  EXPECT_EQ("middle", *middle);
+  d.shrink_to_fit();
+  EXPECT_EQ(middle, &d[100000]);
+}
+
+TEST(Deque, RandomAccessIterators) {
+  lib::deque<int> d;
+  for (int i = 0; i < 5000; ++i) d.push_front(i);
+  auto it = d.begin() + 4000;
+  EXPECT_EQ(999, *it);
+  EXPECT_EQ(4000, it - d.begin());
+  EXPECT_EQ(1999, it[-1000]);
+  EXPECT_TRUE(d.begin() < it);
+  std::sort(d.begin(), d.end());
+  EXPECT_TRUE(std::is_sorted(d.begin(), d.end()));
+
+  const lib::deque<int>& view = d;
+  lib::deque<int>::const_iterator first = d.begin();
+  EXPECT_EQ(first, view.begin());
+  EXPECT_EQ(12497500, std::accumulate(view.begin(), view.end(), 0));
+}
+
+TEST(Deque, InsertManyKeepsArgumentOrder) {
+  lib::deque<std::string> d{"c"};
+  d.insert_many_back("d", "e");
+  d.insert_many_front("a", "b");
+  ASSERT_EQ(5, d.size());
+  EXPECT_EQ("abcde", std::accumulate(d.begin(), d.end(), std::string()));
+
+  lib::deque<int> ints;
+  for (int i = 0; i < 1000; ++i) {
+    ints.insert_many_front(3 * i, 3 * i + 1, 3 * i + 2);
+  }
+  for (int i = 0; i < 1000; ++i) {
+    ASSERT_EQ(3 * (999 - i), ints[3 * i]);
+    ASSERT_EQ(3 * (999 - i) + 2, ints[3 * i + 2]);
+  }
+}
+
+TEST(Deque, CopyMoveAndSwap) {
+  lib::deque<std::string> d(3);
+  EXPECT_EQ("", d[2]);
+  for (int i = 0; i < 500; ++i) d.push_front(std::to_string(i));
+  lib::deque<std::string> copy(d);
+  EXPECT_EQ(503, copy.size());
+  EXPECT_EQ("499", copy.front());
+
+  lib::deque<std::string> moved(std::move(copy));
+  EXPECT_TRUE(copy.empty());
+  copy.push_back("again");
+  EXPECT_EQ("again", copy.front());
+
+  moved.swap(copy);
+  EXPECT_EQ(1, moved.size());
+  EXPECT_EQ(503, copy.size());
+  copy = std::move(moved);
+  EXPECT_EQ("again", copy.back());
+  copy.clear();
+  EXPECT_TRUE(copy.empty());
+  copy.push_front("x");
+  EXPECT_EQ(1, copy.size());
+}
+
+TEST(Deque, MoveOnlyElements) {
+  lib::deque<std::unique_ptr<int>> d;
+  for (int i = 0; i < 100; ++i) d.emplace_back(new int(i));
+  d.push_front(std::make_unique<int>(-1));
+  EXPECT_EQ(-1, *d.front());
+  EXPECT_EQ(99, *d.back());
+}
+
+namespace {
+struct ThrowOnSeven {
+  explicit ThrowOnSeven(int v) : value(v) {
+    if (v == 7) throw std::runtime_error("seven");
+  }
+  int value;
+};
+}  // namespace
+
+TEST(Deque, InsertManyIsAllOrNothing) {
+  lib::deque<ThrowOnSeven> d;
+  d.insert_many_back(1, 2);
+  EXPECT_THROW(d.insert_many_back(3, 7), std::runtime_error);
+  EXPECT_THROW(d.insert_many_front(4, 7), std::runtime_error);
+  ASSERT_EQ(2, d.size());
+  EXPECT_EQ(1, d.front().value);
+  EXPECT_EQ(2, d.back().value);
+}
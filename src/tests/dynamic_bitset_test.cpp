@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "../lib_containersplus.h"
+
+using lib::dynamic_bitset;
+
+TEST(DynamicBitset, SetResetTestAndCount) {
+  dynamic_bitset bits(200);
+  EXPECT_EQ(200, bits.size());
+  EXPECT_EQ(4, bits.word_count());
+  EXPECT_TRUE(bits.none());
+  bits.set(0);
+  bits.set(63);
+  bits.set(64);
+  bits.set(199);
+  bits.set(5, true);
+  bits.set(5, false);
+  bits.flip(100);
+  EXPECT_EQ(5, bits.count());
+  EXPECT_TRUE(bits[63]);
+  EXPECT_TRUE(bits.test(100));
+  EXPECT_FALSE(bits[5]);
+  bits.reset(63);
+  EXPECT_FALSE(bits.at(63));
+  EXPECT_THROW(bits.at(200), std::out_of_range);
+
+  bits.flip();
+  EXPECT_EQ(196, bits.count());
+  bits.set();
+  EXPECT_TRUE(bits.all());
+  EXPECT_EQ(200, bits.count());
+  bits.reset();
+  EXPECT_TRUE(bits.none());
+}
+
+TEST(DynamicBitset, FindFirstAndNext) {
+  dynamic_bitset bits(1000);
+  EXPECT_EQ(dynamic_bitset::npos, bits.find_first());
+  std::vector<std::size_t> expected{3, 64, 65, 511, 999};
+  for (std::size_t pos : expected) bits.set(pos);
+  std::vector<std::size_t> found;
+  for (std::size_t pos = bits.find_first(); pos != dynamic_bitset::npos;
+       pos = bits.find_next(pos)) {
+    found.push_back(pos);
+  }
+  EXPECT_EQ(expected, found);
+  EXPECT_EQ(dynamic_bitset::npos, bits.find_next(999));
+  EXPECT_EQ(dynamic_bitset::npos, bits.find_next(5000));
+}
+
+TEST(DynamicBitset, ResizeAndPushBackKeepTailClear) {
+  dynamic_bitset bits;
+  for (int i = 0; i < 130; ++i) bits.push_back(i % 3 == 0);
+  EXPECT_EQ(130, bits.size());
+  EXPECT_EQ(44, bits.count());
+
+  bits.resize(70);
+  EXPECT_EQ(24, bits.count());
+  bits.resize(300, true);
+  EXPECT_EQ(24 + 230, bits.count());
+  EXPECT_TRUE(bits[70]);
+  EXPECT_TRUE(bits[299]);
+  EXPECT_FALSE(bits[1]);
+
+  bits.resize(10);
+  bits.resize(200);
+  EXPECT_EQ(4, bits.count());
+  bits.clear();
+  EXPECT_TRUE(bits.empty());
+  bits.push_back(true);
+  EXPECT_EQ(1, bits.count());
+  EXPECT_TRUE(dynamic_bitset(65, true).all());
+  EXPECT_FALSE(dynamic_bitset(65).all());
+}
+
+TEST(DynamicBitset, WordOperationsMatchPerBitResults) {
+  std::mt19937 gen(3);
+  const std::size_t n = 1000;
+  dynamic_bitset a(n);
+  dynamic_bitset b(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    a.set(i, gen() % 2);
+    b.set(i, gen() % 3 == 0);
+  }
+  dynamic_bitset both = a & b;
+  dynamic_bitset either = a | b;
+  dynamic_bitset one = a ^ b;
+  dynamic_bitset only_a(a);
+  only_a.and_not(b);
+  for (std::size_t i = 0; i < n; ++i) {
+    ASSERT_EQ(a[i] && b[i], both[i]);
+    ASSERT_EQ(a[i] || b[i], either[i]);
+    ASSERT_EQ(a[i] != b[i], one[i]);
+    ASSERT_EQ(a[i] && !b[i], only_a[i]);
+  }
+  EXPECT_EQ(either.count(), both.count() + one.count());
+
+  dynamic_bitset self(a);
+  self ^= self;
+  EXPECT_TRUE(self.none());
+  EXPECT_THROW(a &= dynamic_bitset(n + 1), std::invalid_argument);
+}
+
+TEST(DynamicBitset, CopyMoveAndCompare) {
+  dynamic_bitset bits(100);
+  bits.set(42);
+  dynamic_bitset copy(bits);
+  EXPECT_EQ(bits, copy);
+  copy.set(43);
+  EXPECT_NE(bits, copy);
+  EXPECT_NE(bits, dynamic_bitset(101));
+
+  dynamic_bitset moved(std::move(copy));
+  EXPECT_TRUE(copy.empty());
+  EXPECT_EQ(2, moved.count());
+  copy = std::move(moved);
+  EXPECT_TRUE(copy[43]);
+  EXPECT_EQ(dynamic_bitset(), dynamic_bitset(0));
+}
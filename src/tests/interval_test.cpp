@@ -0,0 +1,131 @@
+#include <gtest/gtest.h>
+
+#include <random>
+
+#include "../lib_containersplus.h"
+
+TEST(Interval, ContainsAndOverlaps) {
+  lib::interval<int> range{2, 5};
+  EXPECT_TRUE(range.contains(2));
+  EXPECT_TRUE(range.contains(4));
+  EXPECT_FALSE(range.contains(5));
+  EXPECT_TRUE(range.overlaps(4, 10));
+  EXPECT_FALSE(range.overlaps(5, 10));
+  EXPECT_FALSE(range.overlaps(0, 2));
+}
+
+TEST(IntervalSet, InsertFindErase) {
+  lib::interval_set<int> set = {{1, 4}, {2, 3}, {1, 2}};
+  EXPECT_EQ(set.size(), 3);
+  EXPECT_EQ(*set.insert(2, 5), (lib::interval<int>{2, 5}));
+  EXPECT_EQ(set.size(), 4);
+  set.erase(set.find({2, 5}));
+  EXPECT_TRUE(set.contains({1, 2}));
+  EXPECT_FALSE(set.contains({1, 3}));
+  EXPECT_EQ(set.max_end(), 4);
+
+  auto it = set.begin();
+  EXPECT_EQ(*it, (lib::interval<int>{1, 2}));
+  ++it;
+  EXPECT_EQ(*it, (lib::interval<int>{1, 4}));
+  set.erase(it);
+  EXPECT_EQ(set.max_end(), 3);
+  EXPECT_EQ(set.size(), 2);
+}
+
+TEST(IntervalSet, OverlappingAndStabbingMatchScan) {
+  std::mt19937 gen(7);
+  std::uniform_int_distribution<int> start(0, 1000);
+  std::uniform_int_distribution<int> length(1, 60);
+  lib::interval_set<int> set;
+  for (int i = 0; i < 800; ++i) {
+    int s = start(gen);
+    set.insert(s, s + length(gen));
+  }
+  for (int i = 0; i < 200; ++i) {
+    auto victim = set.find(*set.begin());
+    for (int j = start(gen) % 50; j > 0; --j) ++victim;
+    if (victim != set.end()) set.erase(victim);
+  }
+
+  for (int q = 0; q < 200; ++q) {
+    int lo = start(gen) - 30, hi = lo + length(gen);
+    auto found = set.overlapping(lo, hi);
+    std::size_t k = 0;
+    for (auto it = set.begin(); it != set.end(); ++it) {
+      if ((*it).overlaps(lo, hi)) {
+        ASSERT_LT(k, found.size());
+        EXPECT_EQ(*found[k++], *it);
+      }
+    }
+    EXPECT_EQ(k, found.size());
+
+    auto stabbed = set.stabbing(lo);
+    k = 0;
+    for (auto it = set.begin(); it != set.end(); ++it) {
+      if ((*it).contains(lo)) {
+        ASSERT_LT(k, stabbed.size());
+        EXPECT_EQ(*stabbed[k++], *it);
+      }
+    }
+    EXPECT_EQ(k, stabbed.size());
+  }
+}
+
+TEST(IntervalMap, Reservations) {
+  lib::interval_map<int, std::string> rooms;
+  rooms.insert({9, 11}, "standup");
+  rooms.insert({10, 12}, "review");
+  rooms.insert({13, 14}, "lunch");
+  EXPECT_EQ(rooms.at({10, 12}), "review");
+  EXPECT_THROW(rooms.at({10, 13}), std::out_of_range);
+
+  auto at_ten = rooms.stabbing(10);
+  ASSERT_EQ(at_ten.size(), 2);
+  EXPECT_EQ((*at_ten[0]).second, "standup");
+  EXPECT_EQ((*at_ten[1]).second, "review");
+
+  const lib::interval_map<int, std::string>& view = rooms;
+  auto afternoon = view.overlapping(11, 20);
+  ASSERT_EQ(afternoon.size(), 2);
+  EXPECT_EQ((*afternoon[0]).second, "review");
+  EXPECT_EQ((*afternoon[1]).second, "lunch");
+  EXPECT_TRUE(view.overlapping(12, 13).empty());
+
+  rooms.erase(rooms.find({10, 12}));
+  EXPECT_EQ(rooms.stabbing(11).size(), 0);
+  EXPECT_EQ(rooms.max_end(), 14);
+}
+
+TEST(IntervalMap, KeepsEqualReservations) {
+  lib::interval_map<int, std::string> rooms;
+  rooms.insert({9, 11}, "standup");
+  auto second = rooms.insert({9, 11}, "interview");
+  rooms.insert({10, 12}, "review");
+  rooms.insert({9, 11}, "sync");
+  EXPECT_EQ(rooms.size(), 4);
+  EXPECT_EQ((*second).second, "interview");
+
+  // Equal intervals come back in insertion order.
+  auto at_ten = rooms.stabbing(10);
+  ASSERT_EQ(at_ten.size(), 4);
+  EXPECT_EQ((*at_ten[0]).second, "standup");
+  EXPECT_EQ((*at_ten[1]).second, "interview");
+  EXPECT_EQ((*at_ten[2]).second, "sync");
+  EXPECT_EQ((*at_ten[3]).second, "review");
+  EXPECT_EQ(rooms.overlapping(8, 10).size(), 3);
+
+  rooms.erase(second);
+  auto left = rooms.overlapping(9, 10);
+  ASSERT_EQ(left.size(), 2);
+  EXPECT_EQ((*left[0]).second, "standup");
+  EXPECT_EQ((*left[1]).second, "sync");
+  rooms.erase(left[0]);
+  rooms.erase(left[1]);
+  EXPECT_FALSE(rooms.contains({9, 11}));
+  EXPECT_EQ(rooms.max_end(), 12);
+
+  lib::interval_set<int> set = {{1, 3}, {1, 3}, {1, 3}};
+  EXPECT_EQ(set.size(), 3);
+  EXPECT_EQ(set.stabbing(2).size(), 3);
+}
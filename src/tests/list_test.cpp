@@ -1,5 +1,9 @@
 #include <gtest/gtest.h>
 
+#include <memory>
+#include <string>
+#include <utility>
+
 #include "../lib_containers.h"
 
 TEST(List, DefaultConstructor) {
@@ -723,3 +727,33 @@ TEST(List, BonusModifiersInsertManyFrontEmpty) {
     EXPECT_EQ(text[i], *iter);
   }
 }
+
+TEST(List, EmplaceConstructsInPlace) {
+  lib::list<std::pair<int, std::string>> A;
+  EXPECT_EQ(2, A.emplace_back(2, "two").first);
+  EXPECT_EQ(0, A.emplace_front(0, "zero").first);
+  auto iter = A.begin();
+  ++iter;
+  iter = A.emplace(iter, 1, "one");
+  EXPECT_EQ("one", (*iter).second);
+  A.emplace(A.end(), 3, "three");
+  ASSERT_EQ(4, A.size());
+  int i = 0;
+  for (iter = A.begin(); iter != A.end(); ++iter, ++i) {
+    EXPECT_EQ(i, (*iter).first);
+  }
+  EXPECT_EQ("three", A.back().second);
+}
+
+TEST(List, MoveOnlyElements) {
+  lib::list<std::unique_ptr<int>> A;
+  A.push_back(std::make_unique<int>(2));
+  A.push_front(std::make_unique<int>(0));
+  A.insert(++A.begin(), std::make_unique<int>(1));
+  A.insert_many_back(new int(3), new int(4));
+  ASSERT_EQ(5, A.size());
+  int i = 0;
+  for (auto iter = A.begin(); iter != A.end(); ++iter, ++i) {
+    EXPECT_EQ(i, **iter);
+  }
+}
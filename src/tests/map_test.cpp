@@ -1,5 +1,8 @@
 #include <gtest/gtest.h>
 
+#include <type_traits>
+#include <utility>
+
 #include "../lib_containers.h"
 
 TEST(Map, DefaultConstructor) {
@@ -186,6 +189,20 @@ TEST(Map, ModifiersMerge) {
   EXPECT_EQ(test1[6], 7);
 }
 
+TEST(Map, ModifiersMergeLeavesCollidingKeysInOther) {
+  lib::map<int, int> test1({{1, 2}, {2, 3}});
+  lib::map<int, int> test2({{2, 30}, {5, 6}, {1, 20}});
+  test1.merge(test2);
+  EXPECT_EQ(test1.size(), 3);
+  EXPECT_EQ(test1[1], 2);
+  EXPECT_EQ(test1[2], 3);
+  EXPECT_EQ(test1[5], 6);
+  EXPECT_EQ(test2.size(), 2);
+  EXPECT_EQ(test2[1], 20);
+  EXPECT_EQ(test2[2], 30);
+  EXPECT_FALSE(test2.contains(5));
+}
+
 TEST(Map, LookupContains) {
   lib::map<int, int> test({{1, 2}, {2, 3}, {3, 4}, {4, 5}});
   EXPECT_EQ(test.contains(1), true);
@@ -222,3 +239,167 @@ TEST(Map, BonusModifiersInsertManySchool21) {
     ++it_exm;
   }
 }
+
+TEST(Map, ParallelForEachUpdatesValues) {
+  lib::thread_pool pool(4);
+  lib::map<int, int> lib_map;
+  for (int i = 0; i < 5000; ++i) lib_map.insert(i, i);
+  lib_map.parallel_for_each(
+      [](std::pair<const int, int>& item) { item.second *= 2; }, pool);
+  long long sum = lib_map.parallel_reduce(
+      0LL, std::plus<long long>(),
+      [](const std::pair<const int, int>& item) { return item.second; },
+      pool);
+  EXPECT_EQ(sum, 2LL * 4999 * 5000 / 2);
+  EXPECT_EQ(lib_map.at(1234), 2468);
+}
+
+TEST(Map, AggregateSumOverRange) {
+  lib::map<int, long long, lib::sum_aggregate<long long>> lib_map;
+  for (int i = 0; i < 200; ++i) lib_map.insert((i * 37) % 200, i);
+  auto brute = [&](int lo, int hi) {
+    long long sum = 0;
+    for (auto it = lib_map.begin(); it != lib_map.end(); ++it) {
+      if ((*it).first >= lo && (*it).first < hi) sum += (*it).second;
+    }
+    return sum;
+  };
+  EXPECT_EQ(lib_map.aggregate(), brute(0, 200));
+  for (int lo = -5; lo < 205; lo += 7) {
+    for (int hi = lo; hi < 210; hi += 11) {
+      EXPECT_EQ(lib_map.aggregate(lo, hi), brute(lo, hi));
+    }
+  }
+}
+
+TEST(Map, AggregateMaintainedThroughErase) {
+  lib::map<int, int, lib::max_aggregate<int>> lib_map;
+  for (int i = 0; i < 300; ++i) lib_map.insert(i, (i * 7919) % 1000);
+  for (int i = 0; i < 300; i += 3) {
+    auto it = lib_map.begin();
+    while ((*it).first != i) ++it;
+    lib_map.erase(it);
+  }
+  lib_map.insert_or_assign(1000, 5);
+  lib_map.insert_or_assign(2, 2000);
+  EXPECT_EQ(lib_map.size(), 201);
+  for (int lo = 0; lo < 310; lo += 13) {
+    for (int hi = lo + 1; hi < 1010; hi += 29) {
+      int expected = std::numeric_limits<int>::lowest();
+      for (auto it = lib_map.begin(); it != lib_map.end(); ++it) {
+        if ((*it).first >= lo && (*it).first < hi)
+          expected = std::max(expected, (*it).second);
+      }
+      EXPECT_EQ(lib_map.aggregate(lo, hi), expected);
+    }
+  }
+}
+
+TEST(Map, AggregateRefreshedByEveryWrite) {
+  using SumMap = lib::map<int, long long, lib::sum_aggregate<long long>>;
+  SumMap lib_map;
+  for (int i = 0; i < 100; ++i) lib_map.insert(i * 2, i);
+  // Mapped values only change through insert_or_assign.
+  static_assert(std::is_same_v<decltype(lib_map.at(0)), const long long&>);
+  static_assert(std::is_same_v<decltype(lib_map[0]), const long long&>);
+  lib_map.parallel_for_each([](auto& entry) {
+    static_assert(std::is_const_v<std::remove_reference_t<decltype(entry)>>);
+  });
+
+  lib_map.insert_or_assign(40, 1000);
+  EXPECT_EQ(0, lib_map[41]);
+  lib_map.insert_or_assign(41, -7);
+  lib_map.insert_or_assign(0, 5);
+  EXPECT_EQ(1000, lib_map.at(40));
+  auto brute = [&](int lo, int hi) {
+    long long sum = 0;
+    for (auto it = lib_map.begin(); it != lib_map.end(); ++it) {
+      if ((*it).first >= lo && (*it).first < hi) sum += (*it).second;
+    }
+    return sum;
+  };
+  EXPECT_EQ(lib_map.aggregate(), brute(0, 200));
+  for (int lo = -1; lo < 201; lo += 3) {
+    for (int hi = lo; hi < 202; hi += 5) {
+      ASSERT_EQ(lib_map.aggregate(lo, hi), brute(lo, hi));
+    }
+  }
+
+  lib::map<int, int> plain = {{1, 1}};
+  plain.at(1) = 2;
+  plain[2] = 3;
+  plain.parallel_for_each([](auto& entry) { ++entry.second; });
+  EXPECT_EQ(3, plain.at(1));
+  EXPECT_EQ(4, plain.at(2));
+}
+
+TEST(Map, AggregatedMapIteratorsAreReadOnly) {
+  using SumMap = lib::map<int, long long, lib::sum_aggregate<long long>>;
+  static_assert(std::is_same_v<SumMap::iterator, SumMap::const_iterator>);
+  static_assert(std::is_same_v<decltype(*std::declval<SumMap::iterator&>()),
+                               const std::pair<const int, long long>&>);
+  using PlainMap = lib::map<int, long long>;
+  static_assert(std::is_same_v<decltype(*std::declval<PlainMap::iterator&>()),
+                               std::pair<const int, long long>&>);
+
+  SumMap lib_map;
+  for (int i = 0; i < 50; ++i) lib_map.insert(i, i);
+  SumMap::iterator inserted = lib_map.insert(100, 1000).first;
+  EXPECT_EQ(1000, (*inserted).second);
+  auto many = lib_map.insert_many(std::make_pair(200, 7LL),
+                                  std::make_pair(100, 1LL));
+  EXPECT_TRUE(many[0].second);
+  EXPECT_FALSE(many[1].second);
+  EXPECT_EQ(1000, (*many[1].first).second);
+  EXPECT_EQ(1225 + 1000 + 7, lib_map.aggregate());
+
+  SumMap::iterator it = lib_map.begin();
+  ++it;
+  lib_map.erase(it);
+  lib_map.erase(inserted);
+  EXPECT_EQ(1225 - 1 + 7, lib_map.aggregate());
+  EXPECT_EQ(1225 - 1, lib_map.aggregate(0, 50));
+}
+
+struct ConcatAggregate {
+  using value_type = std::string;
+  static std::string identity() { return ""; }
+  static std::string combine(const std::string& a, const std::string& b) {
+    return a + b;
+  }
+};
+
+TEST(Map, AggregateKeepsKeyOrder) {
+  lib::map<int, std::string, ConcatAggregate> lib_map;
+  for (int i = 25; i >= 0; --i) {
+    lib_map.insert(i, std::string(1, static_cast<char>('a' + i)));
+  }
+  EXPECT_EQ(lib_map.aggregate(), "abcdefghijklmnopqrstuvwxyz");
+  EXPECT_EQ(lib_map.aggregate(3, 8), "defgh");
+  EXPECT_EQ(lib_map.aggregate(8, 3), "");
+  lib::map<int, std::string, ConcatAggregate> copy(lib_map);
+  lib::map<int, std::string, ConcatAggregate> other = {{100, "!"}};
+  copy.merge(other);
+  EXPECT_EQ(copy.aggregate(20, 1000), "uvwxyz!");
+  EXPECT_EQ(lib_map.aggregate(20, 1000), "uvwxyz");
+}
+
+TEST(Map, CopyIsIndependent) {
+  lib::map<int, int> original = {{1, 1}, {2, 2}, {3, 3}};
+  lib::map<int, int> copy(original);
+  original.clear();
+  int expected = 1;
+  for (auto it = copy.begin(); it != copy.end(); ++it, ++expected) {
+    EXPECT_EQ((*it).first, expected);
+  }
+  EXPECT_EQ(expected, 4);
+}
+
+TEST(Map, StatsWithAggregate) {
+  lib::map<int, int, lib::sum_aggregate<int>, lib::tree_stats> lib_map;
+  for (int i = 0; i < 100; ++i) lib_map.insert(i, 1);
+  EXPECT_EQ(lib_map.aggregate(10, 20), 10);
+  EXPECT_EQ(lib_map.stats().allocations, 100);
+  EXPECT_GT(lib_map.stats().rotations, 0);
+  EXPECT_EQ(lib_map.depth_histogram()[0], 1);
+}
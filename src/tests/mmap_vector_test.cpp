@@ -0,0 +1,141 @@
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include "../lib_mmap_vector.h"
+
+namespace {
+struct Record {
+  std::int64_t id;
+  double value;
+};
+
+// A path in the test temp directory, removed when the test ends.
+class TempFile {
+ public:
+  explicit TempFile(const std::string& name)
+      : path_(::testing::TempDir() + name + "." + std::to_string(::getpid())) {
+    std::remove(path_.c_str());
+  }
+  ~TempFile() { std::remove(path_.c_str()); }
+  const std::string& path() const { return path_; }
+
+ private:
+  std::string path_;
+};
+
+using RecordFile = lib::mmap_vector<Record>;
+using WordFile = lib::mmap_vector<std::uint32_t>;
+}  // namespace
+
+TEST(MmapVector, WritesAndReopensReadOnly) {
+  TempFile file("records");
+  {
+    RecordFile records(file.path(), RecordFile::open_mode::truncate);
+    EXPECT_TRUE(records.empty());
+    for (int i = 0; i < 10000; ++i) records.push_back({i, i * 0.5});
+    EXPECT_EQ(10000, records.size());
+    EXPECT_GE(records.capacity(), 10000);
+    records.flush();
+  }
+
+  const RecordFile records(file.path(), RecordFile::open_mode::read_only);
+  EXPECT_TRUE(records.read_only());
+  ASSERT_EQ(10000, records.size());
+  EXPECT_EQ(10000, records.capacity());
+  for (int i = 0; i < 10000; ++i) {
+    ASSERT_EQ(i, records[i].id);
+    ASSERT_EQ(i * 0.5, records[i].value);
+  }
+  EXPECT_THROW(records.at(10000), std::out_of_range);
+}
+
+TEST(MmapVector, ReadOnlyRejectsChanges) {
+  TempFile file("read_only");
+  { RecordFile(file.path()).push_back({1, 1.0}); }
+  RecordFile records(file.path(), RecordFile::open_mode::read_only);
+  EXPECT_THROW(records.push_back({2, 2.0}), std::logic_error);
+  EXPECT_THROW(records.resize(5), std::logic_error);
+  EXPECT_THROW(records.reserve(100), std::logic_error);
+  EXPECT_THROW(records.pop_back(), std::logic_error);
+  EXPECT_THROW(records.clear(), std::logic_error);
+  EXPECT_EQ(1, records.size());
+}
+
+TEST(MmapVector, AppendsToExistingFile) {
+  TempFile file("append");
+  {
+    WordFile values(file.path());
+    for (std::uint32_t i = 0; i < 100; ++i) values.push_back(i);
+  }
+  {
+    WordFile values(file.path());
+    ASSERT_EQ(100, values.size());
+    // Appending a range of the vector itself survives the remap.
+    values.append(values.data(), 100);
+    values.append(values.data(), 200);
+    ASSERT_EQ(400, values.size());
+    for (std::uint32_t i = 0; i < 400; ++i) ASSERT_EQ(i % 100, values[i]);
+  }
+  WordFile values(file.path(), WordFile::open_mode::read_only);
+  EXPECT_EQ(400, values.size());
+}
+
+TEST(MmapVector, ResizeZeroFillsAndShrinks) {
+  TempFile file("resize");
+  lib::mmap_vector<int> values(file.path());
+  values.resize(10);
+  for (int i = 0; i < 10; ++i) values[i] = i + 1;
+  values.resize(3);
+  values.resize(6);
+  EXPECT_EQ(3, values[2]);
+  EXPECT_EQ(0, values[3]);
+  EXPECT_EQ(0, values[5]);
+
+  values.shrink_to_fit();
+  EXPECT_EQ(6, values.capacity());
+  values.pop_back();
+  values.clear();
+  EXPECT_TRUE(values.empty());
+  values.shrink_to_fit();
+  EXPECT_EQ(0, values.capacity());
+  EXPECT_EQ(nullptr, values.data());
+  values.push_back(7);
+  EXPECT_EQ(7, values.back());
+}
+
+TEST(MmapVector, MoveAndClose) {
+  TempFile file("move");
+  lib::mmap_vector<int> values(file.path());
+  values.push_back(5);
+  lib::mmap_vector<int> moved(std::move(values));
+  EXPECT_FALSE(values.is_open());
+  EXPECT_TRUE(values.empty());
+  EXPECT_THROW(values.push_back(1), std::logic_error);
+  ASSERT_TRUE(moved.is_open());
+  moved.advise(lib::mmap_vector<int>::advice::sequential);
+  moved.advise(lib::mmap_vector<int>::advice::willneed);
+  moved.close();
+  EXPECT_FALSE(moved.is_open());
+
+  values = lib::mmap_vector<int>(file.path());
+  ASSERT_EQ(1, values.size());
+  EXPECT_EQ(5, values.front());
+}
+
+TEST(MmapVector, OpenErrors) {
+  TempFile file("errors");
+  EXPECT_THROW(RecordFile(file.path(), RecordFile::open_mode::read_only),
+               std::system_error);
+  std::FILE* out = std::fopen(file.path().c_str(), "wb");
+  ASSERT_NE(nullptr, out);
+  std::fputs("12345", out);
+  std::fclose(out);
+  EXPECT_THROW(RecordFile(file.path()), std::runtime_error);
+}
@@ -293,3 +293,25 @@ TEST(Multiset, BonusModifiersInsertMany5) {
     EXPECT_EQ(*lib_it, *exm_it);
   }
 }
+
+TEST(Multiset, ParallelReduceCountsDuplicates) {
+  lib::thread_pool pool(3);
+  lib::multiset<int> lib_multiset;
+  for (int i = 0; i < 12000; ++i) lib_multiset.insert(i % 100);
+  long long sum = lib_multiset.parallel_reduce(0LL, std::plus<long long>(),
+                                               pool);
+  EXPECT_EQ(sum, 120LL * 4950);
+  std::atomic<int> visited{0};
+  lib_multiset.parallel_for_each([&](const int&) { ++visited; }, pool);
+  EXPECT_EQ(visited.load(), 12000);
+}
+
+TEST(Multiset, StatsCountEraseFixups) {
+  lib::multiset<int, lib::tree_stats> lib_multiset;
+  for (int i = 0; i < 500; ++i) lib_multiset.insert(i % 50);
+  while (!lib_multiset.empty()) lib_multiset.erase(lib_multiset.begin());
+  EXPECT_EQ(lib_multiset.stats().allocations, 500);
+  EXPECT_EQ(lib_multiset.stats().deallocations, 500);
+  EXPECT_GT(lib_multiset.stats().erase_fixup_iterations, 0);
+  EXPECT_EQ(lib_multiset.height(), 0);
+}
@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "../lib_containersplus.h"
+
+using lib::packed_int_vector;
+
+namespace {
+std::vector<std::uint64_t> decoded(const packed_int_vector& packed) {
+  std::vector<std::uint64_t> out(packed.size());
+  packed.copy_to(out.data());
+  return out;
+}
+
+// Checks every way of reading the values back against the originals.
+void expectValues(const std::vector<std::uint64_t>& expected,
+                  const packed_int_vector& packed) {
+  ASSERT_EQ(expected.size(), packed.size());
+  for (std::size_t i = 0; i < expected.size(); ++i) {
+    ASSERT_EQ(expected[i], packed[i]) << "at " << i;
+  }
+  EXPECT_EQ(expected, decoded(packed));
+  std::vector<std::uint64_t> visited;
+  packed.for_each([&](std::uint64_t value) { visited.push_back(value); });
+  EXPECT_EQ(expected, visited);
+}
+}  // namespace
+
+TEST(PackedIntVector, RoundTripsEveryBitWidth) {
+  std::mt19937_64 gen(7);
+  std::vector<std::uint64_t> values;
+  packed_int_vector packed;
+  // One block per width from 0 to 64 bits, each on a different base.
+  for (unsigned width = 0; width <= 64; ++width) {
+    std::uint64_t base = gen() >> 1;
+    std::uint64_t mask = width == 64 ? ~std::uint64_t(0)
+                                     : (std::uint64_t(1) << width) - 1;
+    if (width == 64) base = 0;
+    for (std::size_t i = 0; i < packed_int_vector::kBlockSize; ++i) {
+      values.push_back(base + (gen() & mask));
+    }
+  }
+  values.push_back(5);
+  values.push_back(std::numeric_limits<std::uint64_t>::max());
+  packed.append(values.data(), values.size());
+  expectValues(values, packed);
+  EXPECT_EQ(5, packed[packed.size() - 2]);
+  EXPECT_EQ(std::numeric_limits<std::uint64_t>::max(), packed.back());
+  EXPECT_THROW(packed.at(values.size()), std::out_of_range);
+}
+
+TEST(PackedIntVector, SmallRangesShrinkMemory) {
+  const std::size_t n = 1 << 16;
+  packed_int_vector ids;
+  std::vector<std::uint64_t> values;
+  std::mt19937_64 gen(1);
+  for (std::size_t i = 0; i < n; ++i) {
+    values.push_back((std::uint64_t(1) << 40) + gen() % 1000);
+    ids.push_back(values.back());
+  }
+  ids.shrink_to_fit();
+  expectValues(values, ids);
+  // 10 bits per value plus one header per block instead of 64 bits.
+  EXPECT_LT(ids.memory_usage() * 5, n * sizeof(std::uint64_t));
+}
+
+TEST(PackedIntVector, DeltaEncodingPacksSortedGaps) {
+  const std::size_t n = 1 << 14;
+  std::vector<std::uint64_t> sorted;
+  std::uint64_t id = 1'000'000'000;
+  std::mt19937_64 gen(2);
+  for (std::size_t i = 0; i < n; ++i) {
+    id += gen() % 16;
+    sorted.push_back(id);
+  }
+  packed_int_vector plain;
+  packed_int_vector delta(packed_int_vector::encoding::delta);
+  plain.append(sorted.data(), n);
+  delta.append(sorted.data(), n);
+  plain.shrink_to_fit();
+  delta.shrink_to_fit();
+  expectValues(sorted, delta);
+  EXPECT_EQ(packed_int_vector::encoding::delta, delta.mode());
+  // Gaps need 4 bits, spans of a block about 11.
+  EXPECT_LT(delta.memory_usage() * 2, plain.memory_usage());
+
+  // Unsorted blocks fall back to frame-of-reference.
+  std::vector<std::uint64_t> mixed(sorted.rbegin(), sorted.rend());
+  packed_int_vector reversed({}, packed_int_vector::encoding::delta);
+  reversed.append(mixed.data(), mixed.size());
+  expectValues(mixed, reversed);
+}
+
+TEST(PackedIntVector, DeltaLookupsAtEveryGapWidth) {
+  std::mt19937_64 gen(3);
+  std::vector<std::uint64_t> sorted;
+  std::uint64_t id = 12345;
+  // One block per gap width; a block's span stays below 2^63.
+  for (unsigned width = 1; width <= 55; ++width) {
+    std::uint64_t mask = (std::uint64_t(1) << width) - 1;
+    for (std::size_t i = 0; i < packed_int_vector::kBlockSize; ++i) {
+      id += gen() & mask;
+      sorted.push_back(id);
+    }
+    id = gen() >> 8;
+  }
+  packed_int_vector plain;
+  packed_int_vector delta(packed_int_vector::encoding::delta);
+  plain.append(sorted.data(), sorted.size());
+  delta.append(sorted.data(), sorted.size());
+  plain.shrink_to_fit();
+  delta.shrink_to_fit();
+  expectValues(sorted, delta);
+  EXPECT_LT(delta.memory_usage(), plain.memory_usage());
+}
+
+TEST(PackedIntVector, CopyMoveAndClear) {
+  packed_int_vector packed{1, 2, 3};
+  std::vector<std::uint64_t> values{1, 2, 3};
+  for (std::uint64_t i = 0; i < 300; ++i) {
+    packed.push_back(i * i);
+    values.push_back(i * i);
+  }
+  packed_int_vector copy(packed);
+  expectValues(values, copy);
+  packed_int_vector moved(std::move(copy));
+  EXPECT_TRUE(copy.empty());
+  EXPECT_EQ(0, copy.memory_usage());
+  expectValues(values, moved);
+  copy = std::move(moved);
+  EXPECT_EQ(values.back(), copy.back());
+  EXPECT_EQ(1, copy.front());
+
+  copy.clear();
+  EXPECT_TRUE(copy.empty());
+  copy.push_back(42);
+  expectValues({42}, copy);
+  copy.clear();
+  copy.shrink_to_fit();
+  EXPECT_EQ(0, copy.memory_usage());
+  expectValues({}, copy);
+}
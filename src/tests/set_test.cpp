@@ -230,3 +230,77 @@ TEST(Set, BonusModifiersInsertMany5) {
     EXPECT_EQ(*lib_it, *exm_it);
   }
 }
+
+TEST(Set, ParallelForEachVisitsEveryElement) {
+  lib::thread_pool pool(4);
+  lib::set<int> lib_set;
+  for (int i = 0; i < 20000; ++i) lib_set.insert((i * 7919) % 20000);
+  std::atomic<long long> sum{0};
+  std::atomic<int> visited{0};
+  lib_set.parallel_for_each(
+      [&](const int& value) {
+        sum += value;
+        ++visited;
+      },
+      pool);
+  EXPECT_EQ(visited.load(), 20000);
+  EXPECT_EQ(sum.load(), 19999LL * 20000 / 2);
+}
+
+TEST(Set, ParallelReduceKeepsOrder) {
+  lib::thread_pool pool(4);
+  lib::set<int> lib_set;
+  for (int i = 9999; i >= 0; --i) lib_set.insert(i);
+  std::string expected;
+  for (auto it = lib_set.begin(); it != lib_set.end(); ++it) {
+    expected += std::to_string(*it) + ",";
+  }
+  std::string result = lib_set.parallel_reduce(
+      std::string(), [](std::string a, const std::string& b) { return a + b; },
+      [](const int& value) { return std::to_string(value) + ","; }, pool);
+  EXPECT_EQ(result, expected);
+}
+
+TEST(Set, ParallelReduceSmallAndEmpty) {
+  lib::thread_pool pool(4);
+  lib::set<int> empty_set;
+  EXPECT_EQ(empty_set.parallel_reduce(7, std::plus<int>(), pool), 7);
+  lib::set<int> lib_set = {1, 2, 3, 4};
+  EXPECT_EQ(lib_set.parallel_reduce(10, std::plus<int>(), pool), 20);
+  EXPECT_EQ(lib_set.parallel_reduce(0, std::plus<int>()), 10);
+}
+
+TEST(Set, StatsCountTreeWork) {
+  lib::set<int, lib::tree_stats> lib_set;
+  for (int i = 0; i < 1000; ++i) lib_set.insert(i);
+  const lib::tree_stats& stats = lib_set.stats();
+  EXPECT_EQ(stats.allocations, 1000);
+  EXPECT_GT(stats.comparisons, 1000);
+  EXPECT_GT(stats.rotations, 0);
+  EXPECT_GT(stats.insert_fixup_iterations, 0);
+  EXPECT_EQ(stats.erase_fixup_iterations, 0);
+
+  EXPECT_FALSE(lib_set.insert(500).second);
+  EXPECT_EQ(stats.allocations, 1001);
+  EXPECT_EQ(stats.deallocations, 1);
+
+  lib_set.reset_stats();
+  EXPECT_TRUE(lib_set.contains(999));
+  EXPECT_GT(stats.comparisons, 0);
+  EXPECT_EQ(stats.allocations, 0);
+}
+
+TEST(Set, HeightAndDepthHistogram) {
+  lib::set<int> lib_set;
+  EXPECT_EQ(lib_set.height(), 0);
+  EXPECT_EQ(lib_set.depth_histogram().size(), 0);
+  for (int i = 0; i < 1023; ++i) lib_set.insert(i);
+  EXPECT_GE(lib_set.height(), 10);
+  EXPECT_LE(lib_set.height(), 20);
+  auto histogram = lib_set.depth_histogram();
+  EXPECT_EQ(histogram.size(), lib_set.height());
+  EXPECT_EQ(histogram[0], 1);
+  std::size_t total = 0;
+  for (std::size_t i = 0; i < histogram.size(); ++i) total += histogram[i];
+  EXPECT_EQ(total, 1023);
+}
@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+
+#include "../lib_containersplus.h"
+
+namespace {
+// Values in [-20, 20) with repeats, so every kernel sees hits and misses.
+template <typename T>
+lib::vector<T> pattern(std::size_t n) {
+  lib::vector<T> values;
+  for (std::size_t i = 0; i < n; ++i) {
+    values.push_back(static_cast<T>(int(i * 7 % 40) - 20));
+  }
+  return values;
+}
+
+template <typename T>
+class SimdKernels : public ::testing::Test {};
+
+using ArithmeticTypes = ::testing::Types<float, double, std::int32_t,
+                                         std::int64_t, std::int16_t>;
+TYPED_TEST_SUITE(SimdKernels, ArithmeticTypes);
+}  // namespace
+
+TYPED_TEST(SimdKernels, FindAndCountMatchScalarLoops) {
+  using T = TypeParam;
+  for (std::size_t n = 0; n <= 100; ++n) {
+    lib::vector<T> values = pattern<T>(n);
+    for (int needle : {-20, -6, 0, 13, 19, 50}) {
+      std::size_t first = n;
+      std::size_t matches = 0;
+      for (std::size_t i = 0; i < n; ++i) {
+        if (values[i] == T(needle)) {
+          if (first == n) first = i;
+          ++matches;
+        }
+      }
+      EXPECT_EQ(first, lib::simd::find(values, T(needle))) << n;
+      EXPECT_EQ(matches, lib::simd::count(values, T(needle))) << n;
+    }
+  }
+}
+
+TYPED_TEST(SimdKernels, SumAndDotMatchScalarLoops) {
+  using T = TypeParam;
+  for (std::size_t n = 0; n <= 100; ++n) {
+    lib::vector<T> a = pattern<T>(n);
+    lib::vector<T> b = pattern<T>(n);
+    lib::simd::clamp(b, T(-3), T(3));
+    T sum = T();
+    T dot = T();
+    for (std::size_t i = 0; i < n; ++i) {
+      sum += a[i];
+      dot += a[i] * b[i];
+    }
+    // Small integers keep float sums exact whatever the order.
+    EXPECT_EQ(sum, lib::simd::sum(a)) << n;
+    EXPECT_EQ(dot, lib::simd::dot(a, b)) << n;
+  }
+}
+
+TYPED_TEST(SimdKernels, MinAndMaxReportFirstPosition) {
+  using T = TypeParam;
+  for (std::size_t n = 1; n <= 100; ++n) {
+    lib::vector<T> values = pattern<T>(n);
+    std::size_t lowest = 0;
+    std::size_t highest = 0;
+    for (std::size_t i = 1; i < n; ++i) {
+      if (values[i] < values[lowest]) lowest = i;
+      if (values[highest] < values[i]) highest = i;
+    }
+    lib::simd::indexed_value<T> min = lib::simd::min_with_index(values);
+    lib::simd::indexed_value<T> max = lib::simd::max_with_index(values);
+    EXPECT_EQ(values[lowest], min.value) << n;
+    EXPECT_EQ(lowest, min.index) << n;
+    EXPECT_EQ(values[highest], max.value) << n;
+    EXPECT_EQ(highest, max.index) << n;
+  }
+}
+
+TYPED_TEST(SimdKernels, ClampMatchesScalarLoop) {
+  using T = TypeParam;
+  for (std::size_t n = 0; n <= 100; ++n) {
+    lib::vector<T> values = pattern<T>(n);
+    lib::vector<T> expected = values;
+    for (std::size_t i = 0; i < n; ++i) {
+      if (expected[i] < T(-5)) expected[i] = T(-5);
+      if (T(7) < expected[i]) expected[i] = T(7);
+    }
+    lib::simd::clamp(values, T(-5), T(7));
+    for (std::size_t i = 0; i < n; ++i) EXPECT_EQ(expected[i], values[i]);
+  }
+}
+
+TYPED_TEST(SimdKernels, MasksMatchScalarComparisons) {
+  using T = TypeParam;
+  for (std::size_t n = 0; n <= 200; n += 3) {
+    lib::vector<T> values = pattern<T>(n);
+    lib::vector<std::uint64_t> equal = lib::simd::equal_mask(values, T(1));
+    lib::vector<std::uint64_t> less = lib::simd::less_mask(values, T(1));
+    lib::vector<std::uint64_t> greater = lib::simd::greater_mask(values, T(1));
+    ASSERT_EQ((n + 63) / 64, equal.size());
+    ASSERT_EQ(equal.size(), less.size());
+    ASSERT_EQ(equal.size(), greater.size());
+    for (std::size_t i = 0; i < equal.size() * 64; ++i) {
+      bool in_range = i < n;
+      auto bit = [i](lib::vector<std::uint64_t>& mask) {
+        return (mask[i / 64] >> (i % 64) & 1) != 0;
+      };
+      EXPECT_EQ(in_range && values[i] == T(1), bit(equal)) << i;
+      EXPECT_EQ(in_range && values[i] < T(1), bit(less)) << i;
+      EXPECT_EQ(in_range && T(1) < values[i], bit(greater)) << i;
+    }
+  }
+}
+
+TEST(Simd, WorksOnArrays) {
+  lib::array<std::int32_t, 11> values({4, -2, 9, 9, 0, -7, 3, 9, 1, -7, 5});
+  EXPECT_EQ(2, lib::simd::find(values, 9));
+  EXPECT_EQ(3, lib::simd::count(values, 9));
+  EXPECT_EQ(24, lib::simd::sum(values));
+  EXPECT_EQ(5, lib::simd::min_with_index(values).index);
+  EXPECT_EQ(2, lib::simd::max_with_index(values).index);
+  const lib::array<std::int32_t, 11>& view = values;
+  EXPECT_EQ(6, lib::simd::find(view, 3));
+}
+
+TEST(Simd, LanesFollowTheEnabledInstructionSet) {
+#if defined(LIB_SIMD_AVX2)
+  EXPECT_EQ(8, lib::simd::lanes<float>());
+  EXPECT_EQ(4, lib::simd::lanes<std::int64_t>());
+#elif defined(LIB_SIMD_SSE2)
+  EXPECT_EQ(4, lib::simd::lanes<float>());
+  EXPECT_EQ(1, lib::simd::lanes<std::int64_t>());
+#else
+  EXPECT_EQ(1, lib::simd::lanes<float>());
+#endif
+  EXPECT_EQ(1, lib::simd::lanes<std::int16_t>());
+}
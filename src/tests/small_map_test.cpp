@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "../lib_containersplus.h"
+#include "allocation_counter.h"
+
+TEST(SmallSet, SmallSetNeverAllocates) {
+  std::size_t before = test::allocationCount();
+  {
+    lib::small_set<int, 8> small;
+    for (int i = 8; i > 0; --i) small.insert(i);
+    EXPECT_TRUE(small.contains(3));
+    EXPECT_FALSE(small.insert(5).second);
+    small.erase(small.find(4));
+    EXPECT_EQ(small.size(), 7);
+  }
+  EXPECT_EQ(test::allocationCount(), before);
+}
+
+TEST(SmallSet, KeepsOrderAcrossSpill) {
+  lib::small_set<int, 4> small = {5, 1, 4};
+  EXPECT_TRUE(small.is_inline());
+  int expected[] = {1, 4, 5};
+  int i = 0;
+  for (auto it = small.begin(); it != small.end(); ++it) {
+    EXPECT_EQ(*it, expected[i++]);
+  }
+  small.insert_many(3, 2, 6, 3);
+  EXPECT_FALSE(small.is_inline());
+  EXPECT_EQ(small.size(), 6);
+  i = 1;
+  for (auto it = small.begin(); it != small.end(); ++it, ++i) {
+    EXPECT_EQ(*it, i);
+  }
+  EXPECT_EQ(*small.find(6), 6);
+  EXPECT_EQ(small.find(7), small.end());
+  small.clear();
+  EXPECT_TRUE(small.is_inline());
+  EXPECT_TRUE(small.empty());
+}
+
+TEST(SmallSet, CopyMoveSwapMerge) {
+  lib::small_set<std::string, 2> inline_set = {"b", "a"};
+  lib::small_set<std::string, 2> tree_set = {"c", "d", "e"};
+  lib::small_set<std::string, 2> copy(tree_set);
+  EXPECT_EQ(copy.size(), 3);
+  lib::small_set<std::string, 2> moved(std::move(inline_set));
+  EXPECT_EQ(moved.size(), 2);
+  EXPECT_TRUE(inline_set.empty());
+  moved.swap(copy);
+  EXPECT_EQ(moved.size(), 3);
+  EXPECT_EQ(copy.size(), 2);
+  lib::small_set<std::string, 2> other = {"a", "z"};
+  copy.merge(other);
+  EXPECT_EQ(copy.size(), 3);
+  EXPECT_EQ(other.size(), 1);
+  EXPECT_TRUE(other.contains("a"));
+  const lib::small_set<std::string, 2>& view = copy;
+  EXPECT_EQ(*view.find("z"), "z");
+}
+
+TEST(SmallMap, SmallMapNeverAllocates) {
+  std::size_t before = test::allocationCount();
+  {
+    lib::small_map<int, double, 8> headers;
+    for (int i = 0; i < 8; ++i) headers[i] = i * 0.5;
+    headers.insert_or_assign(3, 10.0);
+    EXPECT_DOUBLE_EQ(headers.at(3), 10.0);
+    EXPECT_DOUBLE_EQ(headers.at(7), 3.5);
+    EXPECT_TRUE(headers.is_inline());
+  }
+  EXPECT_EQ(test::allocationCount(), before);
+  lib::small_map<int, double, 8> headers = {{1, 1.0}};
+  EXPECT_THROW(headers.at(9), std::out_of_range);
+}
+
+TEST(SmallMap, BehavesLikeMapAfterSpill) {
+  lib::small_map<int, std::string, 3> small = {{3, "c"}, {1, "a"}};
+  EXPECT_TRUE(small.insert(2, "b").second);
+  EXPECT_FALSE(small.insert(2, "x").second);
+  EXPECT_TRUE(small.is_inline());
+  small[5] = "e";
+  small.insert_many(std::make_pair(4, "d"));
+  EXPECT_FALSE(small.is_inline());
+  EXPECT_EQ(small.size(), 5);
+  std::string joined;
+  for (auto it = small.begin(); it != small.end(); ++it) {
+    joined += (*it).second;
+  }
+  EXPECT_EQ(joined, "abcde");
+  small.insert_or_assign(1, "A");
+  EXPECT_EQ(small.at(1), "A");
+  small.erase(small.begin());
+  EXPECT_FALSE(small.contains(1));
+  const lib::small_map<int, std::string, 3>& view = small;
+  EXPECT_EQ(view.at(5), "e");
+}
@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "../lib_containersplus.h"
+#include "allocation_counter.h"
+
+TEST(SmallVector, StaysInlineUpToCapacity) {
+  std::size_t before = test::allocationCount();
+  {
+    lib::small_vector<int, 8> small;
+    EXPECT_EQ(8, small.capacity());
+    for (int i = 0; i < 7; ++i) small.push_back(i);
+    small.insert_many(small.begin() + 2, 100);
+    small.erase(small.begin());
+    small.insert_many_back(200);
+    small.erase_if([](int v) { return v == 3; });
+    EXPECT_TRUE(small.is_inline());
+    EXPECT_EQ(7, small.size());
+    EXPECT_EQ(8, small.capacity());
+  }
+  EXPECT_EQ(test::allocationCount(), before);
+}
+
+TEST(SmallVector, SpillsToHeapAndBack) {
+  lib::small_vector<std::string, 4> small = {"a", "b", "c"};
+  EXPECT_TRUE(small.is_inline());
+  small.insert_many_back("d", "e");
+  EXPECT_FALSE(small.is_inline());
+  EXPECT_EQ(8, small.capacity());
+  const char* expected[] = {"a", "b", "c", "d", "e"};
+  for (int i = 0; i < 5; ++i) EXPECT_EQ(expected[i], small[i]);
+
+  small.erase(small.begin() + 1, small.begin() + 3);
+  small.shrink_to_fit();
+  EXPECT_TRUE(small.is_inline());
+  EXPECT_EQ(4, small.capacity());
+  ASSERT_EQ(3, small.size());
+  EXPECT_EQ("a", small[0]);
+  EXPECT_EQ("d", small[1]);
+  EXPECT_EQ("e", small[2]);
+}
+
+TEST(SmallVector, CopyAndMove) {
+  lib::small_vector<std::string, 2> inline_vec = {"x"};
+  lib::small_vector<std::string, 2> heap_vec = {"p", "q", "r"};
+  EXPECT_FALSE(heap_vec.is_inline());
+
+  lib::small_vector<std::string, 2> copy(inline_vec);
+  EXPECT_TRUE(copy.is_inline());
+  EXPECT_EQ("x", copy[0]);
+
+  lib::small_vector<std::string, 2> moved(std::move(inline_vec));
+  EXPECT_TRUE(moved.is_inline());
+  EXPECT_EQ("x", moved[0]);
+  EXPECT_TRUE(inline_vec.empty());
+
+  const std::string* heap_data = heap_vec.data();
+  moved = std::move(heap_vec);
+  EXPECT_EQ(heap_data, moved.data());
+  EXPECT_EQ(3, moved.size());
+  EXPECT_TRUE(heap_vec.empty());
+  EXPECT_TRUE(heap_vec.is_inline());
+  EXPECT_EQ(2, heap_vec.capacity());
+
+  copy.swap(moved);
+  EXPECT_EQ(3, copy.size());
+  EXPECT_EQ("r", copy[2]);
+  ASSERT_EQ(1, moved.size());
+  EXPECT_EQ("x", moved[0]);
+}
+
+TEST(SmallVector, MoveOnlyElements) {
+  lib::small_vector<std::unique_ptr<int>, 2> small;
+  for (int i = 0; i < 5; ++i) small.emplace_back(new int(i));
+  small.emplace(small.begin(), new int(-1));
+  ASSERT_EQ(6, small.size());
+  for (int i = 0; i < 6; ++i) EXPECT_EQ(i - 1, *small[i]);
+  lib::small_vector<std::unique_ptr<int>, 2> other(std::move(small));
+  EXPECT_EQ(6, other.size());
+  EXPECT_TRUE(small.empty());
+}
+
+TEST(SmallVector, OverAlignedElements) {
+  struct alignas(32) Lane {
+    float values[8];
+  };
+  lib::small_vector<Lane, 4> small;
+  auto aligned = [&small] {
+    return reinterpret_cast<std::uintptr_t>(small.data()) % alignof(Lane) == 0;
+  };
+  EXPECT_TRUE(aligned());
+  for (int i = 0; i < 10; ++i) small.push_back(Lane{{float(i)}});
+  EXPECT_FALSE(small.is_inline());
+  EXPECT_TRUE(aligned());
+  EXPECT_EQ(9.0f, small[9].values[0]);
+}
@@ -0,0 +1,138 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
+
+#include "../lib_containersplus.h"
+
+namespace {
+using Trades = lib::soa_vector<std::int64_t, std::int64_t, double, int>;
+
+bool isColumnAligned(const void* p) {
+  return reinterpret_cast<std::uintptr_t>(p) % 64 == 0;
+}
+}  // namespace
+
+TEST(SoaVector, StoresEachFieldInItsOwnColumn) {
+  Trades trades;
+  EXPECT_TRUE(trades.empty());
+  for (int i = 0; i < 1000; ++i) {
+    trades.push_back({i, 1000 + i, i * 0.5, i % 7});
+  }
+  ASSERT_EQ(1000, trades.size());
+  EXPECT_GE(trades.capacity(), 1000);
+
+  lib::span<double> prices = trades.column<2>();
+  ASSERT_EQ(1000, prices.size());
+  EXPECT_EQ(trades.data<2>(), prices.data());
+  EXPECT_DOUBLE_EQ(249750.0,
+                   std::accumulate(prices.begin(), prices.end(), 0.0));
+  EXPECT_TRUE(isColumnAligned(trades.data<0>()));
+  EXPECT_TRUE(isColumnAligned(trades.data<2>()));
+  EXPECT_TRUE(isColumnAligned(trades.data<3>()));
+  for (int i = 0; i < 1000; ++i) ASSERT_EQ(1000 + i, trades.data<1>()[i]);
+}
+
+TEST(SoaVector, RowsAreTuplesOfReferences) {
+  Trades trades;
+  trades.emplace_back(1, 2, 3.0, 4);
+  auto [id, ts, price, qty] = trades[0];
+  price = 9.5;
+  ++qty;
+  EXPECT_EQ(9.5, trades.data<2>()[0]);
+  EXPECT_EQ(5, std::get<3>(trades.front()));
+
+  Trades::row_type copy = trades[0];
+  std::get<0>(copy) = 100;
+  EXPECT_EQ(1, std::get<0>(trades[0]));
+  trades[0] = copy;
+  EXPECT_EQ(100, std::get<0>(trades.back()));
+  EXPECT_THROW(trades.at(1), std::out_of_range);
+
+  const Trades& view = trades;
+  EXPECT_EQ(2, std::get<1>(view.at(0)));
+  EXPECT_EQ(1, view.column<1>().size());
+}
+
+TEST(SoaVector, InsertManyBackAppendsRowsInOrder) {
+  lib::soa_vector<int, std::string> rows;
+  rows.insert_many_back(std::make_tuple(1, "one"), std::make_tuple(2, "two"));
+  rows.insert_many_back(std::make_tuple(3, std::string("three")));
+  ASSERT_EQ(3, rows.size());
+  EXPECT_EQ("one", std::get<1>(rows[0]));
+  EXPECT_EQ(3, std::get<0>(rows[2]));
+
+  // A row built from the vector's own fields survives the reallocation.
+  rows.shrink_to_fit();
+  EXPECT_EQ(3, rows.capacity());
+  rows.emplace_back(std::get<0>(rows[0]), std::get<1>(rows[2]));
+  EXPECT_EQ("three", std::get<1>(rows.back()));
+  EXPECT_EQ(1, std::get<0>(rows.back()));
+}
+
+TEST(SoaVector, CopyMoveAndSwap) {
+  lib::soa_vector<int, std::string> rows(2);
+  EXPECT_EQ("", std::get<1>(rows[1]));
+  for (int i = 0; i < 100; ++i) rows.push_back({i, std::to_string(i)});
+  lib::soa_vector<int, std::string> copy(rows);
+  ASSERT_EQ(102, copy.size());
+  EXPECT_EQ("99", std::get<1>(copy.back()));
+
+  lib::soa_vector<int, std::string> moved(std::move(copy));
+  EXPECT_TRUE(copy.empty());
+  EXPECT_EQ(0, copy.capacity());
+  copy.swap(moved);
+  EXPECT_EQ(102, copy.size());
+  moved = std::move(copy);
+  EXPECT_EQ(102, moved.size());
+
+  moved.pop_back();
+  EXPECT_EQ("98", std::get<1>(moved.back()));
+  moved.clear();
+  EXPECT_TRUE(moved.empty());
+  moved.shrink_to_fit();
+  EXPECT_EQ(nullptr, moved.data<0>());
+
+  lib::soa_vector<double, float> trivial{{1.0, 2.0f}, {3.0, 4.0f}};
+  lib::soa_vector<double, float> trivial_copy(trivial);
+  EXPECT_EQ(4.0f, std::get<1>(trivial_copy[1]));
+}
+
+namespace {
+struct ThrowOnCopy {
+  ThrowOnCopy() = default;
+  ThrowOnCopy(const ThrowOnCopy&) { throw std::runtime_error("copy"); }
+  ThrowOnCopy(ThrowOnCopy&&) noexcept = default;
+};
+}  // namespace
+
+TEST(SoaVector, FailedRowLeavesVectorUnchanged) {
+  lib::soa_vector<std::string, ThrowOnCopy> rows;
+  rows.emplace_back("kept", ThrowOnCopy());
+  ThrowOnCopy bad;
+  EXPECT_THROW(rows.emplace_back("lost", bad), std::runtime_error);
+  rows.reserve(10);
+  EXPECT_THROW(rows.emplace_back("lost", bad), std::runtime_error);
+  ASSERT_EQ(1, rows.size());
+  EXPECT_EQ("kept", std::get<0>(rows[0]));
+}
+
+TEST(SoaVector, FailedInsertManyBackKeepsNoRows) {
+  lib::soa_vector<std::string, ThrowOnCopy> rows;
+  rows.emplace_back("kept", ThrowOnCopy());
+  ThrowOnCopy bad;
+  using Row = std::tuple<std::string, ThrowOnCopy>;
+  EXPECT_THROW(rows.insert_many_back(Row("first", ThrowOnCopy()),
+                                     Row("second", ThrowOnCopy()),
+                                     std::forward_as_tuple("third", bad)),
+               std::runtime_error);
+  ASSERT_EQ(1, rows.size());
+  EXPECT_EQ("kept", std::get<0>(rows[0]));
+  rows.insert_many_back(Row("next", ThrowOnCopy()));
+  ASSERT_EQ(2, rows.size());
+  EXPECT_EQ("next", std::get<0>(rows[1]));
+}
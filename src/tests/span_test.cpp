@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "../lib_containers.h"
+#include "../lib_containersplus.h"
+
+namespace {
+// Takes any part of a vector without copying it.
+int sumOf(lib::span<const int> values) {
+  int total = 0;
+  for (int v : values) total += v;
+  return total;
+}
+}  // namespace
+
+TEST(Span, ViewsVectorWithoutCopying) {
+  lib::vector<int> values{1, 2, 3, 4, 5, 6};
+  lib::span all(values);
+  static_assert(std::is_same_v<decltype(all), lib::span<int>>);
+  EXPECT_EQ(values.data(), all.data());
+  EXPECT_EQ(6, all.size());
+  EXPECT_EQ(24, all.size_bytes());
+  all[0] = 10;
+  EXPECT_EQ(10, values[0]);
+
+  EXPECT_EQ(30, sumOf(values));
+  EXPECT_EQ(12, sumOf(all.first(2)));
+  EXPECT_EQ(11, sumOf(all.last(2)));
+  EXPECT_EQ(7, sumOf(all.subspan(2, 2)));
+  EXPECT_EQ(18, sumOf(all.subspan(2)));
+  EXPECT_TRUE(all.subspan(6).empty());
+  EXPECT_EQ(6, all.back());
+  EXPECT_THROW(all.at(6), std::out_of_range);
+  EXPECT_THROW(all.first(7), std::out_of_range);
+  EXPECT_THROW(all.subspan(7), std::out_of_range);
+  EXPECT_THROW(all.subspan(3, 4), std::out_of_range);
+
+  lib::span<int> empty;
+  EXPECT_TRUE(empty.empty());
+  EXPECT_EQ(empty.begin(), empty.end());
+}
+
+TEST(Span, FixedExtent) {
+  lib::array<double, 4> samples{1.0, 2.0, 3.0, 4.0};
+  lib::span fixed(samples);
+  static_assert(std::is_same_v<decltype(fixed), lib::span<double, 4>>);
+  static_assert(sizeof(fixed) == sizeof(double*));
+  EXPECT_EQ(4, fixed.size());
+
+  lib::span<double, 2> head = fixed.first<2>();
+  EXPECT_EQ(2.0, head[1]);
+  lib::span<const double, 2> tail = fixed.last<2>();
+  EXPECT_EQ(3.0, tail.front());
+  lib::span<const double> dynamic = fixed;
+  EXPECT_EQ(4, dynamic.size());
+  EXPECT_THROW(dynamic.first<5>(), std::out_of_range);
+}
+
+TEST(Span, StridedView) {
+  // Two interleaved channels.
+  lib::vector<int> samples{0, 100, 1, 101, 2, 102, 3, 103, 4};
+  lib::strided_view left(lib::span<int>(samples), 2);
+  lib::strided_view right(lib::span<int>(samples).subspan(1), 2);
+  ASSERT_EQ(5, left.size());
+  ASSERT_EQ(4, right.size());
+  EXPECT_EQ(4, left[4]);
+  EXPECT_EQ(103, right.at(3));
+  EXPECT_THROW(right.at(4), std::out_of_range);
+
+  std::vector<int> copied(right.begin(), right.end());
+  EXPECT_EQ((std::vector<int>{100, 101, 102, 103}), copied);
+  auto it = left.begin() + 3;
+  EXPECT_EQ(3, *it);
+  EXPECT_EQ(3, it - left.begin());
+  EXPECT_EQ(1, it[-2]);
+  EXPECT_TRUE(left.begin() < it);
+  EXPECT_EQ(left.end(), it + 2);
+
+  lib::strided_view<int> backwards(samples.data() + 8, 5, -2);
+  std::vector<int> reversed(backwards.begin(), backwards.end());
+  EXPECT_EQ((std::vector<int>{4, 3, 2, 1, 0}), reversed);
+}
+
+TEST(Span, SimdKernelsTakeSpans) {
+  lib::vector<float> values;
+  for (int i = 0; i < 100; ++i) values.push_back(float(i));
+  lib::span<float> all(values);
+  EXPECT_EQ(4950.0f, lib::simd::sum(all));
+  EXPECT_EQ(45.0f, lib::simd::sum(all.first(10)));
+  EXPECT_EQ(40, lib::simd::find(all.subspan(50), 90.0f));
+  lib::simd::clamp(all.last(50), 0.0f, 60.0f);
+  EXPECT_EQ(60.0f, values[99]);
+}
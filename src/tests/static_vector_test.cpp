@@ -0,0 +1,120 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "../lib_containersplus.h"
+#include "allocation_counter.h"
+
+using lib::static_vector;
+
+namespace {
+// Edits a vector at compile time; the static_assert below runs it.
+constexpr int sumAfterEdits() {
+  static_vector<int, 8> v({});
+  v.push_back(4);
+  v.insert_many_back(5, 6, 7);
+  v.insert(v.begin(), 1);
+  v.emplace(v.begin() + 1, 2);
+  v.erase(v.begin() + 2);
+  v.pop_back();
+  int sum = 0;
+  for (int x : v) sum += x;
+  return sum * 10 + static_cast<int>(v.size());
+}
+
+static_assert(sumAfterEdits() == 144);
+static_assert(std::is_trivially_copyable_v<static_vector<int, 16>>);
+// Trivially copyable but not trivial: kept in raw bytes.
+struct Point {
+  int x = 0;
+  int y = 0;
+};
+static_assert(std::is_trivially_copyable_v<static_vector<Point, 4>>);
+static_assert(!std::is_trivially_copyable_v<static_vector<std::string, 4>>);
+}  // namespace
+
+TEST(StaticVector, PushInsertEraseWithoutAllocating) {
+  std::size_t allocations = test::allocationCount();
+  static_vector<int, 8> v;
+  EXPECT_TRUE(v.empty());
+  EXPECT_EQ(8, v.capacity());
+  for (int i = 0; i < 5; ++i) v.push_back(i);
+  v.insert(v.begin() + 2, 42);
+  EXPECT_EQ((static_vector<int, 8>{0, 1, 42, 2, 3, 4}), v);
+  v.erase(v.begin());
+  v.erase(v.begin() + 1, v.begin() + 3);
+  EXPECT_EQ((static_vector<int, 8>{1, 3, 4}), v);
+  v.insert_many_back(5, 6);
+  EXPECT_EQ(6, v.back());
+  EXPECT_EQ(1, v.front());
+  EXPECT_EQ(allocations, test::allocationCount());
+
+  static_vector<Point, 4> points;
+  points.emplace_back();
+  points.push_back({1, 2});
+  static_vector<Point, 4> copy = points;
+  EXPECT_EQ(2, copy.back().y);
+  EXPECT_EQ(0, copy.front().x);
+}
+
+TEST(StaticVector, OverflowThrowsAndKeepsElements) {
+  static_vector<int, 3> v{1, 2, 3};
+  EXPECT_TRUE(v.full());
+  EXPECT_THROW(v.push_back(4), std::length_error);
+  EXPECT_THROW(v.insert(v.begin(), 0), std::length_error);
+  EXPECT_FALSE(v.try_push_back(4));
+  v.pop_back();
+  EXPECT_THROW(v.insert_many_back(8, 9), std::length_error);
+  EXPECT_EQ((static_vector<int, 3>{1, 2}), v);
+  EXPECT_TRUE(v.try_push_back(7));
+  EXPECT_EQ(7, v.at(2));
+  EXPECT_THROW(v.at(3), std::out_of_range);
+  EXPECT_THROW((static_vector<int, 2>{1, 2, 3}), std::length_error);
+}
+
+TEST(StaticVector, ManagesNonTrivialElements) {
+  static_vector<std::string, 4> words{"b", "c"};
+  words.insert(words.begin(), "a");
+  // The inserted value may be one of the elements it shifts.
+  words.insert(words.begin(), words[2]);
+  EXPECT_EQ((static_vector<std::string, 4>{"c", "a", "b", "c"}), words);
+  static_vector<std::string, 4> copy(words);
+  words.erase(words.begin() + 1);
+  EXPECT_EQ(3, words.size());
+  EXPECT_EQ("a", copy[1]);
+  copy = words;
+  EXPECT_EQ(words, copy);
+  static_vector<std::string, 4> moved(std::move(copy));
+  EXPECT_EQ("b", moved[1]);
+  words.clear();
+  EXPECT_TRUE(words.empty());
+
+  static_vector<std::unique_ptr<int>, 2> owners;
+  owners.emplace_back(new int(5));
+  owners.insert(owners.begin(), std::make_unique<int>(4));
+  static_vector<std::unique_ptr<int>, 2> taken(std::move(owners));
+  EXPECT_EQ(4, *taken[0]);
+  EXPECT_EQ(5, *taken.back());
+}
+
+namespace {
+struct ThrowOnCopy {
+  ThrowOnCopy() = default;
+  ThrowOnCopy(const ThrowOnCopy&) { throw std::runtime_error("copy"); }
+};
+}  // namespace
+
+TEST(StaticVector, InsertManyBackIsAllOrNothing) {
+  static_vector<std::pair<std::string, ThrowOnCopy>, 4> v;
+  v.emplace_back();
+  std::pair<std::string, ThrowOnCopy> bad;
+  EXPECT_THROW(v.insert_many_back(std::make_pair(std::string("x"),
+                                                 ThrowOnCopy()),
+                                  bad),
+               std::runtime_error);
+  EXPECT_EQ(1, v.size());
+}
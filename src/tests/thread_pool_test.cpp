@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+
+#include "../lib_thread_pool.h"
+
+TEST(ThreadPool, Size) {
+  lib::thread_pool pool(4);
+  EXPECT_EQ(pool.size(), 4);
+  lib::thread_pool single(1);
+  EXPECT_EQ(single.size(), 1);
+  EXPECT_GE(lib::thread_pool::global().size(), 1);
+}
+
+TEST(ThreadPool, ParallelForRunsEveryIndexOnce) {
+  lib::thread_pool pool(4);
+  std::atomic<int> hits[1000] = {};
+  pool.parallel_for(1000, [&](std::size_t i) { ++hits[i]; });
+  for (int i = 0; i < 1000; ++i) EXPECT_EQ(hits[i].load(), 1);
+}
+
+TEST(ThreadPool, ParallelForIsReusable) {
+  lib::thread_pool pool(3);
+  for (int round = 0; round < 50; ++round) {
+    std::atomic<int> count{0};
+    pool.parallel_for(round, [&](std::size_t) { ++count; });
+    EXPECT_EQ(count.load(), round);
+  }
+}
+
+TEST(ThreadPool, NestedParallelForRunsInline) {
+  lib::thread_pool pool(4);
+  std::atomic<int> count{0};
+  pool.parallel_for(8, [&](std::size_t) {
+    pool.parallel_for(8, [&](std::size_t) { ++count; });
+  });
+  EXPECT_EQ(count.load(), 64);
+}
+
+TEST(ThreadPool, ParallelForRethrows) {
+  lib::thread_pool pool(4);
+  EXPECT_THROW(pool.parallel_for(100,
+                                 [](std::size_t i) {
+                                   if (i == 42) throw std::runtime_error("42");
+                                 }),
+               std::runtime_error);
+  std::atomic<int> count{0};
+  pool.parallel_for(10, [&](std::size_t) { ++count; });
+  EXPECT_EQ(count.load(), 10);
+}
+
+TEST(ThreadPool, IdleThreadsStealWork) {
+  lib::thread_pool pool(4);
+  std::mutex mutex;
+  std::set<std::thread::id> threads;
+  pool.parallel_for(64, [&](std::size_t i) {
+    if (i >= 16) return;
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    std::lock_guard<std::mutex> lock(mutex);
+    threads.insert(std::this_thread::get_id());
+  });
+  // The caller's share is [0, 16); the other threads finish theirs at once
+  // and take over part of it.
+  EXPECT_GT(threads.size(), 1);
+}
@@ -0,0 +1,171 @@
+#include <fcntl.h>
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <vector>
+
+#include "../lib_small_vector.h"
+#include "../lib_vector_io.h"
+
+namespace {
+struct Record {
+  std::int64_t id;
+  double value;
+};
+
+// Trivially copyable but not trivially default constructible.
+struct DefaultedRecord {
+  long id = -1;
+  double value = 0;
+};
+
+// A path in the test temp directory, removed when the test ends.
+class TempFile {
+ public:
+  explicit TempFile(const std::string& name)
+      : path_(::testing::TempDir() + name + "." + std::to_string(::getpid())) {
+    std::remove(path_.c_str());
+  }
+  ~TempFile() { std::remove(path_.c_str()); }
+  const std::string& path() const { return path_; }
+
+ private:
+  std::string path_;
+};
+
+lib::vector<Record> makeRecords(int count) {
+  lib::vector<Record> records;
+  for (int i = 0; i < count; ++i) records.push_back({i, i * 0.5});
+  return records;
+}
+
+std::vector<std::uint32_t> asStd(lib::vector<std::uint32_t>& v) {
+  return std::vector<std::uint32_t>(v.begin(), v.end());
+}
+}  // namespace
+
+TEST(VectorIo, WriteThenAppendFromPath) {
+  TempFile file("vector_io_records");
+  lib::vector<Record> records = makeRecords(1000);
+  lib::write_to(records, file.path());
+
+  lib::vector<Record> loaded{{-1, -1.0}};
+  EXPECT_EQ(1000, lib::append_from(loaded, file.path()));
+  ASSERT_EQ(1001, loaded.size());
+  EXPECT_EQ(-1, loaded[0].id);
+  for (int i = 0; i < 1000; ++i) ASSERT_EQ(i, loaded[i + 1].id);
+  EXPECT_EQ(499.5, loaded.back().value);
+
+  lib::small_vector<Record, 4> small;
+  EXPECT_EQ(1000, lib::append_from(small, file.path()));
+  EXPECT_EQ(999, small.back().id);
+}
+
+TEST(VectorIo, WritesConstVectors) {
+  TempFile file("vector_io_const");
+  const lib::vector<Record> records = makeRecords(300);
+  lib::write_to(records, file.path());
+  lib::vector<Record> loaded;
+  EXPECT_EQ(300, lib::append_from(loaded, file.path()));
+  EXPECT_EQ(299, loaded.back().id);
+
+  int fd = ::open(file.path().c_str(), O_WRONLY);
+  ASSERT_GE(fd, 0);
+  const lib::vector<Record> first{{-7, 0.0}};
+  lib::write_to(first, fd);
+  ::close(fd);
+  loaded.clear();
+  lib::append_from(loaded, file.path());
+  EXPECT_EQ(-7, loaded[0].id);
+  EXPECT_EQ(1, loaded[1].id);
+}
+
+TEST(VectorIo, DescriptorFormsUseOffsetsAndStopAtEnd) {
+  TempFile file("vector_io_words");
+  int fd = ::open(file.path().c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  ASSERT_GE(fd, 0);
+  lib::vector<std::uint32_t> words{1, 2, 3, 4, 5, 6};
+  lib::write_to(words, fd);
+  lib::vector<std::uint32_t> tail{7, 8};
+  lib::write_to(tail, fd, 6 * sizeof(std::uint32_t));
+
+  lib::vector<std::uint32_t> part;
+  EXPECT_EQ(3, lib::append_from(part, fd, 3, 2 * sizeof(std::uint32_t)));
+  EXPECT_EQ((std::vector<std::uint32_t>{3, 4, 5}), asStd(part));
+  EXPECT_EQ(3, lib::append_from(part, fd, 100, 5 * sizeof(std::uint32_t)));
+  EXPECT_EQ((std::vector<std::uint32_t>{3, 4, 5, 6, 7, 8}), asStd(part));
+  EXPECT_EQ(0, lib::append_from(part, fd, 10, 8 * sizeof(std::uint32_t)));
+  EXPECT_EQ(6, part.size());
+  // The calls use pread and pwrite, so the file position never moved.
+  EXPECT_EQ(0, ::lseek(fd, 0, SEEK_CUR));
+  ::close(fd);
+}
+
+TEST(VectorIo, FailuresKeepTheVector) {
+  TempFile file("vector_io_torn");
+  lib::vector<char> torn(20);
+  lib::write_to(torn, file.path());
+  lib::vector<Record> records = makeRecords(3);
+  EXPECT_THROW(lib::append_from(records, file.path()), std::runtime_error);
+  int fd = ::open(file.path().c_str(), O_RDONLY);
+  EXPECT_THROW(lib::append_from(records, fd, 4), std::runtime_error);
+  ::close(fd);
+  EXPECT_THROW(lib::append_from(records, -1, 4), std::system_error);
+  EXPECT_THROW(lib::append_from(records, file.path() + ".missing"),
+               std::system_error);
+  ASSERT_EQ(3, records.size());
+  EXPECT_EQ(2, records[2].id);
+}
+
+TEST(VectorIo, RecordReaderStreamsChunks) {
+  TempFile file("vector_io_stream");
+  lib::vector<Record> records = makeRecords(1000);
+  lib::write_to(records, file.path());
+
+  lib::record_reader<Record> reader(file.path(), 64);
+  EXPECT_EQ(64, reader.chunk_size());
+  lib::vector<Record> chunk;
+  std::int64_t next_id = 0;
+  int chunks = 0;
+  while (reader.next(chunk)) {
+    ASSERT_LE(chunk.size(), 64);
+    for (const Record& record : chunk) ASSERT_EQ(next_id++, record.id);
+    ++chunks;
+  }
+  EXPECT_EQ(1000, next_id);
+  EXPECT_EQ(16, chunks);
+  EXPECT_EQ(1000, reader.position());
+  EXPECT_TRUE(chunk.empty());
+  EXPECT_EQ(64, chunk.capacity());
+
+  lib::record_reader<Record> moved(std::move(reader));
+  EXPECT_FALSE(moved.next(chunk));
+  EXPECT_THROW(reader.next(chunk), std::logic_error);
+  EXPECT_THROW(lib::record_reader<Record>(file.path(), 0),
+               std::invalid_argument);
+}
+
+TEST(VectorIo, RecordsWithDefaultMemberInitializers) {
+  TempFile file("vector_io_defaulted");
+  lib::vector<DefaultedRecord> records;
+  for (int i = 0; i < 100; ++i) records.push_back({i, i * 0.25});
+  lib::write_to(records, file.path());
+
+  lib::vector<DefaultedRecord> loaded(1);
+  EXPECT_EQ(100, lib::append_from(loaded, file.path()));
+  ASSERT_EQ(101, loaded.size());
+  EXPECT_EQ(-1, loaded[0].id);
+  for (int i = 0; i < 100; ++i) ASSERT_EQ(i, loaded[i + 1].id);
+  EXPECT_EQ(24.75, loaded.back().value);
+
+  lib::record_reader<DefaultedRecord> reader(file.path(), 30);
+  lib::vector<DefaultedRecord> chunk;
+  long total = 0;
+  while (reader.next(chunk)) total += chunk.size();
+  EXPECT_EQ(100, total);
+}
@@ -1,5 +1,17 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
 #include "../lib_containers.h"
 
 TEST(Vector, DefaultConstructor) {
@@ -597,3 +609,617 @@ TEST(Vector, BonusModifiersInsertManyBackEmpty) {
   EXPECT_EQ('o', A[2]);
   EXPECT_EQ('l', A[3]);
 }
+
+namespace {
+struct Tracked {
+  static int alive;
+  static int constructed;
+  int value;
+  explicit Tracked(int v) : value(v) {
+    ++alive;
+    ++constructed;
+  }
+  Tracked(const Tracked& other) : value(other.value) {
+    ++alive;
+    ++constructed;
+  }
+  Tracked& operator=(const Tracked&) = default;
+  ~Tracked() { --alive; }
+};
+int Tracked::alive = 0;
+int Tracked::constructed = 0;
+}  // namespace
+
+TEST(Vector, StoresNonDefaultConstructible) {
+  Tracked::alive = 0;
+  {
+    lib::vector<Tracked> A;
+    for (int i = 0; i < 10; ++i) A.push_back(Tracked(i));
+    A.insert(A.begin() + 3, Tracked(100));
+    A.erase(A.begin());
+    EXPECT_EQ(10, A.size());
+    EXPECT_EQ(1, A[0].value);
+    EXPECT_EQ(100, A[2].value);
+    EXPECT_EQ(10, Tracked::alive);
+  }
+  EXPECT_EQ(0, Tracked::alive);
+}
+
+TEST(Vector, ReserveConstructsNothing) {
+  Tracked::alive = 0;
+  Tracked::constructed = 0;
+  lib::vector<Tracked> A;
+  A.reserve(1000);
+  EXPECT_EQ(0, Tracked::constructed);
+  A.push_back(Tracked(1));
+  lib::vector<Tracked> B(A);
+  EXPECT_EQ(1000, B.capacity());
+  EXPECT_EQ(2, Tracked::alive);
+}
+
+TEST(Vector, PopBackAndClearReleaseElements) {
+  auto resource = std::make_shared<int>(7);
+  lib::vector<std::shared_ptr<int>> A;
+  A.push_back(resource);
+  A.push_back(resource);
+  EXPECT_EQ(3, resource.use_count());
+  A.pop_back();
+  EXPECT_EQ(2, resource.use_count());
+  A.push_back(resource);
+  A.clear();
+  EXPECT_EQ(1, resource.use_count());
+  A.push_back(resource);
+  A.erase(A.begin());
+  EXPECT_EQ(1, resource.use_count());
+}
+
+namespace {
+template <bool kNoexceptMove>
+struct CopyCounter {
+  static int copies;
+  static int moves;
+  int value = 0;
+  CopyCounter() = default;
+  explicit CopyCounter(int v) : value(v) {}
+  CopyCounter(const CopyCounter& other) : value(other.value) { ++copies; }
+  CopyCounter(CopyCounter&& other) noexcept(kNoexceptMove)
+      : value(other.value) {
+    ++moves;
+  }
+  CopyCounter& operator=(const CopyCounter& other) {
+    value = other.value;
+    ++copies;
+    return *this;
+  }
+  CopyCounter& operator=(CopyCounter&& other) noexcept(kNoexceptMove) {
+    value = other.value;
+    ++moves;
+    return *this;
+  }
+};
+template <bool kNoexceptMove>
+int CopyCounter<kNoexceptMove>::copies = 0;
+template <bool kNoexceptMove>
+int CopyCounter<kNoexceptMove>::moves = 0;
+}  // namespace
+
+TEST(Vector, ReallocationMovesNoexceptElements) {
+  using Counter = CopyCounter<true>;
+  lib::vector<Counter> A;
+  A.reserve(1);
+  A.push_back(Counter(0));
+  Counter::copies = 0;
+  for (int i = 1; i < 100; ++i) A.push_back(Counter(i));
+  EXPECT_EQ(0, Counter::copies);
+  A.reserve(1000);
+  A.shrink_to_fit();
+  A.insert(A.begin(), Counter(-1));
+  EXPECT_EQ(0, Counter::copies);
+  for (int i = 0; i < 100; ++i) EXPECT_EQ(i, A[i + 1].value);
+}
+
+TEST(Vector, ReallocationCopiesThrowingMoveElements) {
+  using Counter = CopyCounter<false>;
+  lib::vector<Counter> A(4);
+  Counter::copies = 0;
+  A.reserve(8);
+  EXPECT_EQ(4, Counter::copies);
+}
+
+TEST(Vector, NestedVectorsAreMovedOnGrowth) {
+  lib::vector<lib::vector<int>> A;
+  A.push_back(lib::vector<int>({1, 2, 3}));
+  int* inner = A[0].data();
+  for (int i = 0; i < 64; ++i) A.push_back(lib::vector<int>({i}));
+  EXPECT_EQ(inner, A[0].data());
+  EXPECT_EQ(3, A[0].size());
+  EXPECT_EQ(63, A[64][0]);
+}
+
+TEST(Vector, TrivialElementsSurviveInsertAndGrowth) {
+  lib::vector<long> A;
+  for (long i = 0; i < 1000; ++i) A.insert(A.begin(), i);
+  for (long i = 0; i < 1000; ++i) EXPECT_EQ(999 - i, A[i]);
+  lib::vector<long> B(A);
+  EXPECT_EQ(B[0], 999);
+  EXPECT_EQ(B[999], 0);
+}
+
+TEST(Vector, EmplaceBackConstructsInPlace) {
+  using Counter = CopyCounter<true>;
+  lib::vector<Counter> A;
+  Counter::copies = 0;
+  for (int i = 0; i < 50; ++i) EXPECT_EQ(i, A.emplace_back(i).value);
+  A.push_back(Counter(50));
+  A.insert(A.begin(), Counter(-1));
+  A.emplace(A.begin() + 1, -2);
+  A.insert_many_back(51, 52);
+  A.insert_many(A.begin(), -4, -3);
+  EXPECT_EQ(0, Counter::copies);
+  ASSERT_EQ(57, A.size());
+  EXPECT_EQ(-4, A[0].value);
+  EXPECT_EQ(-3, A[1].value);
+  EXPECT_EQ(-1, A[2].value);
+  EXPECT_EQ(-2, A[3].value);
+  EXPECT_EQ(0, A[4].value);
+  EXPECT_EQ(52, A[56].value);
+}
+
+TEST(Vector, MoveOnlyElements) {
+  lib::vector<std::unique_ptr<int>> A;
+  for (int i = 0; i < 10; ++i) A.push_back(std::make_unique<int>(i));
+  A.emplace(A.begin() + 5, new int(100));
+  A.insert(A.begin(), std::make_unique<int>(-1));
+  A.erase(A.begin() + 1);
+  ASSERT_EQ(11, A.size());
+  EXPECT_EQ(-1, *A[0]);
+  EXPECT_EQ(1, *A[1]);
+  EXPECT_EQ(100, *A[5]);
+  EXPECT_EQ(9, *A[10]);
+}
+
+TEST(Vector, PushBackOwnElementWhileGrowing) {
+  lib::vector<std::string> A({std::string(40, 'a'), std::string(40, 'b')});
+  ASSERT_EQ(A.size(), A.capacity());
+  A.push_back(A[0]);
+  A.emplace_back(A[1]);
+  A.insert(A.begin() + 1, A[3]);
+  ASSERT_EQ(5, A.size());
+  EXPECT_EQ(std::string(40, 'a'), A[3]);
+  EXPECT_EQ(std::string(40, 'b'), A[1]);
+  EXPECT_EQ(std::string(40, 'b'), A[4]);
+}
+
+TEST(Vector, InsertManyShiftsTailOnce) {
+  using Counter = CopyCounter<true>;
+  lib::vector<Counter> A;
+  A.reserve(20);
+  for (int i = 0; i < 10; ++i) A.emplace_back(i);
+  Counter::copies = 0;
+  Counter::moves = 0;
+  auto pos = A.insert_many(A.begin() + 2, 100, 101, 102, 103, 104);
+  EXPECT_EQ(A.begin() + 2, pos);
+  EXPECT_EQ(8, Counter::moves);
+  EXPECT_EQ(0, Counter::copies);
+  int expected[] = {0, 1, 100, 101, 102, 103, 104, 2, 3, 4, 5, 6, 7, 8, 9};
+  ASSERT_EQ(15, A.size());
+  for (int i = 0; i < 15; ++i) EXPECT_EQ(expected[i], A[i].value);
+
+  Counter::moves = 0;
+  A.insert_many(A.begin() + 1, 200, 201, 202, 203, 204, 205);
+  EXPECT_EQ(15, Counter::moves);
+  EXPECT_EQ(21, A.size());
+  EXPECT_EQ(0, A[0].value);
+  EXPECT_EQ(205, A[6].value);
+  EXPECT_EQ(1, A[7].value);
+  EXPECT_EQ(9, A[20].value);
+}
+
+TEST(Vector, InsertRange) {
+  lib::vector<std::string> A({"a", "e"});
+  std::list<std::string> middle = {"b", "c", "d"};
+  auto pos = A.insert(A.begin() + 1, middle.begin(), middle.end());
+  EXPECT_EQ(A.begin() + 1, pos);
+  A.insert(A.end(), {std::string("f"), std::string("g")});
+  A.insert(A.begin(), middle.begin(), middle.begin());
+  std::istringstream input("x y");
+  pos = A.insert(A.begin(), std::istream_iterator<std::string>(input),
+                 std::istream_iterator<std::string>());
+  EXPECT_EQ(A.begin(), pos);
+  std::vector<std::string> expected = {"x", "y", "a", "b", "c",
+                                       "d", "e", "f", "g"};
+  ASSERT_EQ(expected.size(), A.size());
+  for (size_t i = 0; i < expected.size(); ++i) EXPECT_EQ(expected[i], A[i]);
+}
+
+TEST(Vector, InsertTrivialRangeNearFront) {
+  lib::vector<int> A;
+  for (int i = 0; i < 1000; ++i) A.push_back(i);
+  std::vector<int> extra(300, -1);
+  A.insert(A.begin() + 1, extra.begin(), extra.end());
+  A.reserve(2000);
+  A.insert(A.begin() + 1, extra.data(), extra.data() + 100);
+  ASSERT_EQ(1400, A.size());
+  EXPECT_EQ(0, A[0]);
+  for (int i = 1; i <= 400; ++i) EXPECT_EQ(-1, A[i]);
+  for (int i = 1; i < 1000; ++i) EXPECT_EQ(i, A[i + 400]);
+}
+
+namespace {
+struct ThrowOnNegative {
+  std::string name;
+  explicit ThrowOnNegative(int v) : name(std::to_string(v)) {
+    if (v < 0) throw std::invalid_argument("negative");
+  }
+};
+}  // namespace
+
+TEST(Vector, FailedInsertLeavesVectorUnchanged) {
+  lib::vector<ThrowOnNegative> A;
+  A.reserve(10);
+  for (int i = 0; i < 4; ++i) A.emplace_back(i);
+  EXPECT_THROW(A.insert_many(A.begin() + 1, 7, -1), std::invalid_argument);
+  EXPECT_THROW(A.insert_many(A.begin() + 1, 1, 2, 3, 4, 5, 6, -1),
+               std::invalid_argument);
+  ASSERT_EQ(4, A.size());
+  EXPECT_EQ(10, A.capacity());
+  for (int i = 0; i < 4; ++i) EXPECT_EQ(std::to_string(i), A[i].name);
+}
+
+TEST(Vector, EraseRange) {
+  lib::vector<std::string> A({"a", "b", "c", "d", "e", "f"});
+  auto pos = A.erase(A.begin() + 1, A.begin() + 4);
+  EXPECT_EQ(A.begin() + 1, pos);
+  ASSERT_EQ(3, A.size());
+  EXPECT_EQ("a", A[0]);
+  EXPECT_EQ("e", A[1]);
+  EXPECT_EQ("f", A[2]);
+  pos = A.erase(A.begin() + 1, A.end());
+  EXPECT_EQ(A.end(), pos);
+  EXPECT_EQ(A.begin(), A.erase(A.begin(), A.begin()));
+  ASSERT_EQ(1, A.size());
+  EXPECT_EQ("a", A[0]);
+}
+
+TEST(Vector, EraseRangeDestroysRemoved) {
+  auto counter = std::make_shared<int>(0);
+  lib::vector<std::shared_ptr<int>> A;
+  for (int i = 0; i < 10; ++i) A.push_back(counter);
+  EXPECT_EQ(11, counter.use_count());
+  A.erase(A.begin() + 2, A.begin() + 7);
+  EXPECT_EQ(6, counter.use_count());
+  A.unordered_erase(A.begin());
+  EXPECT_EQ(5, counter.use_count());
+  EXPECT_EQ(4, lib::erase_if(A, [](const std::shared_ptr<int>& p) {
+              return p != nullptr;
+            }));
+  EXPECT_EQ(1, counter.use_count());
+}
+
+TEST(Vector, EraseIfKeepsOrder) {
+  lib::vector<int> A;
+  for (int i = 0; i < 100; ++i) A.push_back(i);
+  EXPECT_EQ(66, A.erase_if([](int v) { return v % 3 != 0; }));
+  ASSERT_EQ(34, A.size());
+  for (int i = 0; i < 34; ++i) EXPECT_EQ(3 * i, A[i]);
+  EXPECT_EQ(0, A.erase_if([](int v) { return v < 0; }));
+  EXPECT_EQ(34, lib::erase_if(A, [](int) { return true; }));
+  EXPECT_TRUE(A.empty());
+}
+
+TEST(Vector, UnorderedErase) {
+  lib::vector<std::string> A({"a", "b", "c", "d"});
+  auto pos = A.unordered_erase(A.begin() + 1);
+  EXPECT_EQ(A.begin() + 1, pos);
+  ASSERT_EQ(3, A.size());
+  EXPECT_EQ("a", A[0]);
+  EXPECT_EQ("d", A[1]);
+  EXPECT_EQ("c", A[2]);
+  pos = A.unordered_erase(A.begin() + 2);
+  EXPECT_EQ(A.end(), pos);
+  ASSERT_EQ(2, A.size());
+  EXPECT_EQ("d", A[1]);
+}
+
+TEST(Vector, GrowsOnlyWhenFull) {
+  lib::vector<int> A;
+  A.reserve(4);
+  for (int i = 0; i < 3; ++i) A.push_back(i);
+  int* data = A.data();
+  A.push_back(3);
+  EXPECT_EQ(data, A.data());
+  EXPECT_EQ(4, A.capacity());
+  A.insert_many_back(4);
+  EXPECT_EQ(8, A.capacity());
+  A.reserve(9);
+  EXPECT_EQ(9, A.capacity());
+}
+
+namespace {
+template <typename Growth>
+lib::vector<std::size_t> capacitySteps(std::size_t count) {
+  lib::vector<std::size_t> steps;
+  lib::vector<int, Growth> v;
+  for (std::size_t i = 0; i < count; ++i) {
+    v.push_back(0);
+    if (steps.empty() || steps.back() != v.capacity()) {
+      steps.push_back(v.capacity());
+    }
+  }
+  return steps;
+}
+}  // namespace
+
+TEST(Vector, GrowthPolicies) {
+  auto doubling = capacitySteps<lib::doubling_growth>(20);
+  std::size_t expected_doubling[] = {1, 2, 4, 8, 16, 32};
+  ASSERT_EQ(6, doubling.size());
+  for (int i = 0; i < 6; ++i) EXPECT_EQ(expected_doubling[i], doubling[i]);
+
+  auto one_and_half = capacitySteps<lib::one_and_half_growth>(20);
+  std::size_t expected_one_and_half[] = {1, 2, 3, 4, 6, 9, 13, 19, 28};
+  ASSERT_EQ(9, one_and_half.size());
+  for (int i = 0; i < 9; ++i) {
+    EXPECT_EQ(expected_one_and_half[i], one_and_half[i]);
+  }
+
+  auto golden = capacitySteps<lib::golden_growth>(20);
+  std::size_t expected_golden[] = {1, 2, 3, 4, 6, 9, 14, 22};
+  ASSERT_EQ(8, golden.size());
+  for (int i = 0; i < 8; ++i) EXPECT_EQ(expected_golden[i], golden[i]);
+
+  auto linear = capacitySteps<lib::linear_growth<8>>(20);
+  std::size_t expected_linear[] = {8, 16, 24};
+  ASSERT_EQ(3, linear.size());
+  for (int i = 0; i < 3; ++i) EXPECT_EQ(expected_linear[i], linear[i]);
+}
+
+TEST(Vector, GrowthCoversLargeInsert) {
+  lib::vector<int, lib::linear_growth<4>> A = {1, 2, 3, 4};
+  std::vector<int> extra(100, 0);
+  A.insert(A.begin() + 2, extra.begin(), extra.end());
+  EXPECT_EQ(104, A.size());
+  EXPECT_EQ(104, A.capacity());
+  EXPECT_EQ(3, A[102]);
+}
+
+namespace {
+// Random, sorted, reversed and few-unique inputs of each size, on both
+// sides of the radix sort threshold.
+template <typename T>
+std::vector<std::vector<T>> sortInputs() {
+  std::vector<std::vector<T>> inputs;
+  std::mt19937_64 gen(1);
+  for (std::size_t n : {0, 1, 2, 15, 100, 511, 512, 3000}) {
+    std::vector<T> random(n);
+    std::vector<T> few(n);
+    for (std::size_t i = 0; i < n; ++i) {
+      random[i] = static_cast<T>(gen());
+      if constexpr (std::is_floating_point_v<T>) random[i] = T(gen() % 2001);
+      if constexpr (std::is_signed_v<T>) random[i] -= T(1000);
+      few[i] = static_cast<T>(gen() % 4);
+    }
+    std::vector<T> sorted = random;
+    std::sort(sorted.begin(), sorted.end());
+    std::vector<T> reversed(sorted.rbegin(), sorted.rend());
+    inputs.insert(inputs.end(), {random, sorted, reversed, few});
+  }
+  return inputs;
+}
+
+template <typename T, typename Sort>
+void expectSorts(Sort sort) {
+  for (const std::vector<T>& input : sortInputs<T>()) {
+    lib::vector<T> values;
+    values.insert(values.begin(), input.begin(), input.end());
+    std::vector<T> expected = input;
+    std::sort(expected.begin(), expected.end());
+    sort(values);
+    ASSERT_EQ(expected.size(), values.size());
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+      ASSERT_EQ(expected[i], values[i]) << input.size() << " " << i;
+    }
+  }
+}
+
+template <typename T>
+void expectAllSorts() {
+  expectSorts<T>([](lib::vector<T>& v) { v.sort(); });
+  expectSorts<T>([](lib::vector<T>& v) { v.stable_sort(); });
+  expectSorts<T>([](lib::vector<T>& v) {
+    v.sort([](T a, T b) { return a < b; });
+  });
+  expectSorts<T>([](lib::vector<T>& v) {
+    v.stable_sort([](T a, T b) { return a < b; });
+  });
+  expectSorts<T>([](lib::vector<T>& v) {
+    v.sort(std::greater<T>());
+    std::reverse(v.begin(), v.end());
+  });
+}
+}  // namespace
+
+TEST(Vector, SortMatchesStdSort) {
+  expectAllSorts<int>();
+  expectAllSorts<std::int64_t>();
+  expectAllSorts<std::uint32_t>();
+  expectAllSorts<std::uint8_t>();
+  expectAllSorts<std::int16_t>();
+  expectAllSorts<float>();
+  expectAllSorts<double>();
+}
+
+TEST(Vector, SortOrdersSignedZeroAndInfinities) {
+  lib::vector<double> values;
+  for (int i = 0; i < 600; ++i) {
+    double specials[] = {-1.0 / 0.0, 1.0 / 0.0, -0.0, 0.0, -2.5, 2.5};
+    values.push_back(specials[i % 6]);
+  }
+  values.sort();
+  EXPECT_TRUE(std::is_sorted(values.begin(), values.end()));
+}
+
+TEST(Vector, StableSortKeepsOrderOfSignedZeros) {
+  lib::vector<double> values;
+  std::vector<bool> zero_signs;
+  for (int i = 0; i < 600; ++i) {
+    double zero = i % 3 == 0 ? -0.0 : 0.0;
+    values.push_back(i % 2 == 0 ? zero : 0.5 - i);
+    if (i % 2 == 0) zero_signs.push_back(std::signbit(zero));
+  }
+  values.stable_sort();
+  std::vector<bool> sorted_signs;
+  for (double value : values) {
+    if (value == 0.0) sorted_signs.push_back(std::signbit(value));
+  }
+  EXPECT_TRUE(std::is_sorted(values.begin(), values.end()));
+  EXPECT_EQ(zero_signs, sorted_signs);
+}
+
+TEST(Vector, SortStrings) {
+  lib::vector<std::string> words = {"pear", "fig", "apple", "kiwi", "date"};
+  words.sort();
+  const char* expected[] = {"apple", "date", "fig", "kiwi", "pear"};
+  for (int i = 0; i < 5; ++i) EXPECT_EQ(expected[i], words[i]);
+  words.sort([](const std::string& a, const std::string& b) {
+    return a.size() < b.size();
+  });
+  EXPECT_EQ(3, words[0].size());
+  EXPECT_EQ(5, words[4].size());
+}
+
+TEST(Vector, StableSortKeepsOrderOfEqualElements) {
+  lib::vector<std::pair<int, int>> pairs;
+  for (int i = 0; i < 2000; ++i) pairs.push_back({i * 7 % 10, i});
+  pairs.stable_sort([](const std::pair<int, int>& a,
+                       const std::pair<int, int>& b) {
+    return a.first < b.first;
+  });
+  for (std::size_t i = 1; i < pairs.size(); ++i) {
+    ASSERT_LE(pairs[i - 1].first, pairs[i].first);
+    if (pairs[i - 1].first == pairs[i].first) {
+      ASSERT_LT(pairs[i - 1].second, pairs[i].second);
+    }
+  }
+}
+
+TEST(Vector, SortByKeyIsStable) {
+  struct Record {
+    double score;
+    std::string name;
+  };
+  for (int n : {50, 5000}) {
+    lib::vector<Record> records;
+    for (int i = 0; i < n; ++i) {
+      records.push_back({double(i * 37 % 11) - 5, std::to_string(i)});
+    }
+    records.sort_by_key([](const Record& r) { return r.score; });
+    for (std::size_t i = 1; i < records.size(); ++i) {
+      ASSERT_LE(records[i - 1].score, records[i].score);
+      if (records[i - 1].score == records[i].score) {
+        ASSERT_LT(std::stoi(records[i - 1].name), std::stoi(records[i].name));
+      }
+    }
+    records.sort_by_key([](const Record& r) { return r.name; });
+    EXPECT_EQ("0", records[0].name);
+    EXPECT_EQ("1", records[1].name);
+  }
+}
+
+namespace {
+bool isAligned(const void* p, std::size_t alignment) {
+  return reinterpret_cast<std::uintptr_t>(p) % alignment == 0;
+}
+
+struct alignas(32) Lane {
+  float values[8];
+};
+}  // namespace
+
+TEST(Vector, AlignedDataThroughGrowthCopyAndMove) {
+  lib::aligned_vector<float> values;
+  for (int i = 0; i < 1000; ++i) {
+    values.push_back(float(i));
+    ASSERT_TRUE(isAligned(values.data(), 64));
+  }
+  values.reserve(5000);
+  EXPECT_TRUE(isAligned(values.data(), 64));
+  values.shrink_to_fit();
+  EXPECT_TRUE(isAligned(values.data(), 64));
+
+  lib::aligned_vector<float> copy(values);
+  EXPECT_TRUE(isAligned(copy.data(), 64));
+  EXPECT_EQ(999.0f, copy[999]);
+  lib::aligned_vector<float> moved(std::move(copy));
+  EXPECT_TRUE(isAligned(moved.data(), 64));
+  EXPECT_EQ(999.0f, moved.back());
+
+  lib::vector<double, lib::doubling_growth, 4096> page(3);
+  EXPECT_TRUE(isAligned(page.data(), 4096));
+}
+
+TEST(Vector, OverAlignedElements) {
+  lib::vector<Lane> lanes;
+  for (int i = 0; i < 100; ++i) {
+    lanes.push_back(Lane{{float(i)}});
+    ASSERT_TRUE(isAligned(lanes.data(), alignof(Lane)));
+  }
+  EXPECT_EQ(99.0f, lanes[99].values[0]);
+}
+
+TEST(Vector, ResizeGrowsAndShrinks) {
+  lib::vector<std::string> words;
+  words.resize(3);
+  ASSERT_EQ(3, words.size());
+  EXPECT_EQ("", words[2]);
+  words.resize(5, "x");
+  EXPECT_EQ("x", words[4]);
+  EXPECT_EQ("", words[2]);
+  words.resize(1);
+  ASSERT_EQ(1, words.size());
+  words.resize(1);
+  EXPECT_EQ(1, words.size());
+
+  // The fill value may be one of the elements that the growth moves.
+  words[0] = "first";
+  words.shrink_to_fit();
+  words.resize(100, words[0]);
+  ASSERT_EQ(100, words.size());
+  EXPECT_EQ("first", words[99]);
+  words.resize(0);
+  EXPECT_TRUE(words.empty());
+}
+
+TEST(Vector, ResizeDefaultInitKeepsExistingElements) {
+  lib::vector<std::uint8_t> buffer;
+  buffer.resize_default_init(4096);
+  ASSERT_EQ(4096, buffer.size());
+  for (std::size_t i = 0; i < buffer.size(); ++i) buffer[i] = i % 251;
+  buffer.resize_default_init(8192);
+  ASSERT_EQ(8192, buffer.size());
+  EXPECT_GE(buffer.capacity(), 8192);
+  for (std::size_t i = 0; i < 4096; ++i) ASSERT_EQ(i % 251, buffer[i]);
+  buffer.resize_default_init(10);
+  EXPECT_EQ(10, buffer.size());
+  EXPECT_EQ(9, buffer[9]);
+
+  lib::vector<int> values{1, 2, 3};
+  values.resize(5);
+  EXPECT_EQ(0, values[4]);
+}
+
+TEST(Vector, ResizeForOverwriteAcceptsDefaultMemberInitializers) {
+  struct Sample {
+    int tag = 7;
+    float weight = 1.0f;
+  };
+  lib::vector<Sample> samples(2);
+  samples.resize_for_overwrite(1000);
+  ASSERT_EQ(1000, samples.size());
+  EXPECT_EQ(7, samples[1].tag);
+  for (std::size_t i = 2; i < samples.size(); ++i) samples[i] = {int(i), 0.f};
+  EXPECT_EQ(999, samples.back().tag);
+  samples.resize_for_overwrite(3);
+  EXPECT_EQ(3, samples.size());
+  EXPECT_EQ(2, samples[2].tag);
+}